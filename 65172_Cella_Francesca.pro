@@ -1,6 +1,9 @@
 # Debug configuration
 CONFIG(debug, debug|release){
     DEFINES += DEBUG
+
+    # Count point location steps, DAG depths, in-circle tests and flips of the triangulation algorithm
+    DEFINES += DELAUNAY_STATISTICS
 }
 
 # Release configuration
@@ -9,6 +12,9 @@ CONFIG(release, debug|release){
 
     # Uncomment next line if you want to ignore asserts and got a more optimized binary
     #CONFIG += FINAL_RELEASE
+
+    # Uncomment next line if you want the statistics of the triangulation algorithm also in release
+    #DEFINES += DELAUNAY_STATISTICS
 }
 
 # Final release optimization
@@ -36,6 +42,11 @@ CONFIG += CG3_CORE CG3_VIEWER
 include (cg3lib/cg3.pri)
 message($$MODULES)
 
+# Peak resident memory of the memory report
+win32 {
+    LIBS += -lpsapi
+}
+
 
 DISTFILES += \
     LICENSE
@@ -44,12 +55,29 @@ SOURCES += \
     main.cpp \
     managers/delaunaymanager.cpp \
     utils/delaunay_checker.cpp \
+    utils/topology_checker.cpp \
     utils/fileutils.cpp \
+    utils/binarypointfile.cpp \
+    utils/pointstreamreader.cpp \
+    utils/pointgenerator.cpp \
+    utils/triangulationsnapshot.cpp \
+    utils/meshexporter.cpp \
+    utils/insertionjournal.cpp \
+    utils/backgroundjob.cpp \
+    utils/softwarerenderer.cpp \
+    utils/tracing.cpp \
+    utils/memoryreport.cpp \
     algorithms/delaunay.cpp \
+    algorithms/spatialsort.cpp \
+    algorithms/indexedmesh.cpp \
+    algorithms/picking.cpp \
+    algorithms/insertionstatistics.cpp \
     data_structures/dag.cpp \
     data_structures/triangulation.cpp \
     data_structures/triangle.cpp \
     data_structures/node.cpp \
+    data_structures/voronoicells.cpp \
+    data_structures/voronoidiagram.cpp \
     drawables/drawabletriangle.cpp \
     drawables/drawabletriangulation.cpp \
     drawables/drawablevoronoi.cpp
@@ -60,12 +88,30 @@ FORMS += \
 HEADERS += \
     managers/delaunaymanager.h \
     utils/delaunay_checker.h \
+    utils/topology_checker.h \
     utils/fileutils.h \
+    utils/binarypointfile.h \
+    utils/pointstreamreader.h \
+    utils/pointgenerator.h \
+    utils/triangulationsnapshot.h \
+    utils/meshexporter.h \
+    utils/insertionjournal.h \
+    utils/backgroundjob.h \
+    utils/softwarerenderer.h \
+    utils/tracing.h \
+    utils/memoryreport.h \
+    utils/memoryusage.h \
     algorithms/delaunay.h \
+    algorithms/spatialsort.h \
+    algorithms/indexedmesh.h \
+    algorithms/picking.h \
+    algorithms/insertionstatistics.h \
     data_structures/dag.h \
     data_structures/triangulation.h \
     data_structures/triangle.h \
     data_structures/node.h \
+    data_structures/voronoicells.h \
+    data_structures/voronoidiagram.h \
     drawables/drawabletriangle.h \
     drawables/drawabletriangulation.h \
     drawables/drawablevoronoi.h
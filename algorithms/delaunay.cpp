@@ -1,6 +1,8 @@
 #include "delaunay.h"
+#include "insertionstatistics.h"
 
 #include <utils/delaunay_checker.h>
+#include <utils/tracing.h>
 #include <cg3lib/cg3/core/cg3/geometry/2d/utils2d.h>
 
 namespace DelaunayTriangulation {
@@ -66,21 +68,43 @@ void fillDataStructures(Triangulation& triangulation, DAG& dag, std::vector<cg3:
  * @param[in] pk: triangle opposite vertex
  * @param[in] triangle adjacencies: adjacencies for the new triangle
  * @param[in] adjacent triangle adjacencies: adjacencies for the adjacent triangle
+ * @param[out] changes: if not null, the destroyed triangles and the flips are appended to it
 */
 void legalizeEdge(Triangulation& triangulation, DAG& dag,
                   const unsigned int triangleIndex, const unsigned int adjacentIndex,
                   const cg3::Point2Dd& p1, const cg3::Point2Dd& p2, const cg3::Point2Dd& p3, const cg3::Point2Dd& pk,
                   const unsigned int edge, const unsigned int adjEdge,
-                  std::array<int, dimension>& triangleAdj, std::array<int, dimension>& adjTriangleAdj)
+                  std::array<int, dimension>& triangleAdjacencies, std::array<int, dimension>& adjTriangleAdjacencies,
+                  TriangulationChanges* changes)
 {
+    countInCircleTest();
+
     //if the edge is illegal
     if(DelaunayTriangulation::Checker::
             isPointLyingInCircle(p1, p2, p3, pk, false))
     {
+        //the adjacencies are copied because adding triangles can move the arrays they belong to
+        const std::array<int, dimension> triangleAdj = triangleAdjacencies;
+        const std::array<int, dimension> adjTriangleAdj = adjTriangleAdjacencies;
+
+        countFlip();
+
+        //both triangles are replaced by the flip
+        if(changes != nullptr)
+        {
+            changes->destroyed.push_back(triangleIndex);
+            changes->destroyed.push_back(adjacentIndex);
+        }
+
         const std::vector<Triangle>& triangles = triangulation.getTriangles();
 
         unsigned int totalTrianglesNumber = unsigned(triangles.size());
 
+        if(changes != nullptr)
+        {
+            changes->flips.push_back(totalTrianglesNumber);
+        }
+
         //replace pi pj with pr pk
 
         //the legalization manages 9 case: for each adjacency for the considered (new) triangle, other 3 cases are managed
@@ -112,13 +136,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                     //first triangle, pk pj is 2
                     if(adjTriangleAdj[v3v1Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, p2, p3, pk);
+                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, p2, p3, pk, changes);
                     }
 
                     //second triangle, pi pk is 1
                     if(adjTriangleAdj[v2v3Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p3, p1, pk);
+                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p3, p1, pk, changes);
                     }
                     break;
 
@@ -137,13 +161,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                     //first triangle, pk pj is 0
                     if(adjTriangleAdj[v1v2Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, pk, p2, p3);
+                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, pk, p2, p3, changes);
                     }
 
                     //second triangle, pi pk is 2
                     if(adjTriangleAdj[v3v1Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, pk, p3, p1);
+                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, pk, p3, p1, changes);
                     }
 
                     break;
@@ -162,13 +186,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                     //first triangle, pi pk is 0
                     if(adjTriangleAdj[v1v2Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, p1, pk, p3);
+                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, p1, pk, p3, changes);
                     }
 
                     //second triangle, pk pj is 1
                     if(adjTriangleAdj[v2v3Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p3, pk, p2);
+                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p3, pk, p2, changes);
                     }
                     break;
             }
@@ -191,13 +215,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                         //first triangle, pi pk is 1
                         if(adjTriangleAdj[v2v3Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p1, p2, pk);
+                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p1, p2, pk, changes);
                         }
 
                         //second triangle, pk pj is 2
                         if(adjTriangleAdj[v3v1Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, p3, p1, pk);
+                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, p3, p1, pk, changes);
                         }
 
                         break;
@@ -217,13 +241,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                     //first triangle, pi pk is 2
                     if(adjTriangleAdj[v3v1Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, pk, p1, p2);
+                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, pk, p1, p2, changes);
                     }
 
                     //second triangle, pk pj is 0
                     if(adjTriangleAdj[v1v2Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, pk, p3, p1);
+                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, pk, p3, p1, changes);
                     }
 
                     break;
@@ -243,13 +267,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                         //first triangle, pi pk is 0
                         if(adjTriangleAdj[v1v2Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, p2, pk, p1);
+                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, p2, pk, p1, changes);
                         }
 
                         //second triangle, pk pj is 1
                         if(adjTriangleAdj[v2v3Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p1, pk, p3);
+                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p1, pk, p3, changes);
                         }
 
                         break;
@@ -273,13 +297,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                         //first triangle, pi pk is 1
                         if(adjTriangleAdj[v2v3Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p2, p3, pk);
+                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p2, p3, pk, changes);
                         }
 
                         //second triangle, pk pj is 2
                         if(adjTriangleAdj[v3v1Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, p1, p2, pk);
+                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, p1, p2, pk, changes);
                         }
 
                         break;
@@ -298,13 +322,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                         //first triangle, pi pk is 2
                         if(adjTriangleAdj[v3v1Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, pk, p2, p3);
+                            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v3v1Edge]), v3v1Edge, pk, p2, p3, changes);
                         }
 
                         //second triangle, pk pj is 0
                         if(adjTriangleAdj[v1v2Edge] != noAdjacentTriangle)
                         {
-                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, pk, p1, p2);
+                            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, pk, p1, p2, changes);
                         }
 
                         break;
@@ -324,13 +348,13 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                     //first triangle, pi pk is 0
                     if(adjTriangleAdj[v1v2Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, p3, pk, p2);
+                        testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjTriangleAdj[v1v2Edge]), v1v2Edge, p3, pk, p2, changes);
                     }
 
                     //second triangle, pk pj is 1
                     if(adjTriangleAdj[v2v3Edge] != noAdjacentTriangle)
                     {
-                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p2, pk, p1);
+                        testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjTriangleAdj[v2v3Edge]), v2v3Edge, p2, pk, p1, changes);
                     }
 
                     break;
@@ -347,15 +371,28 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
  * @param[in] triangulation: triangulation data structure
  * @param[in] dag: search data structure
  * @param[in] point: the point to be added to the triangulation
+ * @param[out] changes: if not null, it receives the triangles created and destroyed by the insertion
 */
-void incrementalTriangulation(Triangulation& triangulation, DAG& dag, const cg3::Point2Dd& point)
+void incrementalTriangulation(Triangulation& triangulation, DAG& dag, const cg3::Point2Dd& point, TriangulationChanges* changes)
 {
     const std::vector<Triangle>& triangles = triangulation.getTriangles();
 
+    if(changes != nullptr)
+    {
+        changes->previousVersion = triangulation.getVersion();
+        changes->firstCreated = unsigned(triangles.size());
+        changes->destroyed.clear();
+        changes->flips.clear();
+    }
+
     const std::vector<Node>& nodes = dag.getNodeList();
 
     //find the triangle that contains this point using the DAG
-    unsigned int parentNodeIndex = unsigned(dag.searchInNodes(0, unsigned(nodes.size()), point, triangles));
+    unsigned int parentNodeIndex;
+    {
+        Tracing::Scope location("location", Tracing::AGGREGATE_ONLY);
+        parentNodeIndex = unsigned(dag.searchInNodes(0, unsigned(nodes.size()), point, triangles));
+    }
     unsigned int triangleIndex = unsigned(nodes[parentNodeIndex].getData());
     //these numbers must be not equal to -1
 
@@ -367,6 +404,8 @@ void incrementalTriangulation(Triangulation& triangulation, DAG& dag, const cg3:
     //cases where two points coincide are not managed
     if(point != v1 && point != v2 && point != v3)
     {
+        unsigned long long previousFlips = countInsertion();
+
         unsigned int totalTrianglesNumber = unsigned(triangles.size());
 
         const std::array<int, maxAdjacentTriangles>& oldTriangleAdjacencies = triangulation.getAdjacenciesFromTriangle(triangleIndex);
@@ -377,6 +416,11 @@ void incrementalTriangulation(Triangulation& triangulation, DAG& dag, const cg3:
         int adjacency1 = oldTriangleAdjacencies[v2v3Edge];
         int adjacency2 = oldTriangleAdjacencies[v3v1Edge];
 
+        if(changes != nullptr)
+        {
+            changes->destroyed.push_back(triangleIndex);
+        }
+
         //create 3 new triangles and 3 new nodes
 
         addElementToTriangulation(triangulation, dag,
@@ -401,21 +445,28 @@ void incrementalTriangulation(Triangulation& triangulation, DAG& dag, const cg3:
         //in legalize edge I need also the triangulation to call the function recursively and I need to insert triangles
         //I need the dag to insert new nodes
 
+        Tracing::Scope legalization("legalization", Tracing::AGGREGATE_ONLY);
+
         if(adjacency0 != noAdjacentTriangle)
         {
-            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjacency0), v1v2Edge, v1, v2, point);
+            testEdge(triangulation, dag, totalTrianglesNumber, unsigned(adjacency0), v1v2Edge, v1, v2, point, changes);
         }
 
         if(adjacency1 != noAdjacentTriangle)
         {
-            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjacency1), v2v3Edge, point, v2, v3);
+            testEdge(triangulation, dag, totalTrianglesNumber + 1, unsigned(adjacency1), v2v3Edge, point, v2, v3, changes);
         }
 
         if(adjacency2 != noAdjacentTriangle)
         {
-            testEdge(triangulation, dag, totalTrianglesNumber + 2, unsigned(adjacency2), v3v1Edge, v1, point, v3);
+            testEdge(triangulation, dag, totalTrianglesNumber + 2, unsigned(adjacency2), v3v1Edge, v1, point, v3, changes);
         }
 
+        countInsertionFlips(previousFlips);
+    }
+    else
+    {
+        countDuplicatePoint();
     }
 
 }
@@ -440,6 +491,7 @@ void addElementToTriangulation(Triangulation& triangulation, DAG& dag,
 {
     //add triangle to the triangulation
     triangulation.addTriangle(Triangle(v1, v2, v3));
+    countCreatedTriangle();
     //add node to the dag
     dag.addNode(Node(index), parentIndex);
     //update adjacencies
@@ -457,10 +509,12 @@ void addElementToTriangulation(Triangulation& triangulation, DAG& dag,
  * @param[in] p1: new triangle vertex 1
  * @param[in] p2: new triangle vertex 2
  * @param[in] p3: new triangle vertex 3
+ * @param[out] changes: if not null, the destroyed triangles and the flips are appended to it
 */
 void testEdge(Triangulation& triangulation, DAG& dag,
               unsigned int triangle, unsigned int adjacent, unsigned int edge,
-              const cg3::Point2Dd& v1, const cg3::Point2Dd& v2, const cg3::Point2Dd& v3)
+              const cg3::Point2Dd& v1, const cg3::Point2Dd& v2, const cg3::Point2Dd& v3,
+              TriangulationChanges* changes)
 {
     std::vector<Triangle>& triangles = triangulation.getTriangles();
 
@@ -477,7 +531,7 @@ void testEdge(Triangulation& triangulation, DAG& dag,
             (pkIndex == 1? triangles[adjacent].getV2() : triangles[adjacent].getV3());
 
     legalizeEdge(triangulation, dag, triangle, adjacent, v1, v2, v3, pk, edge, unsigned(oppositePk),
-                 triangulation.getAdjacenciesFromTriangle(triangle), triangulation.getAdjacenciesFromTriangle(adjacent));
+                 triangulation.getAdjacenciesFromTriangle(triangle), triangulation.getAdjacenciesFromTriangle(adjacent), changes);
 }
 
 /**
@@ -501,6 +555,7 @@ void addElementAfterFlip(Triangulation& triangulation, DAG& dag,
 {
     //add triangle to the triangulation
     triangulation.addTriangle(Triangle(v1, v2, v3));
+    countCreatedTriangle();
     //add node to the dag
     dag.addNode(Node(index), firstParentIndex, secondParentIndex);
     //update adjacencies
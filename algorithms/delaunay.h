@@ -13,6 +13,23 @@ namespace DelaunayTriangulation {
 
 const unsigned int dimension = 3;
 
+/**
+ * @brief TriangulationChanges: triangles created and destroyed by the insertion of a point
+ *
+ * The created triangles are the ones from firstCreated to the end of the triangulation, some of them may be destroyed again
+ * by the following flips: destroyed lists both these and the triangles which were live before the insertion.
+ * Each flip creates two adjacent triangles, one after the other: flips lists the first of them, their common edge is the flipped edge.
+ * The previous version is the version of the triangulation before the insertion, so a structure built from it
+ * knows if it can apply the changes.
+ */
+struct TriangulationChanges
+{
+    unsigned long long previousVersion;
+    unsigned int firstCreated;
+    std::vector<unsigned int> destroyed;
+    std::vector<unsigned int> flips;
+};
+
 namespace Checker {
 
 void fillDataStructures(Triangulation& triangulation, DAG& dag, std::vector<cg3::Point2Dd>& points, cg3::Array2D<unsigned int>& triangles);
@@ -23,9 +40,10 @@ void legalizeEdge(Triangulation& triangulation, DAG& dag,
                   const unsigned int triangleIndex, const unsigned int adjacentIndex,
                   const cg3::Point2Dd& p1, const cg3::Point2Dd& p2, const cg3::Point2Dd& p3, const cg3::Point2Dd& pk,
                   const unsigned int edge, const unsigned int adjEdge,
-                  std::array<int, dimension>& triangleAdj, std::array<int, dimension>& adjTriangleAdj);
+                  std::array<int, dimension>& triangleAdj, std::array<int, dimension>& adjTriangleAdj,
+                  TriangulationChanges* changes = nullptr);
 
-void incrementalTriangulation(Triangulation& triangulation, DAG &dag, const cg3::Point2Dd& point);
+void incrementalTriangulation(Triangulation& triangulation, DAG &dag, const cg3::Point2Dd& point, TriangulationChanges* changes = nullptr);
 
 void addElementToTriangulation(Triangulation& triangulation, DAG& dag,
                 unsigned int index, unsigned int parentIndex,
@@ -34,7 +52,8 @@ void addElementToTriangulation(Triangulation& triangulation, DAG& dag,
 
 void testEdge(Triangulation& triangulation, DAG& dag,
               unsigned int triangle, unsigned int adjacent, unsigned int edge,
-              const cg3::Point2Dd& v1, const cg3::Point2Dd& v2, const cg3::Point2Dd& v3);
+              const cg3::Point2Dd& v1, const cg3::Point2Dd& v2, const cg3::Point2Dd& v3,
+              TriangulationChanges* changes = nullptr);
 
 void addElementAfterFlip(Triangulation& triangulation, DAG& dag,
                          unsigned int index, unsigned int firstParentIndex, unsigned int secondParentIndex,
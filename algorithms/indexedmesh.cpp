@@ -0,0 +1,69 @@
+#include "indexedmesh.h"
+
+#include <unordered_map>
+
+#include <utils/tracing.h>
+
+namespace DelaunayTriangulation {
+
+/**
+ * @brief Builds the indexed representation of the triangulation
+ *
+ * Triangles store the coordinates of their vertices, here each distinct vertex gets an index (in order of first appearance)
+ * and each triangle is described by the indices of its 3 vertices, so vertices shared by many triangles are stored once.
+ *
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure, used to know which triangles are live (leaves)
+ * @param[in] liveOnly: true to ignore deleted triangles
+ * @param[out] vertices: the distinct vertices
+ * @param[out] triangleVertices: 3 vertex indices for each triangle, in counter-clockwise order
+ * @param[out] triangleIndices: index in the triangulation of each triangle
+*/
+void indexTriangulationVertices(const Triangulation& triangulation, const DAG& dag, bool liveOnly,
+                                std::vector<cg3::Point2Dd>& vertices,
+                                std::vector<unsigned int>& triangleVertices,
+                                std::vector<unsigned int>& triangleIndices)
+{
+    Tracing::Scope compaction("compaction");
+
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    unsigned int length = unsigned(triangles.size());
+
+    vertices.clear();
+    triangleVertices.clear();
+    triangleIndices.clear();
+
+    //a triangulation of n points has about 2n triangles
+    std::unordered_map<cg3::Point2Dd, unsigned int> vertexIndices;
+    vertexIndices.reserve(length / 2 + 3);
+
+    for(unsigned int i = 0; i < length; i++)
+    {
+        //ignore deleted triangles
+        if(liveOnly && !nodes[i].isLeaf())
+        {
+            continue;
+        }
+
+        const cg3::Point2Dd triangleVertex[] = {triangles[i].getV1(), triangles[i].getV2(), triangles[i].getV3()};
+
+        for(const cg3::Point2Dd& vertex : triangleVertex)
+        {
+            std::pair<std::unordered_map<cg3::Point2Dd, unsigned int>::iterator, bool> inserted =
+                    vertexIndices.insert(std::make_pair(vertex, unsigned(vertices.size())));
+
+            if(inserted.second)
+            {
+                vertices.push_back(vertex);
+            }
+
+            triangleVertices.push_back(inserted.first->second);
+        }
+
+        triangleIndices.push_back(i);
+    }
+}
+
+}
@@ -0,0 +1,20 @@
+#ifndef INDEXEDMESH_H
+#define INDEXEDMESH_H
+
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include "data_structures/dag.h"
+#include "data_structures/triangulation.h"
+
+namespace DelaunayTriangulation {
+
+void indexTriangulationVertices(const Triangulation& triangulation, const DAG& dag, bool liveOnly,
+                                std::vector<cg3::Point2Dd>& vertices,
+                                std::vector<unsigned int>& triangleVertices,
+                                std::vector<unsigned int>& triangleIndices);
+
+}
+
+#endif // INDEXEDMESH_H
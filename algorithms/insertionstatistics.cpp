@@ -0,0 +1,77 @@
+#include "insertionstatistics.h"
+
+namespace DelaunayTriangulation {
+
+thread_local InsertionStatistics threadStatistics;
+
+/**
+ * @brief Returns the counters of the calling thread
+ * @return statistics: the counters since the last reset, all 0 if DELAUNAY_STATISTICS is not defined
+*/
+const InsertionStatistics& getStatistics()
+{
+    return threadStatistics;
+}
+
+/**
+ * @brief Sets the counters of the calling thread to 0
+*/
+void resetStatistics()
+{
+    threadStatistics = InsertionStatistics();
+}
+
+/**
+ * @brief Returns the mean number of DAG nodes visited to locate a point
+ * @return steps: the mean over the insertions and the duplicate points, 0 if there are none
+*/
+double InsertionStatistics::getMeanLocationSteps() const
+{
+    unsigned long long locations = insertions + duplicatePoints;
+    return locations == 0 ? 0 : double(locationSteps) / double(locations);
+}
+
+/**
+ * @brief Returns the mean depth of the leaves where the points are located
+ * @return depth: the mean of the depth histogram, 0 if it is empty
+*/
+double InsertionStatistics::getMeanDepth() const
+{
+    unsigned long long count = 0;
+    double sum = 0;
+    for(size_t depth = 0; depth < depthHistogram.size(); depth++)
+    {
+        count += depthHistogram[depth];
+        sum += double(depth) * double(depthHistogram[depth]);
+    }
+    return count == 0 ? 0 : sum / double(count);
+}
+
+/**
+ * @brief Returns the mean number of flips for each insertion
+ * @return flips: the mean, 0 if there are no insertions
+*/
+double InsertionStatistics::getMeanFlips() const
+{
+    return insertions == 0 ? 0 : double(flips) / double(insertions);
+}
+
+std::ostream& operator<<(std::ostream& stream, const InsertionStatistics& statistics)
+{
+    if(!statisticsEnabled)
+    {
+        return stream << "statistics disabled (define DELAUNAY_STATISTICS)";
+    }
+
+    return stream << "insertions " << statistics.insertions
+                  << ", duplicates skipped " << statistics.duplicatePoints
+                  << "; location steps " << statistics.locationSteps << " (mean " << statistics.getMeanLocationSteps() << ")"
+                  << ", DAG depth mean " << statistics.getMeanDepth()
+                  << " max " << (statistics.depthHistogram.empty() ? 0 : statistics.depthHistogram.size() - 1)
+                  << "; in-circle tests " << statistics.inCircleTests
+                  << ", flips " << statistics.flips << " (mean " << statistics.getMeanFlips()
+                  << " max " << (statistics.flipHistogram.empty() ? 0 : statistics.flipHistogram.size() - 1) << " per insertion)"
+                  << ", triangles created " << statistics.createdTriangles;
+}
+
+}
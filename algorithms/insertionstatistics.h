@@ -0,0 +1,130 @@
+#ifndef INSERTIONSTATISTICS_H
+#define INSERTIONSTATISTICS_H
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace DelaunayTriangulation {
+
+/**
+ * @brief InsertionStatistics: counters of the work done by the incremental algorithm
+ *
+ * The counters are updated only if DELAUNAY_STATISTICS is defined, otherwise the counting functions are empty
+ * and the compiler removes them. Each thread has its own counters, so the thread that inserts the points
+ * counts without synchronization and it must copy them to make them visible to other threads.
+ */
+struct InsertionStatistics
+{
+    unsigned long long insertions = 0;
+    //points equal to a vertex of the triangle containing them, they are not inserted
+    unsigned long long duplicatePoints = 0;
+    //DAG nodes visited by the point location
+    unsigned long long locationSteps = 0;
+    unsigned long long inCircleTests = 0;
+    unsigned long long flips = 0;
+    unsigned long long createdTriangles = 0;
+
+    //depthHistogram[d]: insertions located in a leaf at depth d of the DAG
+    std::vector<unsigned long long> depthHistogram;
+    //flipHistogram[f]: insertions that needed f flips
+    std::vector<unsigned long long> flipHistogram;
+
+    double getMeanLocationSteps() const;
+    double getMeanDepth() const;
+    double getMeanFlips() const;
+};
+
+#ifdef DELAUNAY_STATISTICS
+const bool statisticsEnabled = true;
+#else
+const bool statisticsEnabled = false;
+#endif
+
+//counters of the calling thread, updated by the functions below
+extern thread_local InsertionStatistics threadStatistics;
+
+const InsertionStatistics& getStatistics();
+void resetStatistics();
+
+std::ostream& operator<<(std::ostream& stream, const InsertionStatistics& statistics);
+
+inline void addToHistogram(std::vector<unsigned long long>& histogram, size_t value)
+{
+    if(value >= histogram.size())
+    {
+        histogram.resize(value + 1, 0);
+    }
+    histogram[value]++;
+}
+
+inline void countLocationStep()
+{
+#ifdef DELAUNAY_STATISTICS
+    threadStatistics.locationSteps++;
+#endif
+}
+
+inline void countLocationDepth(unsigned int depth)
+{
+#ifdef DELAUNAY_STATISTICS
+    addToHistogram(threadStatistics.depthHistogram, depth);
+#else
+    (void)depth;
+#endif
+}
+
+inline void countInCircleTest()
+{
+#ifdef DELAUNAY_STATISTICS
+    threadStatistics.inCircleTests++;
+#endif
+}
+
+inline void countFlip()
+{
+#ifdef DELAUNAY_STATISTICS
+    threadStatistics.flips++;
+#endif
+}
+
+inline void countCreatedTriangle()
+{
+#ifdef DELAUNAY_STATISTICS
+    threadStatistics.createdTriangles++;
+#endif
+}
+
+inline void countDuplicatePoint()
+{
+#ifdef DELAUNAY_STATISTICS
+    threadStatistics.duplicatePoints++;
+#endif
+}
+
+/**
+ * @brief Counts an insertion, to be called before its flips
+ * @return flips: the flips counted so far, passed to countInsertionFlips at the end of the insertion
+*/
+inline unsigned long long countInsertion()
+{
+#ifdef DELAUNAY_STATISTICS
+    threadStatistics.insertions++;
+    return threadStatistics.flips;
+#else
+    return 0;
+#endif
+}
+
+inline void countInsertionFlips(unsigned long long previousFlips)
+{
+#ifdef DELAUNAY_STATISTICS
+    addToHistogram(threadStatistics.flipHistogram, size_t(threadStatistics.flips - previousFlips));
+#else
+    (void)previousFlips;
+#endif
+}
+
+}
+
+#endif // INSERTIONSTATISTICS_H
@@ -0,0 +1,124 @@
+#include "picking.h"
+
+#include <cmath>
+
+namespace DelaunayTriangulation {
+
+/**
+ * @brief Finds the live triangle containing a point and its closest vertex
+ * @param[in] triangulation: triangulation data structure
+ * @param[in] dag: search data structure
+ * @param[in] point: the picked point
+ * @return element: the triangle and the corner of the vertex, the triangle is noAdjacentTriangle if the point is outside the bounding triangle
+*/
+PickedElement pickElement(const Triangulation& triangulation, const DAG& dag, const cg3::Point2Dd& point)
+{
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    PickedElement element;
+    element.triangle = noAdjacentTriangle;
+    element.corner = 0;
+
+    int node = dag.searchInNodes(0, unsigned(nodes.size()), point, triangles);
+    if(node != -1)
+    {
+        element.triangle = int(nodes[unsigned(node)].getData());
+        element.corner = findClosestCorner(triangles[unsigned(element.triangle)], point);
+    }
+
+    return element;
+}
+
+/**
+ * @brief Finds the vertex of a triangle closest to a point
+ * @param[in] triangle: the triangle
+ * @param[in] point: the point
+ * @return corner: 0, 1 or 2 for V1, V2 or V3
+*/
+unsigned int findClosestCorner(const Triangle& triangle, const cg3::Point2Dd& point)
+{
+    unsigned int closest = 0;
+    for(unsigned int corner = 1; corner < 3; corner++)
+    {
+        if(getCorner(triangle, corner).dist(point) < getCorner(triangle, closest).dist(point))
+        {
+            closest = corner;
+        }
+    }
+
+    return closest;
+}
+
+/**
+ * @brief Counts the live triangles incident to a vertex, walking around it through the adjacencies
+ *
+ * Edge k of a triangle goes from corner k to corner k + 1, so the next triangle around the vertex at a corner is the one
+ * adjacent to the edge starting at that corner; the walk goes back the other way when it reaches the bounding triangle.
+ * @param[in] triangulation: triangulation data structure
+ * @param[in] triangle: a live triangle incident to the vertex
+ * @param[in] corner: the corner of the vertex in the triangle
+ * @return number: the number of triangles, that is the degree of an inner vertex
+*/
+unsigned int countIncidentTriangles(const Triangulation& triangulation, unsigned int triangle, unsigned int corner)
+{
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const cg3::Point2Dd vertex = getCorner(triangles[triangle], corner);
+
+    unsigned int number = 1;
+
+    //first counter-clockwise, then clockwise if the walk doesn't close
+    for(unsigned int direction = 0; direction < 2; direction++)
+    {
+        unsigned int current = triangle;
+        unsigned int currentCorner = corner;
+
+        while(true)
+        {
+            unsigned int edge = direction == 0 ? currentCorner : (currentCorner + 2) % 3;
+            int next = triangulation.getAdjacenciesFromTriangle(current)[edge];
+
+            if(next == noAdjacentTriangle)
+            {
+                break;
+            }
+            if(unsigned(next) == triangle)
+            {
+                return number;
+            }
+
+            current = unsigned(next);
+            currentCorner = findClosestCorner(triangles[current], vertex);
+            number++;
+        }
+    }
+
+    return number;
+}
+
+/**
+ * @brief Returns a vertex of a triangle
+ * @param[in] triangle: the triangle
+ * @param[in] corner: 0, 1 or 2 for V1, V2 or V3
+ * @return point: the vertex
+*/
+cg3::Point2Dd getCorner(const Triangle& triangle, unsigned int corner)
+{
+    return corner == 0 ? triangle.getV1() : (corner == 1 ? triangle.getV2() : triangle.getV3());
+}
+
+/**
+ * @brief Computes the area of a triangle
+ * @param[in] triangle: the triangle
+ * @return area: the area, positive for counter-clockwise triangles
+*/
+double getArea(const Triangle& triangle)
+{
+    const cg3::Point2Dd v1 = triangle.getV1();
+    const cg3::Point2Dd v2 = triangle.getV2();
+    const cg3::Point2Dd v3 = triangle.getV3();
+
+    return ((v2.x() - v1.x()) * (v3.y() - v1.y()) - (v3.x() - v1.x()) * (v2.y() - v1.y())) / 2;
+}
+
+}
@@ -0,0 +1,33 @@
+#ifndef PICKING_H
+#define PICKING_H
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include "data_structures/dag.h"
+#include "data_structures/triangulation.h"
+
+namespace DelaunayTriangulation {
+
+/**
+ * @brief PickedElement: the live triangle containing a point and its vertex closest to the point
+ *
+ * The triangle is found with the DAG, like the triangle split by an insertion, so picking takes the same expected O(log n) time;
+ * the vertex is one of the corners of the triangle, the one closest to the point.
+ */
+struct PickedElement
+{
+    int triangle;
+    unsigned int corner;
+};
+
+PickedElement pickElement(const Triangulation& triangulation, const DAG& dag, const cg3::Point2Dd& point);
+
+unsigned int findClosestCorner(const Triangle& triangle, const cg3::Point2Dd& point);
+unsigned int countIncidentTriangles(const Triangulation& triangulation, unsigned int triangle, unsigned int corner);
+
+cg3::Point2Dd getCorner(const Triangle& triangle, unsigned int corner);
+double getArea(const Triangle& triangle);
+
+}
+
+#endif // PICKING_H
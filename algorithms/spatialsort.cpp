@@ -0,0 +1,122 @@
+#include "spatialsort.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace DelaunayTriangulation {
+
+namespace {
+
+//each coordinate is quantized on 16 bits
+const double mortonCells = 65535.0;
+
+//smaller rounds are not halved
+const size_t minimumRoundPoints = 64;
+
+/**
+ * @brief Spreads the 16 bits of the value on the even bits of the result
+ * @param[in] value: the quantized coordinate
+ * @return bits: the value with a zero between each bit
+*/
+uint32_t spreadBits(uint32_t value)
+{
+    value = (value | (value << 8)) & 0x00FF00FF;
+    value = (value | (value << 4)) & 0x0F0F0F0F;
+    value = (value | (value << 2)) & 0x33333333;
+    value = (value | (value << 1)) & 0x55555555;
+    return value;
+}
+
+/**
+ * @brief Sorts the points in [first, last) along the Morton (Z-order) curve of their bounding box
+ * @param[in/out] points: the vector of the points
+ * @param[in] first: the first point to sort
+ * @param[in] last: the point after the last one to sort
+*/
+void sortRangeByMortonOrder(std::vector<cg3::Point2Dd>& points, size_t first, size_t last)
+{
+    if(last - first < 2)
+    {
+        return;
+    }
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    for(size_t i = first; i < last; i++)
+    {
+        minX = std::min(minX, points[i].x());
+        minY = std::min(minY, points[i].y());
+        maxX = std::max(maxX, points[i].x());
+        maxY = std::max(maxY, points[i].y());
+    }
+
+    double scaleX = maxX > minX ? mortonCells / (maxX - minX) : 0.0;
+    double scaleY = maxY > minY ? mortonCells / (maxY - minY) : 0.0;
+
+    //sort pairs of key and index, points are moved only once
+    std::vector<std::pair<uint32_t, size_t>> keys(last - first);
+
+    for(size_t i = first; i < last; i++)
+    {
+        uint32_t x = uint32_t((points[i].x() - minX) * scaleX);
+        uint32_t y = uint32_t((points[i].y() - minY) * scaleY);
+        keys[i - first] = std::make_pair(spreadBits(x) | (spreadBits(y) << 1), i);
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<cg3::Point2Dd> sortedPoints;
+    sortedPoints.reserve(last - first);
+
+    for(const std::pair<uint32_t, size_t>& key : keys)
+    {
+        sortedPoints.push_back(points[key.second]);
+    }
+
+    std::copy(sortedPoints.begin(), sortedPoints.end(), points.begin() + std::ptrdiff_t(first));
+}
+
+}
+
+/**
+ * @brief Sorts the points along the Morton (Z-order) curve of their bounding box
+ *
+ * Points that are close in the vector are close in the plane, so consecutive insertions touch the same part of the triangulation.
+ *
+ * @param[in/out] points: the points to sort
+*/
+void sortPointsByMortonOrder(std::vector<cg3::Point2Dd>& points)
+{
+    sortRangeByMortonOrder(points, 0, points.size());
+}
+
+/**
+ * @brief Orders the points in rounds of growing size, each one a random sample sorted along the Morton curve
+ *
+ * It is the biased randomized insertion order (BRIO): the points are shuffled, the last round contains half of them,
+ * the one before it a quarter and so on. The random rounds keep the expected depth of the DAG logarithmic
+ * like a shuffle does, while the sorting inside a round keeps consecutive insertions close.
+ *
+ * @param[in/out] points: the points to order
+ * @param[in/out] generator: the random generator of the shuffle
+*/
+void sortPointsByRandomizedRounds(std::vector<cg3::Point2Dd>& points, std::mt19937& generator)
+{
+    std::shuffle(points.begin(), points.end(), generator);
+
+    //the first round contains the points left by the halvings
+    size_t last = points.size();
+    while(last > minimumRoundPoints)
+    {
+        size_t first = last - last / 2;
+        sortRangeByMortonOrder(points, first, last);
+        last = first;
+    }
+    sortRangeByMortonOrder(points, 0, last);
+}
+
+}
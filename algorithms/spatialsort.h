@@ -0,0 +1,16 @@
+#ifndef SPATIALSORT_H
+#define SPATIALSORT_H
+
+#include <random>
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+namespace DelaunayTriangulation {
+
+void sortPointsByMortonOrder(std::vector<cg3::Point2Dd>& points);
+void sortPointsByRandomizedRounds(std::vector<cg3::Point2Dd>& points, std::mt19937& generator);
+
+}
+
+#endif // SPATIALSORT_H
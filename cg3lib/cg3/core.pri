@@ -65,6 +65,7 @@ SOURCES += \
 #io
 HEADERS += \
     $$PWD/core/cg3/io/load_save_file.h \
+    $$PWD/core/cg3/io/memory_mapped_file.h \
     $$PWD/core/cg3/io/serializable_object.h \
     $$PWD/core/cg3/io/serialize.h \
     $$PWD/core/cg3/io/serialize_eigen.h \
@@ -72,6 +73,7 @@ HEADERS += \
 
 SOURCES += \
     $$PWD/core/cg3/io/load_save_file.tpp \
+    $$PWD/core/cg3/io/memory_mapped_file.tpp \
     $$PWD/core/cg3/io/serialize.tpp \
     $$PWD/core/cg3/io/serialize_eigen.tpp \
     $$PWD/core/cg3/io/serialize_qt.tpp
@@ -72,6 +72,52 @@ bool loadMtlFile(const std::string &mtuFile, std::map<std::string, Color> &mapCo
 template <typename T>
 Color getColor(size_t baseIndex, const T arrayColors[], ColorMode colorMod);
 
+/**
+ * Fast parsing of memory-mapped files
+ */
+namespace internal {
+
+typedef enum {
+    PLY_ASCII,
+    PLY_BINARY_LITTLE_ENDIAN,
+    PLY_BINARY_BIG_ENDIAN
+} PlyFormat;
+
+typedef enum {
+    PLY_CHAR, PLY_UCHAR, PLY_SHORT, PLY_USHORT, PLY_INT, PLY_UINT, PLY_FLOAT, PLY_DOUBLE
+} PlyType;
+
+typedef struct {
+    int name;
+    PlyType type;
+    bool isList;
+    PlyType countType;
+} PlyProperty;
+
+typedef struct {
+    std::string name;
+    unsigned long long int count;
+    std::vector<PlyProperty> properties;
+} PlyElement;
+
+bool isBlank(char c);
+const char* skipBlanks(const char* it, const char* end);
+const char* skipSpaces(const char* it, const char* end);
+const char* findLineEnd(const char* it, const char* end);
+const char* findNextLine(const char* it, const char* end);
+const char* findTokenEnd(const char* it, const char* end);
+bool isToken(const char* it, const char* end, const char* token);
+std::string readToken(const char*& it, const char* end);
+double parseClassicDouble(const char* number);
+bool parseInteger(const char*& it, const char* end, long long int& value);
+bool readPlyType(const std::string& name, PlyType& type);
+bool readPlyValue(const char*& it, const char* end, PlyFormat format, PlyType type, double& value);
+bool isDummy(const void* container);
+
+}
+
+bool parseDouble(const char*& it, const char* end, double& value);
+
 /**
      * Save
      */
@@ -89,6 +135,9 @@ bool saveMeshOnPly(const std::string &filename, size_t nVertices, size_t nTriang
 template <typename T, typename V, typename C = double, typename W = unsigned int>
 bool loadMeshFromObj(const std::string &filename, std::list<T>& coords, std::list<V>& faces, MeshType &meshType, int &modality = dummies::dummyInt, std::list<C> &verticesNormals = dummies::dummyListDouble, std::list<Color> &verticesColors = dummies::dummyListColor, std::list<Color> &faceColors = dummies::dummyListColor, std::list<W> &faceSizes = dummies::dummyListUnsignedInt);
 
+template <typename T, typename V, typename C = double, typename W = unsigned int>
+bool loadMeshFromObj(const std::string &filename, std::vector<T>& coords, std::vector<V>& faces, MeshType &meshType, int &modality = dummies::dummyInt, std::vector<C> &verticesNormals = dummies::dummyVectorDouble, std::vector<Color> &verticesColors = dummies::dummyVectorColor, std::vector<Color> &faceColors = dummies::dummyVectorColor, std::vector<W> &faceSizes = dummies::dummyVectorUnsignedInt);
+
 template <typename T, typename V, typename C = double>
 bool loadTriangleMeshFromObj(const std::string &filename, std::vector<T>& coords, std::vector<V>&triangles, int &modality = dummies::dummyInt, std::vector<C> &verticesNormals = dummies::dummyVectorDouble, std::vector<Color> &verticesColors = dummies::dummyVectorColor, std::vector<Color> &triangleColors = dummies::dummyVectorColor);
 
@@ -103,6 +152,9 @@ bool loadTriangleMeshFromObj(const std::string &filename, Eigen::PlainObjectBase
 template <typename T, typename V, typename C = double, typename W = unsigned int>
 bool loadMeshFromPly(const std::string &filename, std::list<T>& coords, std::list<V>& faces, MeshType &meshType, int &modality = dummies::dummyInt, std::list<C> &verticesNormals = dummies::dummyListDouble, std::list<Color> &verticesColors = dummies::dummyListColor, std::list<Color> &faceColors = dummies::dummyListColor, std::list<W> &faceSizes = dummies::dummyListUnsignedInt);
 
+template <typename T, typename V, typename C = double, typename W = unsigned int>
+bool loadMeshFromPly(const std::string &filename, std::vector<T>& coords, std::vector<V>& faces, MeshType &meshType, int &modality = dummies::dummyInt, std::vector<C> &verticesNormals = dummies::dummyVectorDouble, std::vector<Color> &verticesColors = dummies::dummyVectorColor, std::vector<Color> &faceColors = dummies::dummyVectorColor, std::vector<W> &faceSizes = dummies::dummyVectorUnsignedInt);
+
 #ifdef CG3_WITH_EIGEN
 template <typename T, typename V>
 bool loadTriangleMeshFromPly(const std::string &filename, Eigen::PlainObjectBase<T>& coords, Eigen::PlainObjectBase<V>&triangles);
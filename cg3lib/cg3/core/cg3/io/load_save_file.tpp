@@ -6,8 +6,22 @@
  */
 
 #include "load_save_file.h"
+#include "memory_mapped_file.h"
 #include "../utilities/tokenizer.h"
 
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <clocale>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <locale>
+#ifdef __APPLE__
+#include <xlocale.h>
+#endif
+
 namespace cg3 {
 
 inline void loadSave::ObjManager::manageColor(std::ofstream &fp, std::ofstream &fmtu, const Color &c, ColorMode colorMod, Color &actualColor, std::map<Color, std::string> &colors){
@@ -112,6 +126,274 @@ inline Color loadSave::getColor(size_t baseIndex, const T arrayColors[], ColorMo
     return c;
 }
 
+inline bool loadSave::internal::isBlank(char c){
+    return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+/**
+ * @brief loadSave::internal::skipBlanks
+ * Skips the blanks of a line, the new line character is not skipped.
+ */
+inline const char* loadSave::internal::skipBlanks(const char* it, const char* end){
+    while (it < end && isBlank(*it))
+        it++;
+    return it;
+}
+
+/**
+ * @brief loadSave::internal::skipSpaces
+ * Skips blanks and new line characters.
+ */
+inline const char* loadSave::internal::skipSpaces(const char* it, const char* end){
+    while (it < end && (isBlank(*it) || *it == '\n'))
+        it++;
+    return it;
+}
+
+inline const char* loadSave::internal::findLineEnd(const char* it, const char* end){
+    const void* newLine = std::memchr(it, '\n', (size_t)(end - it));
+    return newLine == nullptr ? end : static_cast<const char*>(newLine);
+}
+
+inline const char* loadSave::internal::findNextLine(const char* it, const char* end){
+    const char* lineEnd = findLineEnd(it, end);
+    return lineEnd == end ? end : lineEnd + 1;
+}
+
+inline const char* loadSave::internal::findTokenEnd(const char* it, const char* end){
+    while (it < end && !isBlank(*it) && *it != '\n')
+        it++;
+    return it;
+}
+
+/**
+ * @brief loadSave::internal::isToken
+ * @return true if the characters starting from it are the token followed by a blank or the end of the line
+ */
+inline bool loadSave::internal::isToken(const char* it, const char* end, const char* token){
+    size_t length = std::strlen(token);
+    return (size_t)(end - it) >= length && std::memcmp(it, token, length) == 0 &&
+            (it + length == end || isBlank(it[length]) || it[length] == '\n');
+}
+
+/**
+ * @brief loadSave::internal::readToken
+ * Reads the next token of the line.
+ */
+inline std::string loadSave::internal::readToken(const char*& it, const char* end){
+    const char* begin = skipBlanks(it, end);
+    it = findTokenEnd(begin, end);
+    return std::string(begin, it);
+}
+
+/**
+ * @brief loadSave::internal::parseClassicDouble
+ * Converts a number with the correctly rounded strtod of the classic "C" locale, created once, so that
+ * neither the global locale nor localeconv (not thread safe) are used while parsing in parallel.
+ * @param[in] number: null terminated number, already validated
+ * @return the parsed number
+ */
+inline double loadSave::internal::parseClassicDouble(const char* number){
+    #ifdef _WIN32
+    static const _locale_t classicLocale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(number, nullptr, classicLocale);
+    #else
+    static const locale_t classicLocale = newlocale(LC_NUMERIC_MASK, "C", locale_t(0));
+    return strtod_l(number, nullptr, classicLocale);
+    #endif
+}
+
+/**
+ * @brief loadSave::parseDouble
+ * Parses a double independently from the locale, skipping the blanks before it. The decimal digits
+ * are converted exactly when the mantissa has at most 53 bits and the power of ten is at most 22,
+ * otherwise the number is parsed by strtod with the classic locale.
+ * @param[in/out] it: position of the number, moved after the number
+ * @param[in] end: end of the buffer
+ * @param[out] value: the parsed number
+ * @return false if there is not a number followed by a space or the end of the buffer
+ */
+inline bool loadSave::parseDouble(const char*& it, const char* end, double& value){
+    static const double exactPowersOfTen[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    const int maxExactPowerOfTen = 22;
+    const unsigned long long int maxExactMantissa = 1ULL << 53;
+    const int maxMantissaDigits = 19;
+
+    const char* begin = internal::skipBlanks(it, end);
+    const char* p = begin;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')){
+        negative = *p == '-';
+        p++;
+    }
+
+    unsigned long long int mantissa = 0;
+    int digits = 0, exponent = 0;
+    bool exact = true, anyDigit = false;
+
+    for (; p < end && *p >= '0' && *p <= '9'; p++){
+        anyDigit = true;
+        if (digits < maxMantissaDigits){
+            mantissa = mantissa * 10 + (unsigned int)(*p - '0');
+            if (mantissa != 0)
+                digits++;
+        }
+        else {
+            exponent++;
+            exact = false;
+        }
+    }
+    if (p < end && *p == '.'){
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++){
+            anyDigit = true;
+            if (digits < maxMantissaDigits){
+                mantissa = mantissa * 10 + (unsigned int)(*p - '0');
+                if (mantissa != 0)
+                    digits++;
+                exponent--;
+            }
+            else
+                exact = false;
+        }
+    }
+    if (!anyDigit)
+        return false;
+
+    if (p < end && (*p == 'e' || *p == 'E')){
+        p++;
+        bool negativeExponent = false;
+        if (p < end && (*p == '+' || *p == '-')){
+            negativeExponent = *p == '-';
+            p++;
+        }
+        if (p == end || *p < '0' || *p > '9')
+            return false;
+        int writtenExponent = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++){
+            if (writtenExponent < 100000)
+                writtenExponent = writtenExponent * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -writtenExponent : writtenExponent;
+    }
+
+    if (p < end && !internal::isBlank(*p) && *p != '\n')
+        return false;
+
+    if (mantissa == 0 && exact){
+        value = negative ? -0.0 : 0.0;
+    }
+    else if (exact && mantissa <= maxExactMantissa && exponent >= -maxExactPowerOfTen && exponent <= maxExactPowerOfTen){
+        double result = (double)mantissa;
+        result = exponent < 0 ? result / exactPowersOfTen[-exponent] : result * exactPowersOfTen[exponent];
+        value = negative ? -result : result;
+    }
+    else if (p - begin < 64){
+        char number[64];
+        std::memcpy(number, begin, size_t(p - begin));
+        number[p - begin] = '\0';
+        value = internal::parseClassicDouble(number);
+    }
+    else {
+        value = internal::parseClassicDouble(std::string(begin, p).c_str());
+    }
+
+    it = p;
+    return true;
+}
+
+/**
+ * @brief loadSave::internal::parseInteger
+ * Parses an integer, the number can be followed by any character (e.g. '/' in obj faces).
+ * @param[in/out] it: first character of the number, moved after the number
+ * @param[in] end: end of the buffer
+ * @param[out] value: the parsed number
+ * @return false if there are no digits
+ */
+inline bool loadSave::internal::parseInteger(const char*& it, const char* end, long long int& value){
+    const char* p = it;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')){
+        negative = *p == '-';
+        p++;
+    }
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+    long long int result = 0;
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+        result = result * 10 + (*p - '0');
+    value = negative ? -result : result;
+    it = p;
+    return true;
+}
+
+inline bool loadSave::internal::readPlyType(const std::string& name, PlyType& type){
+    if (name == "char" || name == "int8") type = PLY_CHAR;
+    else if (name == "uchar" || name == "uint8") type = PLY_UCHAR;
+    else if (name == "short" || name == "int16") type = PLY_SHORT;
+    else if (name == "ushort" || name == "uint16") type = PLY_USHORT;
+    else if (name == "int" || name == "int32") type = PLY_INT;
+    else if (name == "uint" || name == "uint32") type = PLY_UINT;
+    else if (name == "float" || name == "float32") type = PLY_FLOAT;
+    else if (name == "double" || name == "float64") type = PLY_DOUBLE;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief loadSave::internal::readPlyValue
+ * Reads a value of the data section of a ply file, in ascii or binary format.
+ * @param[in/out] it: position of the value, moved after the value
+ * @param[in] end: end of the buffer
+ * @param[in] format: format of the file
+ * @param[in] type: type of the value
+ * @param[out] value: the value converted to double
+ * @return false if the file ends before the value or if it is not a number
+ */
+inline bool loadSave::internal::readPlyValue(const char*& it, const char* end, PlyFormat format, PlyType type, double& value){
+    if (format == PLY_ASCII){
+        it = skipSpaces(it, end);
+        return parseDouble(it, end, value);
+    }
+
+    static const unsigned int sizes[] = {1, 1, 2, 2, 4, 4, 4, 8};
+    unsigned int size = sizes[type];
+    if ((size_t)(end - it) < size)
+        return false;
+
+    unsigned char bytes[8];
+    std::memcpy(bytes, it, size);
+    it += size;
+
+    const unsigned short int endiannessTest = 1;
+    bool littleEndianHost = *reinterpret_cast<const unsigned char*>(&endiannessTest) == 1;
+    if (littleEndianHost != (format == PLY_BINARY_LITTLE_ENDIAN))
+        std::reverse(bytes, bytes + size);
+
+    switch (type) {
+        case PLY_CHAR: { signed char v; std::memcpy(&v, bytes, 1); value = v; break; }
+        case PLY_UCHAR: { unsigned char v; std::memcpy(&v, bytes, 1); value = v; break; }
+        case PLY_SHORT: { int16_t v; std::memcpy(&v, bytes, 2); value = v; break; }
+        case PLY_USHORT: { uint16_t v; std::memcpy(&v, bytes, 2); value = v; break; }
+        case PLY_INT: { int32_t v; std::memcpy(&v, bytes, 4); value = v; break; }
+        case PLY_UINT: { uint32_t v; std::memcpy(&v, bytes, 4); value = v; break; }
+        case PLY_FLOAT: { float v; std::memcpy(&v, bytes, 4); value = v; break; }
+        case PLY_DOUBLE: { double v; std::memcpy(&v, bytes, 8); value = v; break; }
+    }
+    return true;
+}
+
+/**
+ * @brief loadSave::internal::isDummy
+ * @return true if the container is one of the default arguments, which are not filled
+ */
+inline bool loadSave::internal::isDummy(const void* container){
+    return container == &dummies::dummyVectorDouble || container == &dummies::dummyVectorFloat ||
+            container == &dummies::dummyVectorInt || container == &dummies::dummyVectorUnsignedInt ||
+            container == &dummies::dummyVectorColor;
+}
+
 template <typename A, typename B, typename C , typename T , typename V , typename W>
 bool loadSave::saveMeshOnObj(const std::string& filename, size_t nVertices, size_t nFaces, const A vertices[], const B faces[], MeshType meshType, int modality, const C verticesNormals[], ColorMode colorMod, const T verticesColors[], const V faceColors[], const W polygonSizes[]) {
     std::string objfilename, mtufilename, mtufilenopath;
@@ -305,16 +587,38 @@ inline bool loadSave::saveMeshOnPly(const std::string& filename, size_t nVertice
     return true;
 }
 
+/**
+ * @brief loadSave::loadMeshFromObj
+ * Loads an obj file in lists, see the overload that loads the file in vectors.
+ */
 template <typename T, typename V, typename C, typename W>
 bool loadSave::loadMeshFromObj(const std::string& filename, std::list<T>& coords, std::list<V>& faces, loadSave::MeshType & meshType, int &modality, std::list<C> &verticesNormals, std::list<Color> &verticesColors, std::list<Color> &faceColors, std::list<W> &faceSizes) {
-    std::setlocale(LC_NUMERIC, "en_US.UTF-8"); // makes sure "." is the decimal separator
-
-    static std::string vertex = "v";
-    static std::string vertexNormal = "vn";
-    static std::string face   = "f";
+    std::vector<T> vCoords;
+    std::vector<V> vFaces;
+    std::vector<C> vVerticesNormals;
+    std::vector<Color> vVerticesColors;
+    std::vector<Color> vFaceColors;
+    std::vector<W> vFaceSizes;
+    bool r = loadMeshFromObj(filename, vCoords, vFaces, meshType, modality, vVerticesNormals, vVerticesColors, vFaceColors, vFaceSizes);
+    coords.assign(vCoords.begin(), vCoords.end());
+    faces.assign(vFaces.begin(), vFaces.end());
+    verticesNormals.assign(vVerticesNormals.begin(), vVerticesNormals.end());
+    verticesColors.assign(vVerticesColors.begin(), vVerticesColors.end());
+    faceColors.assign(vFaceColors.begin(), vFaceColors.end());
+    faceSizes.assign(vFaceSizes.begin(), vFaceSizes.end());
+    return r;
+}
 
-    std::ifstream file(filename.c_str());
-    std::string   line;
+/**
+ * @brief loadSave::loadMeshFromObj
+ * Loads an obj file in contiguous vectors. The file is mapped in memory and read twice:
+ * the first pass counts vertices, normals and faces to allocate the vectors, the second one
+ * parses the numbers in place, independently from the locale.
+ * Containers passed with their default values are not filled.
+ * @return false if the file can't be opened or if it contains malformed numbers
+ */
+template <typename T, typename V, typename C, typename W>
+bool loadSave::loadMeshFromObj(const std::string& filename, std::vector<T>& coords, std::vector<V>& faces, loadSave::MeshType & meshType, int &modality, std::vector<C> &verticesNormals, std::vector<Color> &verticesColors, std::vector<Color> &faceColors, std::vector<W> &faceSizes) {
     bool usemtu = false;
     bool first = true;
     std::map<std::string, Color> mapColors;
@@ -325,173 +629,181 @@ bool loadSave::loadMeshFromObj(const std::string& filename, std::list<T>& coords
     verticesNormals.clear();
     verticesColors.clear();
     faceColors.clear();
+    faceSizes.clear();
     modality = 0;
 
-    if(!file.is_open()) {
+    bool storeNormals = !internal::isDummy(&verticesNormals);
+    bool storeVertexColors = !internal::isDummy(&verticesColors);
+    bool storeFaceColors = !internal::isDummy(&faceColors);
+    bool storeFaceSizes = !internal::isDummy(&faceSizes);
+
+    MemoryMappedFile file;
+    if (!file.open(filename)) {
         return false;
     }
-    while(std::getline(file,line)) {
-
-        cg3::Tokenizer spaceTokenizer(line, ' ');
-
-        if (spaceTokenizer.begin() != spaceTokenizer.end()) {
-
-            cg3::Tokenizer::iterator token = spaceTokenizer.begin();
-            std::string header = *token;
-
-            if (header == "mtllib"){
-                modality |= COLOR_FACES;
-                usemtu = true;
-                std::string mtufilename = *(++token);
-                size_t lastSlash = filename.find_last_of("/");
-                if (lastSlash < filename.size()){
-                    std::string path = filename.substr(0, lastSlash);
-                    mtufilename = path + "/" + mtufilename;
-                }
-                if (! ObjManager::loadMtlFile(mtufilename, mapColors))
-                    usemtu = false;
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    //counting elements
+    size_t nVertices = 0, nNormals = 0, nFaces = 0;
+    for (const char* line = data; line < end; line = internal::findNextLine(line, end)) {
+        const char* it = internal::skipBlanks(line, end);
+        if (internal::isToken(it, end, "v"))
+            nVertices++;
+        else if (internal::isToken(it, end, "vn"))
+            nNormals++;
+        else if (internal::isToken(it, end, "f"))
+            nFaces++;
+    }
+    coords.reserve(3 * nVertices);
+    if (storeNormals)
+        verticesNormals.reserve(3 * nNormals);
+    faces.reserve(3 * nFaces);
+    if (storeFaceSizes)
+        faceSizes.reserve(nFaces);
+
+    for (const char* line = data; line < end; line = internal::findNextLine(line, end)) {
+        const char* lineEnd = internal::findLineEnd(line, end);
+        const char* it = internal::skipBlanks(line, lineEnd);
+        double value;
+
+        if (internal::isToken(it, lineEnd, "mtllib")){
+            modality |= COLOR_FACES;
+            usemtu = true;
+            it += 6;
+            std::string mtufilename = internal::readToken(it, lineEnd);
+            size_t lastSlash = filename.find_last_of("/");
+            if (lastSlash < filename.size()){
+                std::string path = filename.substr(0, lastSlash);
+                mtufilename = path + "/" + mtufilename;
             }
-
-            if (header == vertexNormal) {
-                modality |= NORMAL_VERTICES;
-                std::string x = *(++token);
-                std::string y = *(++token);
-                std::string z = *(++token);
-
-                verticesNormals.push_back(std::stod(x));
-                verticesNormals.push_back(std::stod(y));
-                verticesNormals.push_back(std::stod(z));
+            if (! ObjManager::loadMtlFile(mtufilename, mapColors))
+                usemtu = false;
+        }
+        else if (internal::isToken(it, lineEnd, "vn")) {
+            modality |= NORMAL_VERTICES;
+            it += 2;
+            for (unsigned int i = 0; i < 3; i++){
+                it = internal::skipBlanks(it, lineEnd);
+                if (!loadSave::parseDouble(it, lineEnd, value))
+                    return false;
+                if (storeNormals)
+                    verticesNormals.push_back(value);
+            }
+        }
+        // Handle
+        //
+        // v 0.123 0.234 0.345
+        // v 0.123 0.234 0.345 1.0
+        // v 0.123 0.234 0.345 r g b [alpha]
+        else if (internal::isToken(it, lineEnd, "v")) {
+            it += 1;
+            for (unsigned int i = 0; i < 3; i++){
+                it = internal::skipBlanks(it, lineEnd);
+                if (!loadSave::parseDouble(it, lineEnd, value))
+                    return false;
+                coords.push_back(value);
             }
 
-            // Handle
-            //
-            // v 0.123 0.234 0.345
-            // v 0.123 0.234 0.345 1.0
-            if (header == vertex) {
-                std::string x = *(++token);
-                std::string y = *(++token);
-                std::string z = *(++token);
-
-                coords.push_back(std::stod(x));
-                coords.push_back(std::stod(y));
-                coords.push_back(std::stod(z));
-
-                ++token;
-
-                if (token != spaceTokenizer.end()){
-                    modality |= COLOR_VERTICES;
-                    std::string r = *(token);
-                    std::string g = *(++token);
-                    std::string b = *(++token);
-                    ++token;
-                    double alpha = 255;
-                    if (token != spaceTokenizer.end()){
-                        alpha = std::stoi(*token);
-                    }
-                    Color c(std::stod(r)*255, std::stod(g)*255, std::stod(b)*255, alpha);
-                    verticesColors.push_back(c);
-                }
+            //the remaining values are the weight w (ignored) or the color with optional alpha
+            double extra[4];
+            unsigned int nExtra = 0;
+            for (it = internal::skipBlanks(it, lineEnd); it != lineEnd; it = internal::skipBlanks(it, lineEnd)){
+                if (nExtra == 4 || !loadSave::parseDouble(it, lineEnd, extra[nExtra]))
+                    return false;
+                nExtra++;
             }
-            // Handle
-            //
-            // f 1 2 3
-            // f 3/1 4/2 5/3
-            // f 6/4/1 3/5/3 7/6/5
-
-            else if (header == face) {
-                std::vector<std::string> dummy;
-                token++;
-                for (unsigned int i = 0; token != spaceTokenizer.end(); i++) {
-                    dummy.push_back(*(token));
-                    token++;
-                }
-                unsigned int nVert = (unsigned int)dummy.size();
+            if (nExtra == 3 || nExtra == 4){
+                modality |= COLOR_VERTICES;
+                double alpha = nExtra == 4 ? extra[3] : 255;
+                if (storeVertexColors)
+                    verticesColors.push_back(Color(extra[0]*255, extra[1]*255, extra[2]*255, (int)alpha));
+            }
+            else if (nExtra != 0 && nExtra != 1){
+                return false;
+            }
+        }
+        // Handle
+        //
+        // f 1 2 3
+        // f 3/1 4/2 5/3
+        // f 6/4/1 3/5/3 7/6/5
+        else if (internal::isToken(it, lineEnd, "f")) {
+            it += 1;
+            unsigned int nVert = 0;
+            for (it = internal::skipBlanks(it, lineEnd); it != lineEnd; it = internal::skipBlanks(it, lineEnd)){
+                long long int index;
+                if (!internal::parseInteger(it, lineEnd, index))
+                    return false;
+                faces.push_back(index - 1);
+                nVert++;
+                //texture and normal indices are ignored
+                it = internal::findTokenEnd(it, lineEnd);
+            }
+            if (storeFaceSizes)
                 faceSizes.push_back(nVert);
 
-                if (first == true){
-                    first = false;
-                    if (nVert == 3)
-                        meshType = TRIANGLE_MESH;
-                    else if (nVert == 4)
-                        meshType = QUAD_MESH;
-                    else
-                        meshType = POLYGON_MESH;
-                }
-                else {
-                    if (meshType == TRIANGLE_MESH && nVert != 3)
-                        meshType = POLYGON_MESH;
-                    if (meshType == QUAD_MESH && nVert != 4)
-                        meshType = POLYGON_MESH;
-                }
-
-                std::vector<cg3::Tokenizer> slashTokenizer;
-                for (unsigned int i=0; i<dummy.size(); i++){
-                    cg3::Tokenizer t(dummy[i], ' ');
-                    slashTokenizer.push_back(t);
-                }
-
-                for (unsigned int i=0; i<dummy.size(); i++){
-                    std::string ids = *(slashTokenizer[i].begin());
-                    faces.push_back(std::stoi(ids)-1);
-                }
-
-                if (usemtu){
-                    faceColors.push_back(actualColor);
-                }
+            if (first == true){
+                first = false;
+                if (nVert == 3)
+                    meshType = TRIANGLE_MESH;
+                else if (nVert == 4)
+                    meshType = QUAD_MESH;
+                else
+                    meshType = POLYGON_MESH;
+            }
+            else {
+                if (meshType == TRIANGLE_MESH && nVert != 3)
+                    meshType = POLYGON_MESH;
+                if (meshType == QUAD_MESH && nVert != 4)
+                    meshType = POLYGON_MESH;
             }
-            else if (header == "usemtl" && usemtu){
-                std::string color = *(++token);
-                assert(mapColors.find(color) != mapColors.end());
-                actualColor = mapColors[color];
+
+            if (usemtu && storeFaceColors){
+                faceColors.push_back(actualColor);
             }
         }
+        else if (internal::isToken(it, lineEnd, "usemtl") && usemtu){
+            it += 6;
+            std::map<std::string, Color>::const_iterator color = mapColors.find(internal::readToken(it, lineEnd));
+            assert(color != mapColors.end());
+            if (color != mapColors.end())
+                actualColor = color->second;
+        }
     }
-    file.close();
     return true;
 }
 
 template <typename T, typename V, typename C>
 bool loadSave::loadTriangleMeshFromObj(const std::string& filename, std::vector<T>& coords, std::vector<V>& triangles, int& modality, std::vector<C> &verticesNormals, std::vector<Color> &verticesColors, std::vector<Color> &triangleColors) {
-    std::list<T> dummyc;
-    std::list<V> dummyt;
-    MeshType meshType;
+    std::vector<T> dummyc;
+    std::vector<V> dummyt;
+    MeshType meshType = TRIANGLE_MESH;
     modality = 0;
-    std::list<C> dummyvn;
-    std::list<Color> dummycv;
-    std::list<Color> dummyct;
-    bool r = loadMeshFromObj(filename, dummyc, dummyt, meshType, modality, dummyvn, dummycv, dummyct);
+    std::vector<C> dummyvn;
+    std::vector<Color> dummycv;
+    std::vector<Color> dummyct;
+    std::vector<unsigned int> dummyfs;
+    bool r = loadMeshFromObj(filename, dummyc, dummyt, meshType, modality, dummyvn, dummycv, dummyct, dummyfs);
     if (r == true && meshType != TRIANGLE_MESH){
         std::cerr << "Error: mesh contained on " << filename << " is not a triangle mesh\n";
         r = false;
     }
     if (r) {
-        coords.clear();
-        triangles.clear();
-        coords = std::vector<T>{ std::make_move_iterator(std::begin(dummyc)),
-                                      std::make_move_iterator(std::end(dummyc)) };
-        triangles = std::vector<V>{ std::make_move_iterator(std::begin(dummyt)),
-                                         std::make_move_iterator(std::end(dummyt)) };
-        if (modality & NORMAL_VERTICES && dummyc.size() == dummyvn.size()){
-            verticesNormals.clear();
-            verticesNormals = std::vector<C>{ std::make_move_iterator(std::begin(dummyvn)),
-                                          std::make_move_iterator(std::end(dummyvn)) };
-        }
+        if (modality & NORMAL_VERTICES && dummyc.size() == dummyvn.size())
+            verticesNormals = std::move(dummyvn);
         else
             modality &= ~NORMAL_VERTICES;
-        if (modality & COLOR_VERTICES && dummyc.size() == dummycv.size()*3){
-            verticesColors.clear();
-            verticesColors = std::vector<Color>{ std::make_move_iterator(std::begin(dummycv)),
-                                                      std::make_move_iterator(std::end(dummycv)) };
-        }
+        if (modality & COLOR_VERTICES && dummyc.size() == dummycv.size()*3)
+            verticesColors = std::move(dummycv);
         else
             modality &= ~COLOR_VERTICES;
-        if (modality & COLOR_FACES && dummyt.size() == dummyct.size()*3){
-            triangleColors.clear();
-            triangleColors = std::vector<Color>{ std::make_move_iterator(std::begin(dummyct)),
-                                                      std::make_move_iterator(std::end(dummyct)) };
-        }
+        if (modality & COLOR_FACES && dummyt.size() == dummyct.size()*3)
+            triangleColors = std::move(dummyct);
         else
             modality &= ~COLOR_FACES;
+        coords = std::move(dummyc);
+        triangles = std::move(dummyt);
     }
     return r;
 }
@@ -626,262 +938,269 @@ bool loadSave::loadTriangleMeshFromObj(const std::string &filename, Eigen::Plain
 }
 #endif
 
+/**
+ * @brief loadSave::loadMeshFromPly
+ * Loads a ply file in lists, see the overload that loads the file in vectors.
+ */
 template <typename T, typename V, typename C, typename W>
-bool loadSave::loadMeshFromPly(const std::string& filename, std::list<T>& coords, std::list<V>& faces, loadSave::MeshType& meshType, int& modality, std::list<C>& verticesNormals, std::list<Color>& verticesColors, std::list<Color>& faceColors, std::list<W>& faceSizes) {
-    typedef enum {VERTEX, FACE, OTHER} ElementType;
-    typedef enum {unknown = -1, x, y, z, nx, ny, nz, red, green, blue, alpha, list} PropertyName;
-    typedef enum {UCHAR, FLOAT} PropertyType;
-    typedef struct {
-        PropertyName name;
-        PropertyType type;
-    } Property;
-
-    std::ifstream file(filename.c_str());
-    std::string   line;
+bool loadSave::loadMeshFromPly(const std::string& filename, std::list<T>& coords, std::list<V>& faces, loadSave::MeshType & meshType, int &modality, std::list<C> &verticesNormals, std::list<Color> &verticesColors, std::list<Color> &faceColors, std::list<W> &faceSizes) {
+    std::vector<T> vCoords;
+    std::vector<V> vFaces;
+    std::vector<C> vVerticesNormals;
+    std::vector<Color> vVerticesColors;
+    std::vector<Color> vFaceColors;
+    std::vector<W> vFaceSizes;
+    bool r = loadMeshFromPly(filename, vCoords, vFaces, meshType, modality, vVerticesNormals, vVerticesColors, vFaceColors, vFaceSizes);
+    coords.assign(vCoords.begin(), vCoords.end());
+    faces.assign(vFaces.begin(), vFaces.end());
+    verticesNormals.assign(vVerticesNormals.begin(), vVerticesNormals.end());
+    verticesColors.assign(vVerticesColors.begin(), vVerticesColors.end());
+    faceColors.assign(vFaceColors.begin(), vFaceColors.end());
+    faceSizes.assign(vFaceSizes.begin(), vFaceSizes.end());
+    return r;
+}
 
-    int nVer = -1, nFac = -1;
-    int nv=0, nf=0;
-    std::list<Property> vertexProperties;
-    std::list<Property> faceProperties;
+/**
+ * @brief loadSave::loadMeshFromPly
+ * Loads an ascii or binary (little or big endian) ply file in contiguous vectors.
+ * The file is mapped in memory, the vectors are allocated using the number of elements
+ * declared in the header and the numbers are parsed in place, independently from the locale.
+ * Properties and elements that are not used are skipped.
+ * Containers passed with their default values are not filled.
+ * @return false if the file can't be opened, if the header is not valid or if the data is truncated
+ */
+template <typename T, typename V, typename C, typename W>
+bool loadSave::loadMeshFromPly(const std::string& filename, std::vector<T>& coords, std::vector<V>& faces, loadSave::MeshType& meshType, int& modality, std::vector<C>& verticesNormals, std::vector<Color>& verticesColors, std::vector<Color>& faceColors, std::vector<W>& faceSizes) {
+    typedef enum {unknown = -1, x, y, z, nx, ny, nz, red, green, blue, alpha, list} PropertyName;
 
-    bool first = true;
+    coords.clear();
+    faces.clear();
+    verticesNormals.clear();
+    verticesColors.clear();
+    faceColors.clear();
+    faceSizes.clear();
+    modality = 0;
 
+    bool storeNormals = !internal::isDummy(&verticesNormals);
+    bool storeVertexColors = !internal::isDummy(&verticesColors);
+    bool storeFaceColors = !internal::isDummy(&faceColors);
+    bool storeFaceSizes = !internal::isDummy(&faceSizes);
 
-    if(!file.is_open()) {
+    MemoryMappedFile file;
+    if (!file.open(filename)) {
         std::cerr << "ERROR : read() : could not open input file " << filename.c_str() << "\n";
         return false;
     }
+    const char* it = file.data();
+    const char* end = it + file.size();
 
     //reading header
-    std::string headerLine;
-    bool error;
-    ElementType elementType = OTHER;
-    do {
-        error = !(std::getline(file,line));
-        if (!error){
-            cg3::Tokenizer spaceTokenizer(line, ' ');
-            if (spaceTokenizer.begin() == spaceTokenizer.end()) continue;
-            cg3::Tokenizer::iterator token = spaceTokenizer.begin();
-            headerLine = *token;
-            if (headerLine == "element") { //new type of element read
-                std::string s = *(++token);
-                if (s == "vertex"){
-                    elementType = VERTEX;
-                    nVer = std::stoi(*(++token));
-                }
-                else if (s == "face"){
-                    elementType = FACE;
-                    nFac = std::stoi(*(++token));
-                }
-                else elementType = OTHER;
-            }
-            else if (headerLine == "property"){
-                Property p;
-                std::string type = *(++token);
-                std::string name = *(++token);
-                p.name = unknown;
-                if (name == "x") p.name = x;
-                if (name == "y") p.name = y;
-                if (name == "z") p.name = z;
-                if (name == "nx") p.name = nx;
-                if (name == "ny") p.name = ny;
-                if (name == "nz") p.name = nz;
-                if (name == "red") p.name = red;
-                if (name == "green") p.name = green;
-                if (name == "blue") p.name = blue;
-                if (name == "alpha") p.name = alpha;
-                if (type == "list") p.name = list;
-                if (p.name != unknown){
-                    if (type == "float" || type == "double") p.type = FLOAT;
-                    else p.type = UCHAR;
-                    if (elementType == VERTEX)
-                        vertexProperties.push_back(p);
-                    else if (elementType == FACE)
-                        faceProperties.push_back(p);
-                }
+    internal::PlyFormat format = internal::PLY_ASCII;
+    std::vector<internal::PlyElement> elements;
+    bool error = !internal::isToken(internal::skipBlanks(it, end), end, "ply");
+    bool endHeader = false;
+    while (!error && !endHeader && it < end) {
+        const char* lineEnd = internal::findLineEnd(it, end);
+        std::string headerLine = internal::readToken(it, lineEnd);
+        if (headerLine == "format"){
+            std::string s = internal::readToken(it, lineEnd);
+            if (s == "ascii") format = internal::PLY_ASCII;
+            else if (s == "binary_little_endian") format = internal::PLY_BINARY_LITTLE_ENDIAN;
+            else if (s == "binary_big_endian") format = internal::PLY_BINARY_BIG_ENDIAN;
+            else error = true;
+        }
+        else if (headerLine == "element"){
+            internal::PlyElement element;
+            element.name = internal::readToken(it, lineEnd);
+            std::string count = internal::readToken(it, lineEnd);
+            const char* c = count.c_str();
+            long long int n = 0;
+            error = !internal::parseInteger(c, c + count.size(), n) || n < 0;
+            element.count = (unsigned long long int)n;
+            elements.push_back(element);
+        }
+        else if (headerLine == "property"){
+            internal::PlyProperty p;
+            std::string type = internal::readToken(it, lineEnd);
+            p.isList = type == "list";
+            if (p.isList){
+                error = !internal::readPlyType(internal::readToken(it, lineEnd), p.countType) ||
+                        !internal::readPlyType(internal::readToken(it, lineEnd), p.type);
+            }
+            else {
+                p.countType = internal::PLY_UCHAR;
+                error = !internal::readPlyType(type, p.type);
             }
+            std::string name = internal::readToken(it, lineEnd);
+            p.name = unknown;
+            if (name == "x") p.name = x;
+            if (name == "y") p.name = y;
+            if (name == "z") p.name = z;
+            if (name == "nx") p.name = nx;
+            if (name == "ny") p.name = ny;
+            if (name == "nz") p.name = nz;
+            if (name == "red") p.name = red;
+            if (name == "green") p.name = green;
+            if (name == "blue") p.name = blue;
+            if (name == "alpha") p.name = alpha;
+            if (p.isList) p.name = list;
+            if (elements.empty())
+                error = true;
+            else
+                elements.back().properties.push_back(p);
         }
+        else if (headerLine == "end_header"){
+            endHeader = true;
+        }
+        it = internal::findNextLine(lineEnd, end);
+    }
 
-    } while (!error && headerLine != "end_header");
-    modality = 0;
+    //vertices need coordinates, faces need a list of indices
+    const internal::PlyElement* vertexElement = nullptr;
+    const internal::PlyElement* faceElement = nullptr;
+    for (const internal::PlyElement& element : elements){
+        if (element.name == "vertex") vertexElement = &element;
+        if (element.name == "face") faceElement = &element;
+    }
     std::array<bool, 11> vb{{false}};
-    for (Property p : vertexProperties){
-        if (p.name >= 0)
-            vb[p.name] = true;
+    if (vertexElement != nullptr){
+        for (const internal::PlyProperty& p : vertexElement->properties)
+            if (p.name >= 0) vb[p.name] = true;
     }
-    if (!vb[0] || !vb[1] || !vb[2])
+    if (!vb[x] || !vb[y] || !vb[z])
         error = true;
-    if (vb[3] && vb[4] && vb [5])
+    if (vb[nx] && vb[ny] && vb[nz])
         modality |= NORMAL_VERTICES;
-    if (vb[6] && vb[7] && vb[8])
+    if (vb[red] && vb[green] && vb[blue])
         modality |= COLOR_VERTICES;
     std::array<bool, 11> fb{{false}};
-    for (Property p : faceProperties){
-        if (p.name >= 0)
-            fb[p.name] = true;
+    if (faceElement != nullptr){
+        for (const internal::PlyProperty& p : faceElement->properties)
+            if (p.name >= 0) fb[p.name] = true;
     }
-    if (!fb[10])
+    if (!fb[list])
         error = true;
-    if (fb[6] && fb[7] && fb[8])
+    if (fb[red] && fb[green] && fb[blue])
         modality |= COLOR_FACES;
 
-    if (error){ //error while reading header
+    if (error || !endHeader){ //error while reading header
         std::cerr << "Error while parsing ply file\n";
         return false;
     }
 
+    //the declared numbers are bounded by the size of the file, so a wrong header doesn't cause huge allocations
+    size_t maxElements = file.size();
+    coords.reserve(std::min<size_t>(3 * vertexElement->count, maxElements));
+    if (storeNormals && (modality & NORMAL_VERTICES))
+        verticesNormals.reserve(std::min<size_t>(3 * vertexElement->count, maxElements));
+    if (storeVertexColors && (modality & COLOR_VERTICES))
+        verticesColors.reserve(std::min<size_t>(vertexElement->count, maxElements));
+    faces.reserve(std::min<size_t>(3 * faceElement->count, maxElements));
+    if (storeFaceSizes)
+        faceSizes.reserve(std::min<size_t>(faceElement->count, maxElements));
+    if (storeFaceColors && (modality & COLOR_FACES))
+        faceColors.reserve(std::min<size_t>(faceElement->count, maxElements));
+
+    //the vertex indices of a face are in its first list property
+    const internal::PlyProperty* indicesProperty = nullptr;
+    for (const internal::PlyProperty& p : faceElement->properties){
+        if (p.isList && indicesProperty == nullptr)
+            indicesProperty = &p;
+    }
 
-    while(std::getline(file,line)) {
-        cg3::Tokenizer spaceTokenizer(line, ' ');
+    bool first = true;
+    std::vector<long long int> indices;
+    double value;
 
-        if (spaceTokenizer.begin() == spaceTokenizer.end()) continue;
+    //reading data, elements are stored in the order of the header
+    for (const internal::PlyElement& element : elements){
+        bool isVertex = &element == vertexElement;
+        bool isFace = &element == faceElement;
 
-        if (nv < nVer){ //reading vertices
-            cg3::Tokenizer::iterator token = spaceTokenizer.begin();
-            std::array<double, 6> cnv;
+        for (unsigned long long int n = 0; n < element.count; n++){
+            std::array<double, 6> cnv{{0, 0, 0, 0, 0, 0}};
             Color c;
+            indices.clear();
+
+            for (const internal::PlyProperty& p : element.properties){
+                if (p.isList){
+                    if (!internal::readPlyValue(it, end, format, p.countType, value))
+                        return false;
+                    unsigned long long int size = (unsigned long long int)value;
+                    for (unsigned long long int i = 0; i < size; i++){
+                        if (!internal::readPlyValue(it, end, format, p.type, value))
+                            return false;
+                        if (isFace && &p == indicesProperty)
+                            indices.push_back((long long int)value);
+                    }
+                    continue;
+                }
 
-            //manage properties of vertex
-            for (Property p : vertexProperties){
-                if (token == spaceTokenizer.end())
+                if (!internal::readPlyValue(it, end, format, p.type, value))
                     return false;
-                if (p.name >= 0 && p.name < 6){
-                    cnv[p.name] = std::stod(*token);
+
+                bool isFloat = p.type == internal::PLY_FLOAT || p.type == internal::PLY_DOUBLE;
+                if (p.name >= x && p.name <= nz){
+                    cnv[p.name] = value;
                 }
-                else if (p.name >= 6 && p.name < 10){
+                else if (p.name >= red && p.name <= alpha){
                     switch (p.name) {
                         case red:
-                            if (p.type == UCHAR)
-                                c.setRed(std::stoi(*token));
-                            else
-                                c.setRedF(std::stof(*token));
+                            if (isFloat) c.setRedF((float)value); else c.setRed((unsigned char)value);
                             break;
                         case green:
-                            if (p.type == UCHAR)
-                                c.setGreen(std::stoi(*token));
-                            else
-                                c.setGreenF(std::stof(*token));
+                            if (isFloat) c.setGreenF((float)value); else c.setGreen((unsigned char)value);
                             break;
                         case blue:
-                            if (p.type == UCHAR)
-                                c.setBlue(std::stoi(*token));
-                            else
-                                c.setBlueF(std::stof(*token));
+                            if (isFloat) c.setBlueF((float)value); else c.setBlue((unsigned char)value);
                             break;
                         case alpha:
-                            if (p.type == UCHAR)
-                                c.setAlpha(std::stoi(*token));
-                            else
-                                c.setAlphaF(std::stof(*token));
+                            if (isFloat) c.setAlphaF((float)value); else c.setAlpha((unsigned char)value);
                             break;
                         default:
                             ;
                     }
                 }
-
-                //move to next property
-                token++;
             }
 
-            //save properties to lists
-            coords.push_back(cnv[0]);
-            coords.push_back(cnv[1]);
-            coords.push_back(cnv[2]);
-            if (modality & NORMAL_VERTICES){
-                verticesNormals.push_back(cnv[3]);
-                verticesNormals.push_back(cnv[4]);
-                verticesNormals.push_back(cnv[5]);
-            }
-            if (modality & COLOR_VERTICES){
-                verticesColors.push_back(c);
+            if (isVertex){
+                coords.push_back(cnv[x]);
+                coords.push_back(cnv[y]);
+                coords.push_back(cnv[z]);
+                if ((modality & NORMAL_VERTICES) && storeNormals){
+                    verticesNormals.push_back(cnv[nx]);
+                    verticesNormals.push_back(cnv[ny]);
+                    verticesNormals.push_back(cnv[nz]);
+                }
+                if ((modality & COLOR_VERTICES) && storeVertexColors)
+                    verticesColors.push_back(c);
             }
-
-            //move to next face
-            nv++;
-        }
-        else if (nf < nFac){ //reading faces
-            cg3::Tokenizer::iterator token = spaceTokenizer.begin();
-            std::vector<int> indices;
-            Color c;
-
-            //manage properties of face
-            for (Property p : faceProperties){
-                if (token == spaceTokenizer.end())
-                    return false;
-                if (p.name == list){
-                    int size = std::stoi(*(token));
-                    indices.resize(size);
-                    for (int i = 0; i < size; i++){
-                        token++;
-                        if (token == spaceTokenizer.end())
-                            return false;
-                        indices[i] = std::stoi(*token);
-                    }
+            else if (isFace){
+                //managing meshtype
+                if (first == true){
+                    first = false;
+                    if (indices.size() == 3)
+                        meshType = TRIANGLE_MESH;
+                    else if (indices.size() == 4)
+                        meshType = QUAD_MESH;
+                    else
+                        meshType = POLYGON_MESH;
                 }
                 else {
-                    switch (p.name) {
-                        case red:
-                            if (p.type == UCHAR)
-                                c.setRed(std::stoi(*token));
-                            else
-                                c.setRedF(std::stof(*token));
-                            break;
-                        case green:
-                            if (p.type == UCHAR)
-                                c.setGreen(std::stoi(*token));
-                            else
-                                c.setGreenF(std::stof(*token));
-                            break;
-                        case blue:
-                            if (p.type == UCHAR)
-                                c.setBlue(std::stoi(*token));
-                            else
-                                c.setBlueF(std::stof(*token));
-                            break;
-                        case alpha:
-                            if (p.type == UCHAR)
-                                c.setAlpha(std::stoi(*token));
-                            else
-                                c.setAlphaF(std::stof(*token));
-                            break;
-                        default:
-                            ;
-                    }
+                    if (meshType == TRIANGLE_MESH && indices.size() != 3)
+                        meshType = POLYGON_MESH;
+                    if (meshType == QUAD_MESH && indices.size() != 4)
+                        meshType = POLYGON_MESH;
                 }
-
-                //move to next property
-                token++;
+                if (storeFaceSizes)
+                    faceSizes.push_back((W)indices.size());
+                for (unsigned int i = 0; i < indices.size(); i++)
+                    faces.push_back(indices[i]);
+                if ((modality & COLOR_FACES) && storeFaceColors)
+                    faceColors.push_back(c);
             }
-
-            //managing meshtype
-            if (first == true){
-                first = false;
-                if (indices.size() == 3)
-                    meshType = TRIANGLE_MESH;
-                else if (indices.size() == 4)
-                    meshType = QUAD_MESH;
-                else
-                    meshType = POLYGON_MESH;
-            }
-            else {
-                if (meshType == TRIANGLE_MESH && indices.size() != 3)
-                    meshType = POLYGON_MESH;
-                if (meshType == QUAD_MESH && indices.size() != 4)
-                    meshType = POLYGON_MESH;
-            }
-            //save properties to lists
-            faceSizes.push_back((unsigned int)indices.size());
-            for (unsigned int i = 0; i < indices.size(); i++)
-                faces.push_back(indices[i]);
-            if (modality & COLOR_FACES)
-                faceColors.push_back(c);
-
-            //move to next face
-            nf++;
-
         }
     }
-    file.close();
     return true;
 }
 
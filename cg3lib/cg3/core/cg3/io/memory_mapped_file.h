@@ -0,0 +1,58 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+
+#ifndef CG3_MEMORY_MAPPED_FILE_H
+#define CG3_MEMORY_MAPPED_FILE_H
+
+#include <string>
+#include <vector>
+
+namespace cg3 {
+
+/**
+ * @brief The MemoryMappedFile class
+ * Read-only view of the whole content of a file.
+ * On POSIX systems the file is mapped in memory, on the other systems it is read in a buffer.
+ * The view is released when the object is destroyed or when close is called.
+ * The access pattern tells the operating system how the content will be read,
+ * so it can read ahead the sequential reads or avoid loading unused pages for the random ones.
+ */
+class MemoryMappedFile {
+    public:
+        typedef enum {
+            NORMAL_ACCESS,
+            SEQUENTIAL_ACCESS,
+            RANDOM_ACCESS
+        } AccessPattern;
+
+        MemoryMappedFile();
+        ~MemoryMappedFile();
+
+        MemoryMappedFile(const MemoryMappedFile&) = delete;
+        MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+        bool open(const std::string& filename, AccessPattern access = SEQUENTIAL_ACCESS);
+        void close();
+
+        void setAccessPattern(AccessPattern access);
+
+        bool isOpen() const;
+
+        const char* data() const;
+        size_t size() const;
+
+    private:
+        const char* begin;
+        size_t length;
+        bool opened;
+        void* mapping;
+        std::vector<char> buffer;
+};
+
+}
+
+#include "memory_mapped_file.tpp"
+
+#endif // CG3_MEMORY_MAPPED_FILE_H
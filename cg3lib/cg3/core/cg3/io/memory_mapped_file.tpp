@@ -0,0 +1,143 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+
+#include "memory_mapped_file.h"
+
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cg3 {
+
+inline MemoryMappedFile::MemoryMappedFile() :
+    begin(nullptr),
+    length(0),
+    opened(false),
+    mapping(nullptr) {
+}
+
+inline MemoryMappedFile::~MemoryMappedFile() {
+    close();
+}
+
+/**
+ * @brief MemoryMappedFile::open
+ * Maps the file in memory, the content is loaded lazily while it is read.
+ * @param[in] filename: the path of the file
+ * @param[in] access: how the content will be read
+ * @return true if the file was opened
+ */
+inline bool MemoryMappedFile::open(const std::string& filename, AccessPattern access) {
+    close();
+
+    #ifndef _WIN32
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0)
+        return false;
+
+    struct stat status;
+    if (fstat(descriptor, &status) != 0){
+        ::close(descriptor);
+        return false;
+    }
+
+    length = (size_t)status.st_size;
+
+    //an empty file can't be mapped
+    if (length > 0){
+        void* address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if (address == MAP_FAILED){
+            ::close(descriptor);
+            length = 0;
+            return false;
+        }
+        mapping = address;
+        begin = static_cast<const char*>(address);
+        setAccessPattern(access);
+    }
+
+    //the mapping is still valid after closing the descriptor
+    ::close(descriptor);
+    #else
+    std::ifstream file(filename, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return false;
+
+    length = (size_t)file.tellg();
+    buffer.resize(length);
+
+    file.seekg(0);
+    if (length > 0 && !file.read(buffer.data(), (std::streamsize)length)){
+        buffer.clear();
+        length = 0;
+        return false;
+    }
+    begin = buffer.data();
+    #endif
+
+    opened = true;
+    return true;
+}
+
+/**
+ * @brief MemoryMappedFile::close
+ * Releases the view, the pointer returned by data is no more valid.
+ */
+inline void MemoryMappedFile::close() {
+    #ifndef _WIN32
+    if (mapping != nullptr)
+        munmap(mapping, length);
+    #endif
+    std::vector<char>().swap(buffer);
+    mapping = nullptr;
+    begin = nullptr;
+    length = 0;
+    opened = false;
+}
+
+/**
+ * @brief MemoryMappedFile::setAccessPattern
+ * Tells the operating system how the mapped content will be read from now on,
+ * e.g. random after a first sequential pass. Without mmap it does nothing.
+ * @param[in] access: how the content will be read
+ */
+inline void MemoryMappedFile::setAccessPattern(AccessPattern access) {
+    #ifndef _WIN32
+    if (mapping == nullptr)
+        return;
+
+    int advice = MADV_NORMAL;
+    if (access == SEQUENTIAL_ACCESS)
+        advice = MADV_SEQUENTIAL;
+    else if (access == RANDOM_ACCESS)
+        advice = MADV_RANDOM;
+    madvise(mapping, length, advice);
+    #else
+    (void)access;
+    #endif
+}
+
+inline bool MemoryMappedFile::isOpen() const {
+    return opened;
+}
+
+/**
+ * @brief MemoryMappedFile::data
+ * @return pointer to the first byte of the file, nullptr if the file is empty
+ */
+inline const char* MemoryMappedFile::data() const {
+    return begin;
+}
+
+inline size_t MemoryMappedFile::size() const {
+    return length;
+}
+
+}
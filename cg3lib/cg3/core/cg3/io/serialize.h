@@ -112,6 +112,39 @@ namespace serializer {
     void deserialize(std::array<T, A...> &a, std::ifstream& binaryFile);
 
     namespace internal {
+        /**
+         * @brief Elements whose serialization is the copy of their bytes.
+         *
+         * Contiguous containers (std::vector, std::array and cg3::Array) of these elements
+         * are written and read with a single stream operation.
+         * Fundamental types are serialized by copying their bytes, so the block has the same
+         * format of the element-wise serialization. It can be specialized for other trivially
+         * copyable types that have no dedicated serialize/deserialize functions.
+         */
+        template <typename T>
+        struct isBlockSerializable : std::integral_constant<bool, std::is_fundamental<T>::value> {};
+
+        template <typename T>
+        void serializeElements(const T* elements, unsigned long long int size, std::ofstream& binaryFile, std::true_type);
+
+        template <typename T>
+        void serializeElements(const T* elements, unsigned long long int size, std::ofstream& binaryFile, std::false_type);
+
+        template <typename T>
+        void deserializeElements(T* elements, unsigned long long int size, std::ifstream& binaryFile, std::true_type);
+
+        template <typename T>
+        void deserializeElements(T* elements, unsigned long long int size, std::ifstream& binaryFile, std::false_type);
+
+        /**
+         * Blocks up to this size are allocated without checking the remaining bytes of the stream:
+         * the allocation is cheap, and a corrupted size fails when the elements are read.
+         */
+        const unsigned long long int uncheckedBlockBytes = 1 << 20;
+
+        template <typename T>
+        void checkBlockSize(unsigned long long int size, std::ifstream& binaryFile, const std::string& container);
+
         template <typename T>
         std::string typeName(bool specifyIfConst = true, bool specifyIfVolatile = true, bool specifyIfReference = true);
 
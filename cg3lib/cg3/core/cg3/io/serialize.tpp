@@ -468,8 +468,7 @@ inline void serializer::serialize(const std::vector<T, A...> &v, std::ofstream&
     unsigned long long int size = v.size();
     serializer::serialize(std::string("stdvector"), binaryFile);
     serializer::serialize(size, binaryFile);
-    for (typename std::vector<T, A...>::const_iterator it = v.begin(); it != v.end(); ++it)
-        serializer::serialize((*it), binaryFile);
+    internal::serializeElements(v.data(), size, binaryFile, internal::isBlockSerializable<T>());
 }
 
 /**
@@ -524,10 +523,10 @@ inline void serializer::deserialize(std::vector<T, A...> &v, std::ifstream& bina
         if (s != "stdvector")
             throw std::ios_base::failure("Mismatching String: " + s + " != stdvector");
         serializer::deserialize(size, binaryFile);
+        if (internal::isBlockSerializable<T>::value)
+            internal::checkBlockSize<T>(size, binaryFile, "std::vector");
         tmpv.resize(size);
-        for (unsigned int it = 0; it < size; ++it){
-            serializer::deserialize(tmpv[it], binaryFile);
-        }
+        internal::deserializeElements(tmpv.data(), size, binaryFile, internal::isBlockSerializable<T>());
         v = std::move(tmpv);
 
     }
@@ -658,8 +657,7 @@ inline void serializer::serialize(const std::array<T, A...> &a, std::ofstream& b
     unsigned long long int size = a.size();
     serializer::serialize("stdarray", binaryFile);
     serializer::serialize(size, binaryFile);
-    for (typename std::array<T, A...>::const_iterator it = a.begin(); it != a.end(); ++it)
-        serializer::serialize((*it), binaryFile);
+    internal::serializeElements(a.data(), size, binaryFile, internal::isBlockSerializable<T>());
 }
 
 /**
@@ -682,9 +680,7 @@ inline void serializer::deserialize(std::array<T, A...> &a, std::ifstream& binar
         if (size != a.size())
             throw std::ios_base::failure(std::string("Mismatching std::array size: ") + std::to_string(size) + " != " + std::to_string(a.size()));
         std::vector<T> tmp(size);
-        for (unsigned int it = 0; it < size; ++it){
-            serializer::deserialize(tmp[it], binaryFile);
-        }
+        internal::deserializeElements(tmp.data(), size, binaryFile, internal::isBlockSerializable<T>());
         std::copy_n(tmp.begin(), size, a.begin());
     }
     catch(std::ios_base::failure& e){
@@ -697,6 +693,97 @@ inline void serializer::deserialize(std::array<T, A...> &a, std::ifstream& binar
     }
 }
 
+/**
+ * @brief Serializer::internal::serializeElements
+ *
+ * Writes a contiguous block of elements with a single stream operation.
+ *
+ * @param[in] elements: pointer to the first element
+ * @param[in] size: number of elements
+ * @param binaryFile
+ */
+template <typename T>
+inline void serializer::internal::serializeElements(const T* elements, unsigned long long int size, std::ofstream& binaryFile, std::true_type){
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be serialized as a block!");
+    binaryFile.write(reinterpret_cast<const char*>(elements), static_cast<std::streamsize>(size * sizeof(T)));
+}
+
+/**
+ * @brief Serializer::internal::serializeElements
+ *
+ * Serializes the elements one by one.
+ *
+ * @param[in] elements: pointer to the first element
+ * @param[in] size: number of elements
+ * @param binaryFile
+ */
+template <typename T>
+inline void serializer::internal::serializeElements(const T* elements, unsigned long long int size, std::ofstream& binaryFile, std::false_type){
+    for (unsigned long long int it = 0; it < size; ++it)
+        serializer::serialize(elements[it], binaryFile);
+}
+
+/**
+ * @brief Serializer::internal::deserializeElements
+ *
+ * Reads a contiguous block of elements with a single stream operation.
+ *
+ * @throws std::ios_base::failure if the stream doesn't contain all the elements.
+ * @param[out] elements: pointer to the first element
+ * @param[in] size: number of elements
+ * @param binaryFile
+ */
+template <typename T>
+inline void serializer::internal::deserializeElements(T* elements, unsigned long long int size, std::ifstream& binaryFile, std::true_type){
+    static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be deserialized as a block!");
+    if (! binaryFile.read(reinterpret_cast<char*>(elements), static_cast<std::streamsize>(size * sizeof(T))))
+        throw std::ios_base::failure("Deserialization failed of a block of " + std::to_string(size) + " " + typeName<T>(false, false, false));
+}
+
+/**
+ * @brief Serializer::internal::deserializeElements
+ *
+ * Deserializes the elements one by one.
+ *
+ * @param[out] elements: pointer to the first element
+ * @param[in] size: number of elements
+ * @param binaryFile
+ */
+template <typename T>
+inline void serializer::internal::deserializeElements(T* elements, unsigned long long int size, std::ifstream& binaryFile, std::false_type){
+    for (unsigned long long int it = 0; it < size; ++it)
+        serializer::deserialize(elements[it], binaryFile);
+}
+
+/**
+ * @brief Serializer::internal::checkBlockSize
+ *
+ * Checks that the stream contains the bytes of a block before allocating it,
+ * so a corrupted size doesn't cause a huge allocation. Blocks smaller than
+ * uncheckedBlockBytes are not checked, so the small vectors nested in other
+ * containers don't seek the end of the stream for each element.
+ *
+ * @throws std::ios_base::failure if the remaining bytes are less than the size of the block.
+ * @param[in] size: number of elements
+ * @param binaryFile
+ * @param[in] container: name of the container, used in the error message
+ */
+template <typename T>
+inline void serializer::internal::checkBlockSize(unsigned long long int size, std::ifstream& binaryFile, const std::string& container){
+    if (size <= uncheckedBlockBytes / sizeof(T))
+        return;
+
+    std::streampos current = binaryFile.tellg();
+    binaryFile.seekg(0, std::ios::end);
+    std::streampos end = binaryFile.tellg();
+    binaryFile.seekg(current);
+
+    unsigned long long int remaining = end > current ? static_cast<unsigned long long int>(end - current) : 0;
+    if (size > remaining / sizeof(T))
+        throw std::ios_base::failure("Mismatching " + container + " size: " + std::to_string(size) + " elements of " +
+                                     typeName<T>(false, false, false) + " exceed the remaining " + std::to_string(remaining) + " bytes");
+}
+
 template<typename T>
 inline std::string serializer::internal::typeName(bool specifyIfConst, bool specifyIfVolatile, bool specifyIfReference) {
     typedef typename std::remove_reference<T>::type TR;
@@ -152,7 +152,23 @@ void cg3::Array<T, N>::serialize(std::ofstream &binaryFile) const {
 
 template<class T, size_t N>
 void cg3::Array<T, N>::deserialize(std::ifstream &binaryFile) {
-    cg3::deserializeObjectAttributes("cg3Array"  + std::to_string(N)+ "D", binaryFile, sizes, v);
+    std::array<unsigned long int, N> tmpSizes;
+    std::vector<T> tmpV;
+    std::streampos begin = binaryFile.tellg();
+    cg3::deserializeObjectAttributes("cg3Array"  + std::to_string(N)+ "D", binaryFile, tmpSizes, tmpV);
+
+    //the number of elements must match the sizes
+    unsigned long int size = 1;
+    for (unsigned int i = 0; i < N; i++)
+        size *= tmpSizes[i];
+    if (size != tmpV.size()){
+        serializer::restorePosition(binaryFile, begin);
+        throw std::ios_base::failure("Mismatching cg3Array" + std::to_string(N) + "D size: " +
+                                     std::to_string(size) + " != " + std::to_string(tmpV.size()));
+    }
+
+    sizes = std::move(tmpSizes);
+    v = std::move(tmpV);
 }
 
 template<class T, size_t N>
@@ -79,7 +79,9 @@ contains(DEFINES, CG3_VIEWER_DEFINED){
         $$PWD/viewer/interfaces/drawable_mesh.h \
         $$PWD/viewer/utilities/loadersaver.h \
         $$PWD/viewer/utilities/consolestream.h \
+        $$PWD/viewer/utilities/render_statistics.h \
         $$PWD/viewer/renderable_objects/renderable_objects.h \
+        $$PWD/viewer/renderable_objects/vertex_arrays.h \
         $$PWD/viewer/renderable_objects/2d/renderable_objects2d.h \
         $$PWD/viewer/drawable_objects/2d/drawable_bounding_box2d.h \
         $$PWD/viewer/drawable_objects/2d/drawable_segment2d.h
@@ -91,8 +93,10 @@ contains(DEFINES, CG3_VIEWER_DEFINED){
         $$PWD/viewer/interfaces/drawable_mesh.cpp \
         $$PWD/viewer/utilities/loadersaver.cpp \
         $$PWD/viewer/utilities/consolestream.tpp \
+        $$PWD/viewer/utilities/render_statistics.cpp \
         $$PWD/viewer/drawable_objects/2d/drawable_segment2d.tpp \
         $$PWD/viewer/renderable_objects/renderable_objects.tpp \
+        $$PWD/viewer/renderable_objects/vertex_arrays.tpp \
         $$PWD/viewer/drawable_objects/2d/drawable_bounding_box2d.cpp \
         $$PWD/viewer/renderable_objects/2d/renderable_objects2d.tpp
 
@@ -57,17 +57,21 @@ void DrawableBoundingBox2D::setPointSize(int s) {
 }
 
 void DrawableBoundingBox2D::drawEdges() const {
-    viewer::drawLine2D(Point2Dd(min().x(), min().y()), Point2Dd(max().x(), min().y()), edgeColor, edgeWidth);
-    viewer::drawLine2D(Point2Dd(max().x(), min().y()), Point2Dd(max().x(), max().y()), edgeColor, edgeWidth);
-    viewer::drawLine2D(Point2Dd(max().x(), max().y()), Point2Dd(min().x(), max().y()), edgeColor, edgeWidth);
-    viewer::drawLine2D(Point2Dd(min().x(), max().y()), Point2Dd(min().x(), min().y()), edgeColor, edgeWidth);
+    const std::array<double, 16> coordinates = {{
+        min().x(), min().y(), max().x(), min().y(),
+        max().x(), min().y(), max().x(), max().y(),
+        max().x(), max().y(), min().x(), max().y(),
+        min().x(), max().y(), min().x(), min().y()}};
+    viewer::drawLines2D(coordinates, edgeColor, edgeWidth);
 }
 
 void DrawableBoundingBox2D::drawPoints() const {
-    viewer::drawPoint2D(minCoord, pointColor, pointSize);
-    viewer::drawPoint2D(cg3::Point2Dd(minCoord.x(), maxCoord.y()), pointColor, pointSize);
-    viewer::drawPoint2D(cg3::Point2Dd(maxCoord.x(), minCoord.y()), pointColor, pointSize);
-    viewer::drawPoint2D(maxCoord, pointColor, pointSize);
+    const std::array<double, 8> coordinates = {{
+        minCoord.x(), minCoord.y(),
+        minCoord.x(), maxCoord.y(),
+        maxCoord.x(), minCoord.y(),
+        maxCoord.x(), maxCoord.y()}};
+    viewer::drawPoints2D(coordinates, pointColor, pointSize);
 }
 
 }
@@ -20,14 +20,34 @@ void DrawableObjects::draw() const {
         for (const Sphere& s : spheres){
             viewer::drawSphere(s.center, s.radius, s.color, s.precision);
         }
-        for (const Point& p : points){
-            viewer::drawPoint(p.p, p.color, p.size);
+        //consecutive points with the same size are drawn with a single call,
+        //the buffers keep their capacity between the frames
+        std::vector<double>& coordinates = coordinateBuffer;
+        std::vector<float>& colors = colorBuffer;
+        for (size_t first = 0, last = 0; first < points.size(); first = last){
+            coordinates.clear();
+            colors.clear();
+            for (; last < points.size() && points[last].size == points[first].size; last++){
+                const Point& p = points[last];
+                coordinates.insert(coordinates.end(), {p.p.x(), p.p.y(), p.p.z()});
+                colors.insert(colors.end(), {float(p.color.redF()), float(p.color.greenF()), float(p.color.blueF())});
+            }
+            viewer::drawPoints(coordinates, colors, points[first].size);
         }
         for (const Cylinder& c : cylinders){
             viewer::drawCylinder(c.a, c.b, c.radius, c.radius, c.color);
         }
-        for (const Line& l : lines){
-            viewer::drawLine(l.a, l.b, l.color, l.width);
+        //the same for lines with the same width
+        for (size_t first = 0, last = 0; first < lines.size(); first = last){
+            coordinates.clear();
+            colors.clear();
+            for (; last < lines.size() && lines[last].width == lines[first].width; last++){
+                const Line& l = lines[last];
+                coordinates.insert(coordinates.end(), {l.a.x(), l.a.y(), l.a.z(), l.b.x(), l.b.y(), l.b.z()});
+                for (unsigned int i = 0; i < 2; i++)
+                    colors.insert(colors.end(), {float(l.color.redF()), float(l.color.greenF()), float(l.color.blueF())});
+            }
+            viewer::drawLines(coordinates, colors, lines[first].width);
         }
         for (const Triangle& t : triangles){
             viewer::drawTriangle(t.a, t.b, t.c, t.color, t.width, t.fill);
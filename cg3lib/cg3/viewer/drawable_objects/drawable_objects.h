@@ -78,6 +78,10 @@ class DrawableObjects : public DrawableObject{
 
         bool visible;
         BoundingBox bb;
+
+        //coordinates and colors of the points and lines drawn with a single call
+        mutable std::vector<double> coordinateBuffer;
+        mutable std::vector<float> colorBuffer;
 };
 
 }
@@ -7,31 +7,192 @@
  */
 
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
 
 #include "glcanvas.h"
 #include <cg3/geometry/plane.h>
 #include <cg3/geometry/2d/point2d.h>
 
+#ifndef APIENTRY
+#define APIENTRY
+#endif
+
+#ifndef GL_TIME_ELAPSED
+#define GL_TIME_ELAPSED 0x88BF
+#endif
+#ifndef GL_QUERY_RESULT
+#define GL_QUERY_RESULT 0x8866
+#endif
+#ifndef GL_QUERY_RESULT_AVAILABLE
+#define GL_QUERY_RESULT_AVAILABLE 0x8867
+#endif
+
 namespace cg3 {
 
 namespace viewer {
 
-GLCanvas::GLCanvas(QWidget * parent) : clearColor(Qt::white) {
+//GL_TIME_ELAPSED queries in flight, a gpu-bound frame is usually measured within this number of frames
+static const unsigned int gpuTimerQueries = 4;
+
+/**
+ * @brief The GL_TIME_ELAPSED queries of the canvas
+ *
+ * The queries are used as a ring: the query of a frame stays pending while the next frames are drawn,
+ * and it is read only when its result is available, so the cpu never waits for the gpu.
+ * A query is dropped only if it is still pending when the ring comes back to it.
+ */
+struct GLCanvas::GpuTimer {
+    typedef void (APIENTRY *GenQueries)(GLsizei, GLuint*);
+    typedef void (APIENTRY *DeleteQueries)(GLsizei, const GLuint*);
+    typedef void (APIENTRY *BeginQuery)(GLenum, GLuint);
+    typedef void (APIENTRY *EndQuery)(GLenum);
+    typedef void (APIENTRY *GetQueryObjectiv)(GLuint, GLenum, GLint*);
+    typedef void (APIENTRY *GetQueryObjectui64v)(GLuint, GLenum, uint64_t*);
+
+    GenQueries genQueries;
+    DeleteQueries deleteQueries;
+    BeginQuery beginQuery;
+    EndQuery endQuery;
+    GetQueryObjectiv getQueryObjectiv;
+    GetQueryObjectui64v getQueryObjectui64v;
+
+    GLuint queries[gpuTimerQueries];
+    bool pending[gpuTimerQueries];
+    unsigned long long frames[gpuTimerQueries];    //number of the frame measured by each query
+    unsigned int current;
+    unsigned long long frameNumber;                 //frames drawn since the initialization
+};
+
+template <class Function>
+static Function resolveGLFunction(const QGLContext* context, const char* name) {
+    return reinterpret_cast<Function>(context->getProcAddress(QString(name)));
+}
+
+GLCanvas::GLCanvas(QWidget * parent) : clearColor(Qt::white), frameHistorySize(300), performanceOverlayShown(false) {
     setParent(parent);
 }
 
+GLCanvas::~GLCanvas() {
+    if (gpuTimer) {
+        makeCurrent();
+        gpuTimer->deleteQueries(gpuTimerQueries, gpuTimer->queries);
+    }
+}
+
 void GLCanvas::init() {
     setFPSIsDisplayed(true);
     camera()->frame()->setSpinningSensitivity(100.0);
+
+    //timer queries are core in OpenGL 3.3, before they need GL_ARB_timer_query
+    const char* version = (const char*)glGetString(GL_VERSION);
+    const char* extensions = (const char*)glGetString(GL_EXTENSIONS);
+    int major = 0, minor = 0;
+    if (version != nullptr)
+        std::sscanf(version, "%d.%d", &major, &minor);
+
+    if (major > 3 || (major == 3 && minor >= 3) || (extensions != nullptr && std::strstr(extensions, "GL_ARB_timer_query") != nullptr)) {
+        gpuTimer.reset(new GpuTimer());
+        gpuTimer->genQueries = resolveGLFunction<GpuTimer::GenQueries>(context(), "glGenQueries");
+        gpuTimer->deleteQueries = resolveGLFunction<GpuTimer::DeleteQueries>(context(), "glDeleteQueries");
+        gpuTimer->beginQuery = resolveGLFunction<GpuTimer::BeginQuery>(context(), "glBeginQuery");
+        gpuTimer->endQuery = resolveGLFunction<GpuTimer::EndQuery>(context(), "glEndQuery");
+        gpuTimer->getQueryObjectiv = resolveGLFunction<GpuTimer::GetQueryObjectiv>(context(), "glGetQueryObjectiv");
+        gpuTimer->getQueryObjectui64v = resolveGLFunction<GpuTimer::GetQueryObjectui64v>(context(), "glGetQueryObjectui64v");
+
+        if (gpuTimer->genQueries && gpuTimer->deleteQueries && gpuTimer->beginQuery && gpuTimer->endQuery &&
+                gpuTimer->getQueryObjectiv && gpuTimer->getQueryObjectui64v) {
+            gpuTimer->genQueries(gpuTimerQueries, gpuTimer->queries);
+            for (unsigned int i = 0; i < gpuTimerQueries; ++i)
+                gpuTimer->pending[i] = false;
+            gpuTimer->current = 0;
+            gpuTimer->frameNumber = 0;
+        }
+        else {
+            gpuTimer.reset();
+        }
+    }
 }
 
+/**
+ * @brief GLCanvas::draw
+ *
+ * Draws the visible objects and records the statistics of the frame:
+ * the cpu time of each object, the draw calls and the gpu time, if the timer queries are supported.
+ */
 void GLCanvas::draw() {
+    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    resetDrawCallCounters();
+
+    if (gpuTimer)
+        gpuTimer->beginQuery(GL_TIME_ELAPSED, gpuTimer->queries[gpuTimer->current]);
+
     setBackgroundColor(clearColor);
 
+    FrameStatistics statistics;
+    statistics.drawableTimes.resize(drawlist.size(), 0);
     for(unsigned int i=0; i<drawlist.size(); ++i) {
-        if (objVisibility[i])
+        if (objVisibility[i]) {
+            std::chrono::steady_clock::time_point drawStart = std::chrono::steady_clock::now();
             drawlist[i]->draw();
+            statistics.drawableTimes[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - drawStart).count();
+        }
+    }
+
+    if (gpuTimer) {
+        gpuTimer->endQuery(GL_TIME_ELAPSED);
+        gpuTimer->pending[gpuTimer->current] = true;
+        gpuTimer->frames[gpuTimer->current] = gpuTimer->frameNumber++;
+        gpuTimer->current = (gpuTimer->current + 1) % gpuTimerQueries;
     }
+
+    readDrawCallCounters(statistics);
+    statistics.cpuTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - frameStart).count();
+
+    frameHistory.push_back(statistics);
+    while (frameHistory.size() > frameHistorySize)
+        frameHistory.pop_front();
+
+    if (gpuTimer)
+        readGpuTimes();
+}
+
+/**
+ * @brief GLCanvas::readGpuTimes
+ *
+ * Stores in the frame history the gpu times of the queries whose result is available.
+ * The queries end in the order they were issued, so they are read from the oldest
+ * and the first one not available stops the reading.
+ */
+void GLCanvas::readGpuTimes() {
+    for (unsigned int i = 0; i < gpuTimerQueries; ++i) {
+        unsigned int query = (gpuTimer->current + i) % gpuTimerQueries;
+        if (!gpuTimer->pending[query])
+            continue;
+
+        GLint available = 0;
+        gpuTimer->getQueryObjectiv(gpuTimer->queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+            break;
+
+        uint64_t elapsed = 0;
+        gpuTimer->getQueryObjectui64v(gpuTimer->queries[query], GL_QUERY_RESULT, &elapsed);
+        gpuTimer->pending[query] = false;
+
+        //the frame may have left the history
+        unsigned long long age = gpuTimer->frameNumber - gpuTimer->frames[query];
+        if (age <= frameHistory.size())
+            frameHistory[frameHistory.size() - age].gpuTime = elapsed * 1e-9;
+    }
+}
+
+void GLCanvas::postDraw() {
+    QGLViewer::postDraw();
+
+    if (performanceOverlayShown)
+        drawPerformanceOverlay();
 }
 
 void GLCanvas::drawWithNames() {
@@ -240,6 +401,131 @@ int GLCanvas::getNumberVisibleObjects() const {
     return count;
 }
 
+/**
+ * @brief GLCanvas::setPerformanceOverlayShown
+ *
+ * Shows or hides the statistics of the last frame and the graph of the frame times over the scene.
+ * The statistics are recorded even if the overlay is hidden.
+ *
+ * @param shown: true to show the overlay
+ */
+void GLCanvas::setPerformanceOverlayShown(bool shown) {
+    performanceOverlayShown = shown;
+    update();
+}
+
+bool GLCanvas::isPerformanceOverlayShown() const {
+    return performanceOverlayShown;
+}
+
+/**
+ * @brief GLCanvas::setFrameHistorySize
+ * @param size: the number of frames kept in the history, at least 1
+ */
+void GLCanvas::setFrameHistorySize(unsigned int size) {
+    frameHistorySize = std::max(size, 1u);
+    while (frameHistory.size() > frameHistorySize)
+        frameHistory.pop_front();
+}
+
+/**
+ * @brief GLCanvas::getFrameHistory
+ * @return the statistics of the last frames, from the oldest to the newest.
+ * The gpu time of the newest frame is available only after the next frame is drawn.
+ */
+const std::deque<FrameStatistics>& GLCanvas::getFrameHistory() const {
+    return frameHistory;
+}
+
+FrameStatistics GLCanvas::getLastFrameStatistics() const {
+    if (frameHistory.empty())
+        return FrameStatistics();
+    return frameHistory.back();
+}
+
+void GLCanvas::clearFrameHistory() {
+    frameHistory.clear();
+}
+
+/**
+ * @brief GLCanvas::drawPerformanceOverlay
+ *
+ * Writes the statistics of the last frame and the mean and maximum times of the history,
+ * then draws a graph of the history with a column for the cpu time of each frame and a point for its gpu time.
+ * The overlay is drawn after the statistics of the frame are recorded, so it is not counted.
+ */
+void GLCanvas::drawPerformanceOverlay() {
+    if (frameHistory.empty())
+        return;
+
+    const FrameStatistics& last = frameHistory.back();
+
+    double meanCpuTime = 0, maxCpuTime = 0, maxGpuTime = 0, lastGpuTime = -1;
+    for (const FrameStatistics& frame : frameHistory) {
+        meanCpuTime += frame.cpuTime;
+        maxCpuTime = std::max(maxCpuTime, frame.cpuTime);
+        maxGpuTime = std::max(maxGpuTime, frame.gpuTime);
+        if (frame.gpuTime >= 0)
+            lastGpuTime = frame.gpuTime;
+    }
+    meanCpuTime /= frameHistory.size();
+
+    glPushAttrib(GL_ALL_ATTRIB_BITS);
+    glDisable(GL_LIGHTING);
+    glDisable(GL_DEPTH_TEST);
+    qglColor(foregroundColor());
+
+    const int left = 10, lineHeight = 15;
+    int y = 40;
+    drawText(left, y, QString("CPU %1 ms (mean %2, max %3)").arg(last.cpuTime * 1000, 0, 'f', 2)
+             .arg(meanCpuTime * 1000, 0, 'f', 2).arg(maxCpuTime * 1000, 0, 'f', 2));
+    y += lineHeight;
+    drawText(left, y, lastGpuTime >= 0 ? QString("GPU %1 ms (max %2)").arg(lastGpuTime * 1000, 0, 'f', 2).arg(maxGpuTime * 1000, 0, 'f', 2) : QString("GPU n/a"));
+    y += lineHeight;
+    drawText(left, y, QString("%1 draw calls, %2 primitives, %3 MB uploaded").arg(last.drawCalls).arg(last.primitives)
+             .arg(last.uploadedBytes / 1048576.0, 0, 'f', 1));
+    y += lineHeight;
+    for (unsigned int i = 0; i < last.drawableTimes.size(); ++i) {
+        if (last.drawableTimes[i] > 0) {
+            drawText(left, y, QString("Object %1: %2 ms").arg(i).arg(last.drawableTimes[i] * 1000, 0, 'f', 2));
+            y += lineHeight;
+        }
+    }
+
+    //graph of the history, scaled on the slowest frame
+    double scale = std::max(maxCpuTime, maxGpuTime);
+    if (scale > 0) {
+        const int graphHeight = 60;
+        const int bottom = height() - 10;
+
+        drawText(left, bottom - graphHeight - 5, QString("%1 ms").arg(scale * 1000, 0, 'f', 2));
+
+        startScreenCoordinatesSystem();
+
+        glLineWidth(1);
+        glColor3f(0.2f, 0.4f, 1.0f);
+        glBegin(GL_LINES);
+        for (unsigned int i = 0; i < frameHistory.size(); ++i) {
+            glVertex2i(left + int(i), bottom);
+            glVertex2i(left + int(i), bottom - int(frameHistory[i].cpuTime / scale * graphHeight));
+        }
+        glEnd();
+
+        glPointSize(2);
+        glColor3f(1.0f, 0.4f, 0.0f);
+        glBegin(GL_POINTS);
+        for (unsigned int i = 0; i < frameHistory.size(); ++i) {
+            if (frameHistory[i].gpuTime >= 0)
+                glVertex2i(left + int(i), bottom - int(frameHistory[i].gpuTime / scale * graphHeight));
+        }
+        glEnd();
+
+        stopScreenCoordinatesSystem();
+    }
+
+    glPopAttrib();
+}
+
 }
 
 }
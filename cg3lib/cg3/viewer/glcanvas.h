@@ -23,12 +23,16 @@
 #include <QGLViewer/manipulatedCameraFrame.h>
 #include <QGLWidget>
 #include <QKeyEvent>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <vector>
 
 #include <cg3/geometry/bounding_box.h>
 #include <cg3/geometry/2d/point2d.h>
 #include "interfaces/drawable_object.h"
 #include "interfaces/pickable_object.h"
+#include "utilities/render_statistics.h"
 #include <qmessagebox.h>
 
 namespace cg3 {
@@ -42,10 +46,12 @@ class GLCanvas : public QGLViewer {
     public:
 
         GLCanvas(QWidget * parent = nullptr);
+        ~GLCanvas();
 
         //QGLViewer Override:
         void init();
         void draw();
+        void postDraw();
         void drawWithNames();
         void postSelection(const QPoint& point);
 
@@ -68,6 +74,14 @@ class GLCanvas : public QGLViewer {
         void savePointOfView(const std::string& filename);
         bool loadPointOfView(const std::string& filename);
 
+        //Performance statistics:
+        void setPerformanceOverlayShown(bool shown);
+        bool isPerformanceOverlayShown() const;
+        void setFrameHistorySize(unsigned int size);
+        const std::deque<FrameStatistics>& getFrameHistory() const;
+        FrameStatistics getLastFrameStatistics() const;
+        void clearFrameHistory();
+
     signals:
         void objectPicked(unsigned int);
         void point2DClicked(cg3::Point2Dd);
@@ -78,6 +92,18 @@ class GLCanvas : public QGLViewer {
         std::vector<bool> objVisibility;
 
         qglviewer::Vec orig, dir, selectedPoint;
+
+        //GL_ARB_timer_query queries, resolved at runtime since they are not in the OpenGL 1.1 headers
+        struct GpuTimer;
+        std::unique_ptr<GpuTimer> gpuTimer;
+
+        //statistics of the last frames, the gpu time of a frame is read some frames later, when its query is available
+        std::deque<FrameStatistics> frameHistory;
+        unsigned int frameHistorySize;
+        bool performanceOverlayShown;
+
+        void readGpuTimes();
+        void drawPerformanceOverlay();
 };
 
 }
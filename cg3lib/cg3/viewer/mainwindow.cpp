@@ -166,6 +166,14 @@ void MainWindow::setBackgroundColor(const QColor & color) {
     ui->glCanvas->setClearColor(color);
 }
 
+void MainWindow::setPerformanceOverlayShown(bool b) {
+    ui->glCanvas->setPerformanceOverlayShown(b);
+}
+
+const std::deque<FrameStatistics>& MainWindow::getFrameHistory() const {
+    return ui->glCanvas->getFrameHistory();
+}
+
 void MainWindow::set2DMode(bool b) {
     if (b != mode2D){
         ui->action2D_Mode->setEnabled(mode2D);
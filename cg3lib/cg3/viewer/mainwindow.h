@@ -25,6 +25,7 @@
 #pragma clang diagnostic pop
 #endif
 #include <QApplication>
+#include <deque>
 
 #include "interfaces/drawable_object.h"
 #include "interfaces/pickable_object.h"
@@ -32,6 +33,7 @@
 #include <cg3/geometry/bounding_box.h>
 #include "drawable_objects/drawable_objects.h"
 #include "utilities/consolestream.h"
+#include "utilities/render_statistics.h"
 #include <cg3/geometry/2d/point2d.h>
 
 namespace cg3 {
@@ -75,6 +77,8 @@ class MainWindow : public QMainWindow {
         void loadPointOfView(std::string filename);
         void setBackgroundColor(const QColor &);
         void set2DMode(bool b = true);
+        void setPerformanceOverlayShown(bool b);
+        const std::deque<FrameStatistics>& getFrameHistory() const;
 
         //DrawableObjects for the Canvas
         void pushObj(const cg3::DrawableObject * obj, std::string checkBoxName, bool b = true);
@@ -22,6 +22,7 @@
 
 #include <QColor>
 #include <cg3/geometry/2d/point2d.h>
+#include "../vertex_arrays.h"
 
 namespace cg3 {
 
@@ -40,6 +41,27 @@ static inline void drawQuad2D(const std::array<Point2Dd, 4>& arr, const QColor&
 
 static inline void drawQuad2D(const Point2Dd& p1, const Point2Dd& p2, const Point2Dd& p3, const Point2Dd& p4, const QColor& c, int width = 3, bool fill = false);
 
+static inline void drawPoints2D(const std::vector<double>& coordinates, const QColor& c, int size = 8);
+
+static inline void drawPoints2D(const std::vector<double>& coordinates, const std::vector<float>& colors, int size = 8);
+
+template <size_t N>
+static inline void drawPoints2D(const std::array<double, N>& coordinates, const QColor& c, int size = 8);
+
+static inline void drawLines2D(const std::vector<double>& coordinates, const QColor& c, int width = 3);
+
+static inline void drawLines2D(const std::vector<double>& coordinates, const std::vector<float>& colors, int width = 3);
+
+template <size_t N>
+static inline void drawLines2D(const std::array<double, N>& coordinates, const QColor& c, int width = 3);
+
+static inline void drawTriangles2D(const std::vector<double>& coordinates, const QColor& c, int width = 3, bool fill = false);
+
+static inline void drawTriangles2D(const std::vector<double>& coordinates, const std::vector<float>& colors, int width = 3, bool fill = false);
+
+template <size_t N>
+static inline void drawTriangles2D(const std::array<double, N>& coordinates, const QColor& c, int width = 3, bool fill = false);
+
 }
 
 }
@@ -96,3 +96,145 @@ static inline void cg3::viewer::drawQuad2D(const Point2Dd &p1, const Point2Dd &p
     std::array<Point2Dd, 4> arr = {p1, p2, p3, p4};
     cg3::viewer::drawQuad2D(arr, c, width, fill);
 }
+
+/**
+ * @brief Viewer::drawPoints2D
+ *
+ * Draws many points on the plane (coord z = 0 if 3D) with a single draw call.
+ *
+ * @param coordinates: x, y coordinates of the points
+ * @param c: color of the points
+ * @param size: size of the points (default: 8)
+ */
+static inline void cg3::viewer::drawPoints2D(const std::vector<double>& coordinates, const QColor& c, int size) {
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(size);
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawVertexArrays(GL_POINTS, 2, coordinates, nullptr);
+}
+
+/**
+ * @brief Viewer::drawPoints2D
+ *
+ * Draws many points on the plane (coord z = 0 if 3D), each one with its color, with a single draw call.
+ *
+ * @param coordinates: x, y coordinates of the points
+ * @param colors: r, g, b components (between 0 and 1) of each point
+ * @param size: size of the points (default: 8)
+ */
+static inline void cg3::viewer::drawPoints2D(const std::vector<double>& coordinates, const std::vector<float>& colors, int size) {
+    assert(colors.size() / 3 == coordinates.size() / 2);
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(size);
+    internal::drawVertexArrays(GL_POINTS, 2, coordinates, colors.data());
+}
+
+/**
+ * @brief Viewer::drawPoints2D
+ *
+ * Draws a fixed number of points on the plane (coord z = 0 if 3D) with a single draw call,
+ * without allocating a buffer.
+ *
+ * @param coordinates: x, y coordinates of the points
+ * @param c: color of the points
+ * @param size: size of the points (default: 8)
+ */
+template <size_t N>
+static inline void cg3::viewer::drawPoints2D(const std::array<double, N>& coordinates, const QColor& c, int size) {
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(size);
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawVertexArrays(GL_POINTS, 2, coordinates.data(), N, nullptr);
+}
+
+/**
+ * @brief Viewer::drawLines2D
+ *
+ * Draws many lines on the plane (z=0 if 3D) with a single draw call.
+ *
+ * @param coordinates: x, y coordinates of the two endpoints of each line
+ * @param c: color of the lines
+ * @param width: width of the lines (default: 3)
+ */
+static inline void cg3::viewer::drawLines2D(const std::vector<double>& coordinates, const QColor& c, int width) {
+    glLineWidth(width);
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawVertexArrays(GL_LINES, 2, coordinates, nullptr);
+}
+
+/**
+ * @brief Viewer::drawLines2D
+ *
+ * Draws many lines on the plane (z=0 if 3D) with a single draw call, the color is interpolated between the endpoints.
+ *
+ * @param coordinates: x, y coordinates of the two endpoints of each line
+ * @param colors: r, g, b components (between 0 and 1) of each endpoint
+ * @param width: width of the lines (default: 3)
+ */
+static inline void cg3::viewer::drawLines2D(const std::vector<double>& coordinates, const std::vector<float>& colors, int width) {
+    assert(colors.size() / 3 == coordinates.size() / 2);
+    glLineWidth(width);
+    internal::drawVertexArrays(GL_LINES, 2, coordinates, colors.data());
+}
+
+/**
+ * @brief Viewer::drawLines2D
+ *
+ * Draws a fixed number of lines on the plane (z=0 if 3D) with a single draw call, without allocating a buffer.
+ *
+ * @param coordinates: x, y coordinates of the two endpoints of each line
+ * @param c: color of the lines
+ * @param width: width of the lines (default: 3)
+ */
+template <size_t N>
+static inline void cg3::viewer::drawLines2D(const std::array<double, N>& coordinates, const QColor& c, int width) {
+    glLineWidth(width);
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawVertexArrays(GL_LINES, 2, coordinates.data(), N, nullptr);
+}
+
+/**
+ * @brief Viewer::drawTriangles2D
+ *
+ * Draws many triangles on the plane (z=0 if 3D), the outlines and the interiors with a single draw call each.
+ *
+ * @param coordinates: x, y coordinates of the three vertices of each triangle
+ * @param c: color of the triangles
+ * @param width: width of the outlines, 0 to draw no outline (default: 3)
+ * @param fill: true to fill the triangles (default: false)
+ */
+static inline void cg3::viewer::drawTriangles2D(const std::vector<double>& coordinates, const QColor& c, int width, bool fill) {
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawTriangleArrays(2, coordinates, nullptr, width, fill);
+}
+
+/**
+ * @brief Viewer::drawTriangles2D
+ *
+ * Draws many triangles on the plane (z=0 if 3D), each vertex with its color.
+ *
+ * @param coordinates: x, y coordinates of the three vertices of each triangle
+ * @param colors: r, g, b components (between 0 and 1) of each vertex
+ * @param width: width of the outlines, 0 to draw no outline (default: 3)
+ * @param fill: true to fill the triangles (default: false)
+ */
+static inline void cg3::viewer::drawTriangles2D(const std::vector<double>& coordinates, const std::vector<float>& colors, int width, bool fill) {
+    assert(colors.size() / 3 == coordinates.size() / 2);
+    internal::drawTriangleArrays(2, coordinates, colors.data(), width, fill);
+}
+
+/**
+ * @brief Viewer::drawTriangles2D
+ *
+ * Draws a fixed number of triangles on the plane (z=0 if 3D) without allocating a buffer.
+ *
+ * @param coordinates: x, y coordinates of the three vertices of each triangle
+ * @param c: color of the triangles
+ * @param width: width of the outlines, 0 to draw no outline (default: 3)
+ * @param fill: true to fill the triangles (default: false)
+ */
+template <size_t N>
+static inline void cg3::viewer::drawTriangles2D(const std::array<double, N>& coordinates, const QColor& c, int width, bool fill) {
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawTriangleArrays(2, coordinates.data(), N, nullptr, width, fill);
+}
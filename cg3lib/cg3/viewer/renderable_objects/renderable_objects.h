@@ -22,6 +22,7 @@
 
 #include <QColor>
 #include <cg3/geometry/point.h>
+#include "vertex_arrays.h"
 
 namespace cg3 {
 
@@ -47,6 +48,18 @@ static inline void drawBox(const std::vector<Pointd> &p, const QColor& c, int wi
 
 static inline void drawBox(const Pointd &p0, const Pointd &p1, const Pointd &p2, const Pointd &p3, const Pointd &p4, const Pointd &p5, const Pointd &p6, const Pointd &p7, const QColor& c, int width = 3);
 
+static inline void drawPoints(const std::vector<double>& coordinates, const QColor& c, int size = 8);
+
+static inline void drawPoints(const std::vector<double>& coordinates, const std::vector<float>& colors, int size = 8);
+
+static inline void drawLines(const std::vector<double>& coordinates, const QColor& c, int width = 3);
+
+static inline void drawLines(const std::vector<double>& coordinates, const std::vector<float>& colors, int width = 3);
+
+static inline void drawTriangles(const std::vector<double>& coordinates, const QColor& c, int width = 3, bool fill = false);
+
+static inline void drawTriangles(const std::vector<double>& coordinates, const std::vector<float>& colors, int width = 3, bool fill = false);
+
 }
 
 }
@@ -233,4 +233,96 @@ static inline void viewer::drawBox(const Pointd &p0, const Pointd &p1, const Poi
     drawLine(p3, p7, c, width);
 }
 
+/**
+ * @brief Viewer::drawPoints
+ *
+ * Draws many points with a single draw call.
+ *
+ * @param coordinates: x, y, z coordinates of the points
+ * @param c: color of the points
+ * @param size: size of the points (default: 8)
+ */
+static inline void viewer::drawPoints(const std::vector<double>& coordinates, const QColor& c, int size) {
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(size);
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawVertexArrays(GL_POINTS, 3, coordinates, nullptr);
+}
+
+/**
+ * @brief Viewer::drawPoints
+ *
+ * Draws many points, each one with its color, with a single draw call.
+ *
+ * @param coordinates: x, y, z coordinates of the points
+ * @param colors: r, g, b components (between 0 and 1) of each point
+ * @param size: size of the points (default: 8)
+ */
+static inline void viewer::drawPoints(const std::vector<double>& coordinates, const std::vector<float>& colors, int size) {
+    assert(colors.size() == coordinates.size());
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(size);
+    internal::drawVertexArrays(GL_POINTS, 3, coordinates, colors.data());
+}
+
+/**
+ * @brief Viewer::drawLines
+ *
+ * Draws many lines with a single draw call.
+ *
+ * @param coordinates: x, y, z coordinates of the two endpoints of each line
+ * @param c: color of the lines
+ * @param width: width of the lines (default: 3)
+ */
+static inline void viewer::drawLines(const std::vector<double>& coordinates, const QColor& c, int width) {
+    glLineWidth(width);
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawVertexArrays(GL_LINES, 3, coordinates, nullptr);
+}
+
+/**
+ * @brief Viewer::drawLines
+ *
+ * Draws many lines with a single draw call, the color is interpolated between the endpoints.
+ *
+ * @param coordinates: x, y, z coordinates of the two endpoints of each line
+ * @param colors: r, g, b components (between 0 and 1) of each endpoint
+ * @param width: width of the lines (default: 3)
+ */
+static inline void viewer::drawLines(const std::vector<double>& coordinates, const std::vector<float>& colors, int width) {
+    assert(colors.size() == coordinates.size());
+    glLineWidth(width);
+    internal::drawVertexArrays(GL_LINES, 3, coordinates, colors.data());
+}
+
+/**
+ * @brief Viewer::drawTriangles
+ *
+ * Draws many triangles, the outlines and the interiors with a single draw call each.
+ *
+ * @param coordinates: x, y, z coordinates of the three vertices of each triangle
+ * @param c: color of the triangles
+ * @param width: width of the outlines, 0 to draw no outline (default: 3)
+ * @param fill: true to fill the triangles (default: false)
+ */
+static inline void viewer::drawTriangles(const std::vector<double>& coordinates, const QColor& c, int width, bool fill) {
+    glColor3f(c.redF(), c.greenF(), c.blueF());
+    internal::drawTriangleArrays(3, coordinates, nullptr, width, fill);
+}
+
+/**
+ * @brief Viewer::drawTriangles
+ *
+ * Draws many triangles, each vertex with its color.
+ *
+ * @param coordinates: x, y, z coordinates of the three vertices of each triangle
+ * @param colors: r, g, b components (between 0 and 1) of each vertex
+ * @param width: width of the outlines, 0 to draw no outline (default: 3)
+ * @param fill: true to fill the triangles (default: false)
+ */
+static inline void viewer::drawTriangles(const std::vector<double>& coordinates, const std::vector<float>& colors, int width, bool fill) {
+    assert(colors.size() == coordinates.size());
+    internal::drawTriangleArrays(3, coordinates, colors.data(), width, fill);
+}
+
 }
@@ -0,0 +1,45 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+
+#ifndef CG3_VERTEX_ARRAYS_H
+#define CG3_VERTEX_ARRAYS_H
+
+#ifdef WIN32
+#include "windows.h"
+#endif
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <vector>
+
+#include "../utilities/render_statistics.h"
+
+namespace cg3 {
+
+namespace viewer {
+
+namespace internal {
+
+static inline void drawVertexArrays(GLenum mode, GLint dimension, const double* coordinates, size_t size, const float* colors);
+
+static inline void drawVertexArrays(GLenum mode, GLint dimension, const std::vector<double>& coordinates, const float* colors);
+
+static inline void drawTriangleArrays(GLint dimension, const double* coordinates, size_t size, const float* colors, int width, bool fill);
+
+static inline void drawTriangleArrays(GLint dimension, const std::vector<double>& coordinates, const float* colors, int width, bool fill);
+
+}
+
+}
+
+}
+
+#include "vertex_arrays.tpp"
+
+#endif // CG3_VERTEX_ARRAYS_H
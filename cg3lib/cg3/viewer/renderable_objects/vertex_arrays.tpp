@@ -0,0 +1,80 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+
+#include "vertex_arrays.h"
+
+/**
+ * @brief internal::drawVertexArrays
+ *
+ * Draws all the primitives stored in the coordinate buffer with a single draw call.
+ * The client state is saved and restored, so it can be called between other vertex array draws;
+ * with a color array also the current color is restored, since the array leaves it undefined.
+ *
+ * @param mode: the OpenGL primitive (GL_POINTS, GL_LINES, GL_TRIANGLES...)
+ * @param dimension: number of coordinates of each vertex (2 or 3)
+ * @param coordinates: coordinates of the vertices
+ * @param size: number of coordinates
+ * @param colors: r, g, b components of each vertex, nullptr to use the current color
+ */
+static inline void cg3::viewer::internal::drawVertexArrays(GLenum mode, GLint dimension, const double* coordinates, size_t size, const float* colors) {
+    if (size < (size_t)dimension)
+        return;
+
+    glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(dimension, GL_DOUBLE, 0, coordinates);
+
+    if (colors != nullptr) {
+        glPushAttrib(GL_CURRENT_BIT);
+        glEnableClientState(GL_COLOR_ARRAY);
+        glColorPointer(3, GL_FLOAT, 0, colors);
+    }
+
+    GLsizei count = (GLsizei)(size / dimension);
+    glDrawArrays(mode, 0, count);
+    recordDrawCall(mode, count, count * (dimension * sizeof(double) + (colors != nullptr ? 3 * sizeof(float) : 0)));
+
+    if (colors != nullptr)
+        glPopAttrib();
+    glPopClientAttrib();
+}
+
+static inline void cg3::viewer::internal::drawVertexArrays(GLenum mode, GLint dimension, const std::vector<double>& coordinates, const float* colors) {
+    drawVertexArrays(mode, dimension, coordinates.data(), coordinates.size(), colors);
+}
+
+/**
+ * @brief internal::drawTriangleArrays
+ *
+ * Draws the outlines of the triangles (if width is not 0) and their interiors (if fill is true),
+ * each with a single draw call: the outlines are drawn by setting the polygon mode to lines.
+ *
+ * @param dimension: number of coordinates of each vertex (2 or 3)
+ * @param coordinates: coordinates of the vertices, three vertices for each triangle
+ * @param size: number of coordinates
+ * @param colors: r, g, b components of each vertex, nullptr to use the current color
+ * @param width: width of the outlines
+ * @param fill: true to fill the triangles
+ */
+static inline void cg3::viewer::internal::drawTriangleArrays(GLint dimension, const double* coordinates, size_t size, const float* colors, int width, bool fill) {
+    glPushAttrib(GL_POLYGON_BIT | GL_LINE_BIT);
+
+    if (width != 0){
+        glLineWidth(width);
+        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+        drawVertexArrays(GL_TRIANGLES, dimension, coordinates, size, colors);
+    }
+    if (fill) {
+        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+        drawVertexArrays(GL_TRIANGLES, dimension, coordinates, size, colors);
+    }
+
+    glPopAttrib();
+}
+
+static inline void cg3::viewer::internal::drawTriangleArrays(GLint dimension, const std::vector<double>& coordinates, const float* colors, int width, bool fill) {
+    drawTriangleArrays(dimension, coordinates.data(), coordinates.size(), colors, width, fill);
+}
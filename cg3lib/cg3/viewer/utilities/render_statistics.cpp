@@ -0,0 +1,103 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+
+#include "render_statistics.h"
+
+namespace cg3 {
+
+namespace viewer {
+
+namespace internal {
+
+//counters of the frame being drawn, the canvas draws on the gui thread only
+static unsigned long drawCalls = 0;
+static unsigned long primitives = 0;
+static unsigned long long uploadedBytes = 0;
+
+}
+
+FrameStatistics::FrameStatistics() :
+    cpuTime(0), gpuTime(-1), drawCalls(0), primitives(0), uploadedBytes(0) {
+}
+
+/**
+ * @brief recordDrawCall
+ *
+ * Adds a draw call to the statistics of the current frame. It must be called next to each
+ * glDrawArrays/glDrawElements of the drawable objects.
+ *
+ * @param mode: the OpenGL primitive of the draw call
+ * @param count: the number of vertices (or indices) drawn
+ * @param bytes: the bytes of the client arrays read by the draw call
+ */
+void recordDrawCall(GLenum mode, GLsizei count, size_t bytes) {
+    internal::drawCalls++;
+    internal::primitives += getPrimitiveNumber(mode, count);
+    internal::uploadedBytes += bytes;
+}
+
+/**
+ * @brief resetDrawCallCounters
+ *
+ * Called by the canvas before drawing a frame.
+ */
+void resetDrawCallCounters() {
+    internal::drawCalls = 0;
+    internal::primitives = 0;
+    internal::uploadedBytes = 0;
+}
+
+/**
+ * @brief readDrawCallCounters
+ *
+ * Copies the counters of the frame into the statistics.
+ *
+ * @param statistics: the statistics of the frame
+ */
+void readDrawCallCounters(FrameStatistics& statistics) {
+    statistics.drawCalls = internal::drawCalls;
+    statistics.primitives = internal::primitives;
+    statistics.uploadedBytes = internal::uploadedBytes;
+}
+
+/**
+ * @brief getPrimitiveNumber
+ * @param mode: the OpenGL primitive
+ * @param count: the number of vertices
+ * @return the number of primitives assembled from count vertices
+ */
+unsigned long getPrimitiveNumber(GLenum mode, GLsizei count) {
+    if (count <= 0)
+        return 0;
+
+    unsigned long n = (unsigned long)count;
+    switch (mode) {
+        case GL_POINTS:
+            return n;
+        case GL_LINES:
+            return n / 2;
+        case GL_LINE_STRIP:
+            return n - 1;
+        case GL_LINE_LOOP:
+            return n;
+        case GL_TRIANGLES:
+            return n / 3;
+        case GL_TRIANGLE_STRIP:
+        case GL_TRIANGLE_FAN:
+            return n >= 3 ? n - 2 : 0;
+        case GL_POLYGON:
+            return n >= 3 ? 1 : 0;
+        case GL_QUADS:
+            return n / 4;
+        case GL_QUAD_STRIP:
+            return n >= 4 ? n / 2 - 1 : 0;
+        default:
+            return 0;
+    }
+}
+
+}
+
+}
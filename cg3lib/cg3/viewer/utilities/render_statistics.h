@@ -0,0 +1,57 @@
+/*
+ * This file is part of cg3lib: https://github.com/cg3hci/cg3lib
+ * This Source Code Form is subject to the terms of the GNU GPL 3.0
+ */
+
+#ifndef CG3_RENDER_STATISTICS_H
+#define CG3_RENDER_STATISTICS_H
+
+#ifdef WIN32
+#include "windows.h"
+#endif
+
+#ifdef __APPLE__
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <cstddef>
+#include <vector>
+
+namespace cg3 {
+
+namespace viewer {
+
+/**
+ * @brief The statistics of a frame drawn by the GLCanvas
+ *
+ * Draw calls, primitives and bytes are counted only for the draw calls recorded with recordDrawCall:
+ * the uploaded bytes are the bytes of the client arrays read by the draw calls, which the driver copies
+ * to the GPU at each frame. The indexed draw calls (glDrawElements) are counted as index count times
+ * the bytes of a vertex plus its index, so a vertex shared by several primitives is counted once for each
+ * of its indices: the uploaded bytes are an upper bound, the driver may copy only the referenced range.
+ */
+struct FrameStatistics {
+    double cpuTime;                     //seconds spent submitting the frame
+    double gpuTime;                     //seconds spent by the GPU on the frame, negative if not available
+    unsigned long drawCalls;
+    unsigned long primitives;
+    unsigned long long uploadedBytes;
+    std::vector<double> drawableTimes;  //cpu seconds of each drawable object, in drawing order, 0 if hidden
+
+    FrameStatistics();
+};
+
+void recordDrawCall(GLenum mode, GLsizei count, size_t bytes);
+
+void resetDrawCallCounters();
+void readDrawCallCounters(FrameStatistics& statistics);
+
+unsigned long getPrimitiveNumber(GLenum mode, GLsizei count);
+
+}
+
+}
+
+#endif // CG3_RENDER_STATISTICS_H
@@ -2,6 +2,8 @@
 
 #include <cg3lib/cg3/core/cg3/geometry/2d/utils2d.h>
 
+#include <algorithms/insertionstatistics.h>
+
 /**
  * @brief Adds node the dag and sets it as children of nodes p1 and p2
  * @param[in] value: the node to add
@@ -64,6 +66,15 @@ std::vector<Node> &DAG::getNodeList()
     return nodeList;
 }
 
+/**
+ * @brief Returns the list of nodes (read-only)
+ * @return nodeList: the list of nodes in the dag
+*/
+const std::vector<Node> &DAG::getNodeList() const
+{
+    return nodeList;
+}
+
 /**
  * @brief Searches the triangle containing the point using the dag
  * @param[in] i: the current node
@@ -72,9 +83,24 @@ std::vector<Node> &DAG::getNodeList()
  * @param[in] triangles: triangles of triangulation
 */
 int DAG::searchInNodes(const unsigned int i, const unsigned int length, const cg3::Point2Dd& point, const std::vector<Triangle>& triangles) const
+{
+    return searchFromNode(i, length, point, triangles, 0);
+}
+
+/**
+ * @brief Searches the triangle containing the point in the descendants of a node, counting the visited nodes and the depth of the leaf found
+ * @param[in] i: the current node
+ * @param[in] length: total nodes, used as base condition for recursion
+ * @param[in] point: last point inserted
+ * @param[in] triangles: triangles of triangulation
+ * @param[in] depth: depth of the current node, starting from the node where the search began
+*/
+int DAG::searchFromNode(const unsigned int i, const unsigned int length, const cg3::Point2Dd& point, const std::vector<Triangle>& triangles, const unsigned int depth) const
 {
     if(i < length)
     {
+        DelaunayTriangulation::countLocationStep();
+
         //get triangle index from the node
         unsigned int data = nodeList[i].getData();
 
@@ -87,6 +113,7 @@ int DAG::searchInNodes(const unsigned int i, const unsigned int length, const cg
         //if the point is inside and the triangle is a leaf, then return the index of the node in the dag
         if(flagInside && flagLeaf)
         {
+            DelaunayTriangulation::countLocationDepth(depth);
             return int(i);
         }
         //if the flag is false, the node can be a parent or the node doesn't contain the point
@@ -103,7 +130,7 @@ int DAG::searchInNodes(const unsigned int i, const unsigned int length, const cg
                 //search in children 1
                 if(child != noChild)
                 {
-                    result = searchInNodes(unsigned(child), length, point, triangles);
+                    result = searchFromNode(unsigned(child), length, point, triangles, depth + 1);
                     if(result != -1)
                     {
                         return result;
@@ -114,7 +141,7 @@ int DAG::searchInNodes(const unsigned int i, const unsigned int length, const cg
                 //search in children 2
                 if(child != noChild)
                 {
-                    result = searchInNodes(unsigned(child), length, point, triangles);
+                    result = searchFromNode(unsigned(child), length, point, triangles, depth + 1);
                     if(result != -1)
                     {
                         return result;
@@ -125,7 +152,7 @@ int DAG::searchInNodes(const unsigned int i, const unsigned int length, const cg
                 //search in children 3
                 if(child != noChild)
                 {
-                    result = searchInNodes(unsigned(child), length, point, triangles);
+                    result = searchFromNode(unsigned(child), length, point, triangles, depth + 1);
                     if(result != -1)
                     {
                         return result;
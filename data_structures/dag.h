@@ -28,10 +28,13 @@ public:
     void clearDataStructure();
 
     std::vector<Node>& getNodeList();
+    const std::vector<Node>& getNodeList() const;
 
     int searchInNodes(const unsigned int i, const unsigned int length, const cg3::Point2Dd& point, const std::vector<Triangle>& triangles) const;
 
 private:
+    int searchFromNode(const unsigned int i, const unsigned int length, const cg3::Point2Dd& point, const std::vector<Triangle>& triangles, const unsigned int depth) const;
+
     std::vector<Node> nodeList;
 };
 
@@ -1,9 +1,28 @@
 #include "triangulation.h"
 
+#include <atomic>
+#include <utility>
+
+namespace {
+
+//last identifier given to a triangulation, shared by all the triangulations
+std::atomic<uint32_t> lastIdentifier(0);
+
+/**
+ * @brief Returns an identifier never given to another triangulation
+ * @return identifier: the new identifier
+*/
+uint32_t newIdentifier()
+{
+    return ++lastIdentifier;
+}
+
+}
+
 /**
  * @brief Default constructor
 */
-Triangulation::Triangulation() {}
+Triangulation::Triangulation() : identifier(newIdentifier()), changes(0) {}
 
 /**
  * @brief Creates a triangulation from triangles and adjacencies
@@ -12,7 +31,53 @@ Triangulation::Triangulation() {}
 */
 Triangulation::Triangulation(const std::vector<Triangle> &triangles,
                              const std::vector<std::array<int, maxAdjacentTriangles> > &adjacencies)
-    : triangles(triangles), adjacencies(adjacencies) {}
+    : triangles(triangles), adjacencies(adjacencies), identifier(newIdentifier()), changes(0) {}
+
+/**
+ * @brief Copy constructor, the copy takes a new identifier
+ * @param[in] other: the copied triangulation
+*/
+Triangulation::Triangulation(const Triangulation& other)
+    : triangles(other.triangles), adjacencies(other.adjacencies), identifier(newIdentifier()), changes(0) {}
+
+/**
+ * @brief Move constructor, the new triangulation takes a new identifier and the moved one a new version
+ * @param[in] other: the moved triangulation
+*/
+Triangulation::Triangulation(Triangulation&& other)
+    : triangles(std::move(other.triangles)), adjacencies(std::move(other.adjacencies)), identifier(newIdentifier()), changes(0)
+{
+    other.markChanged();
+}
+
+/**
+ * @brief Copy assignment, the triangulation takes a new identifier
+ * @param[in] other: the copied triangulation
+ * @return triangulation: this triangulation
+*/
+Triangulation& Triangulation::operator=(const Triangulation& other)
+{
+    triangles = other.triangles;
+    adjacencies = other.adjacencies;
+    identifier = newIdentifier();
+    changes = 0;
+    return *this;
+}
+
+/**
+ * @brief Move assignment, the triangulation takes a new identifier and the moved one a new version
+ * @param[in] other: the moved triangulation
+ * @return triangulation: this triangulation
+*/
+Triangulation& Triangulation::operator=(Triangulation&& other)
+{
+    triangles = std::move(other.triangles);
+    adjacencies = std::move(other.adjacencies);
+    identifier = newIdentifier();
+    changes = 0;
+    other.markChanged();
+    return *this;
+}
 
 /**
  * @brief Add a triangle to the triangulation
@@ -21,6 +86,7 @@ Triangulation::Triangulation(const std::vector<Triangle> &triangles,
 void Triangulation::addTriangle(const Triangle& triangle)
 {
     triangles.push_back(triangle);
+    markChanged();
 }
 
 /**
@@ -32,6 +98,15 @@ std::vector<Triangle>& Triangulation::getTriangles()
     return triangles;
 }
 
+/**
+ * @brief Returns the triangles of the triangulation (read-only)
+ * @return triangles: the array of triangles
+*/
+const std::vector<Triangle>& Triangulation::getTriangles() const
+{
+    return triangles;
+}
+
 /**
  * @brief Returns the adjacencies of the triangle
  * @param[in] triangle: the index of the triangle
@@ -42,6 +117,25 @@ std::array<int, maxAdjacentTriangles>& Triangulation::getAdjacenciesFromTriangle
     return adjacencies[triangle];
 }
 
+/**
+ * @brief Returns the adjacencies of the triangle (read-only)
+ * @param[in] triangle: the index of the triangle
+ * @return adjacencies: the array containing the adjacencies for the triangle
+*/
+const std::array<int, maxAdjacentTriangles>& Triangulation::getAdjacenciesFromTriangle(unsigned int triangle) const
+{
+    return adjacencies[triangle];
+}
+
+/**
+ * @brief Returns the adjacencies of all the triangles (read-only)
+ * @return adjacencies: the vector parallel to the triangles
+*/
+const std::vector<std::array<int, maxAdjacentTriangles>>& Triangulation::getAdjacencies() const
+{
+    return adjacencies;
+}
+
 /**
  * @brief Clears triangles and adjacencies but not the first triangle - bounding triangle
 */
@@ -56,6 +150,8 @@ void Triangulation::clearDataStructure()
     adjacencies.erase(adjacenciesIterator, adjacencies.end());
 
     //in this way we keep always the bounding triangle as first element
+
+    markChanged();
 }
 
 /**
@@ -67,6 +163,7 @@ void Triangulation::clearDataStructure()
 void Triangulation::addAdjacenciesForNewTriangle(int v1v2, int v2v3, int v3v1)
 {
     adjacencies.push_back({v1v2, v2v3, v3v1});
+    markChanged();
 }
 
 /**
@@ -204,3 +301,25 @@ int Triangulation::findAdjacency(unsigned int triangle, unsigned int adjacent)
     //return -1 if the adjacency was not found
     return noAdjacentTriangle;
 }
+
+/**
+ * @brief Returns the version of the triangulation
+ * @return version: a number that changes every time the triangulation changes
+*/
+unsigned long long Triangulation::getVersion() const
+{
+    return (uint64_t(identifier) << 32) | changes;
+}
+
+/**
+ * @brief Gives a new version to the triangulation, called by each method that changes it
+ *
+ * The counter is not shared, so this is not an atomic operation; when the counter wraps the triangulation takes a new identifier.
+*/
+void Triangulation::markChanged()
+{
+    if(++changes == 0)
+    {
+        identifier = newIdentifier();
+    }
+}
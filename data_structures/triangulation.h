@@ -1,6 +1,8 @@
 #ifndef TRIANGULATION_H
 #define TRIANGULATION_H
 
+#include <cstdint>
+
 #include <cg3/geometry/2d/point2d.h>
 #include "triangle.h"
 
@@ -27,6 +29,12 @@ const unsigned int v3v1Edge = 2;
  * the third overload picks two old parent triangle and it is used when the edge legalization produces two new triangles.
  * There is also another method that returns the edge where two triangles taken in input are adjacent
  * and a method for clearing the data structure without leaving the bounding triangle.
+ *
+ * Each change (new triangles and adjacencies, so insertions and flips, and clears) gives the triangulation a new version,
+ * used by the drawable objects to rebuild their data only when the triangulation changes.
+ * The version is made of an identifier, taken by each triangulation when it is created or assigned, and of a counter of the changes:
+ * versions are never reused, not even by different triangulations, so also a triangulation replaced by an assignment has a new version.
+ * Only the identifiers are shared by all the triangulations, so a change costs just an increment of the counter.
  */
 class Triangulation
 {
@@ -34,14 +42,22 @@ public:
     Triangulation();
     Triangulation(const std::vector<Triangle>& triangles,
                   const std::vector<std::array<int, maxAdjacentTriangles>>& adjacencies);
+    Triangulation(const Triangulation& other);
+    Triangulation(Triangulation&& other);
+
+    Triangulation& operator=(const Triangulation& other);
+    Triangulation& operator=(Triangulation&& other);
 
     //add a triangle to the triangulation
     void addTriangle(const Triangle& triangle);
 
     //get triangles
     std::vector<Triangle>& getTriangles();
+    const std::vector<Triangle>& getTriangles() const;
 
     std::array<int, maxAdjacentTriangles>& getAdjacenciesFromTriangle(unsigned int triangle);
+    const std::array<int, maxAdjacentTriangles>& getAdjacenciesFromTriangle(unsigned int triangle) const;
+    const std::vector<std::array<int, maxAdjacentTriangles>>& getAdjacencies() const;
 
     void clearDataStructure();
 
@@ -53,12 +69,22 @@ public:
 
     int findAdjacency(unsigned int triangle, unsigned int adjacent);
 
+    //get the version, it changes every time the triangulation changes
+    unsigned long long getVersion() const;
+
 protected:
     //triangles of the triangulation
     std::vector<Triangle> triangles;
 
     //adjacency of triangles
     std::vector<std::array<int, maxAdjacentTriangles> > adjacencies;
+
+    //version of the content: identifier of the triangulation and number of changes since it was taken
+    uint32_t identifier;
+    uint32_t changes;
+
+private:
+    void markChanged();
 };
 
 #endif // TRIANGULATION_H
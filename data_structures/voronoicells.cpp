@@ -0,0 +1,254 @@
+#include "voronoicells.h"
+
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Clips a convex polygon to an axis-aligned rectangle
+ *
+ * The polygon is clipped to one side of the rectangle at a time (Sutherland-Hodgman),
+ * the two buffers are swapped after each side so no memory is allocated once they are large enough.
+ * @param[in, out] polygon: x, y coordinates of the polygon, the clipped polygon at the end
+ * @param[out] buffer: working memory
+ * @param[in] min: lower left corner of the rectangle
+ * @param[in] max: upper right corner of the rectangle
+*/
+void clipPolygon(std::vector<double>& polygon, std::vector<double>& buffer, const cg3::Point2Dd& min, const cg3::Point2Dd& max)
+{
+    //coordinate (0 for x, 1 for y), limit and sign of the inside half-plane of each side
+    const unsigned int axes[4] = {0, 0, 1, 1};
+    const double limits[4] = {min.x(), max.x(), min.y(), max.y()};
+    const double signs[4] = {1, -1, 1, -1};
+
+    for(unsigned int side = 0; side < 4 && !polygon.empty(); side++)
+    {
+        buffer.clear();
+
+        size_t size = polygon.size() / 2;
+        for(size_t i = 0; i < size; i++)
+        {
+            size_t j = (i + 1) % size;
+
+            double first = signs[side] * (polygon[2 * i + axes[side]] - limits[side]);
+            double second = signs[side] * (polygon[2 * j + axes[side]] - limits[side]);
+
+            if(first >= 0)
+            {
+                buffer.push_back(polygon[2 * i]);
+                buffer.push_back(polygon[2 * i + 1]);
+            }
+
+            //the edge crosses the side
+            if((first >= 0) != (second >= 0))
+            {
+                double t = first / (first - second);
+                buffer.push_back(polygon[2 * i] + t * (polygon[2 * j] - polygon[2 * i]));
+                buffer.push_back(polygon[2 * i + 1] + t * (polygon[2 * j + 1] - polygon[2 * i + 1]));
+            }
+        }
+
+        polygon.swap(buffer);
+    }
+}
+
+/**
+ * @brief Computes the clipped cell of a site
+ * @param[in] diagram: the Voronoi diagram
+ * @param[in] site: index of the site
+ * @param[in] min: lower left corner of the rectangle
+ * @param[in] max: upper right corner of the rectangle
+ * @param[out] polygon: x, y coordinates of the clipped cell
+ * @param[out] vertices: working memory
+ * @param[out] neighbours: working memory
+ * @param[out] buffer: working memory
+*/
+void computeCell(const VoronoiDiagram& diagram, size_t site, const cg3::Point2Dd& min, const cg3::Point2Dd& max,
+                 std::vector<double>& polygon, std::vector<unsigned int>& vertices, std::vector<int>& neighbours, std::vector<double>& buffer)
+{
+    const std::vector<double>& vertexCoordinates = diagram.getVertexCoordinates();
+
+    diagram.getCell(site, vertices, neighbours);
+
+    polygon.clear();
+    for(unsigned int vertex : vertices)
+    {
+        polygon.push_back(vertexCoordinates[2 * vertex]);
+        polygon.push_back(vertexCoordinates[2 * vertex + 1]);
+    }
+
+    clipPolygon(polygon, buffer, min, max);
+}
+
+}
+
+/**
+ * @brief Creates an empty set of cells
+*/
+VoronoiCells::VoronoiCells() : offsets(1, 0) {}
+
+/**
+ * @brief Computes the cell of each site clipped to a rectangle
+ *
+ * The cells are computed in parallel twice: the first time to know the number of vertices, the area and the centroid of each cell,
+ * the second time to write the vertices at the offsets of the cells.
+ * Area and centroid are computed relative to the site, so they don't lose precision far from the origin.
+ * @param[in] diagram: the Voronoi diagram
+ * @param[in] min: lower left corner of the rectangle
+ * @param[in] max: upper right corner of the rectangle
+*/
+void VoronoiCells::build(const VoronoiDiagram& diagram, const cg3::Point2Dd& min, const cg3::Point2Dd& max)
+{
+    long long siteNumber = (long long)(diagram.getSiteNumber());
+    size_t length = size_t(siteNumber);
+
+    offsets.assign(length + 1, 0);
+    areas.resize(length);
+    centroids.resize(2 * length);
+
+    #pragma omp parallel
+    {
+        std::vector<double> polygon;
+        std::vector<unsigned int> vertices;
+        std::vector<int> neighbours;
+        std::vector<double> buffer;
+
+        #pragma omp for schedule(static)
+        for(long long site = 0; site < siteNumber; site++)
+        {
+            computeCell(diagram, size_t(site), min, max, polygon, vertices, neighbours, buffer);
+
+            cg3::Point2Dd origin = diagram.getSite(size_t(site));
+            size_t size = polygon.size() / 2;
+
+            double area = 0, x = 0, y = 0;
+            for(size_t i = 0; i < size; i++)
+            {
+                size_t j = (i + 1) % size;
+
+                double aX = polygon[2 * i] - origin.x();
+                double aY = polygon[2 * i + 1] - origin.y();
+                double bX = polygon[2 * j] - origin.x();
+                double bY = polygon[2 * j + 1] - origin.y();
+
+                double cross = aX * bY - bX * aY;
+                area += cross;
+                x += (aX + bX) * cross;
+                y += (aY + bY) * cross;
+            }
+            area /= 2;
+
+            offsets[size_t(site + 1)] = unsigned(size);
+            areas[size_t(site)] = area;
+            centroids[size_t(2 * site)] = area > 0 ? origin.x() + x / (6 * area) : origin.x();
+            centroids[size_t(2 * site + 1)] = area > 0 ? origin.y() + y / (6 * area) : origin.y();
+        }
+    }
+
+    for(size_t i = 0; i < length; i++)
+    {
+        offsets[i + 1] += offsets[i];
+    }
+
+    coordinates.resize(2 * size_t(offsets.back()));
+
+    #pragma omp parallel
+    {
+        std::vector<double> polygon;
+        std::vector<unsigned int> vertices;
+        std::vector<int> neighbours;
+        std::vector<double> buffer;
+
+        #pragma omp for schedule(static)
+        for(long long site = 0; site < siteNumber; site++)
+        {
+            computeCell(diagram, size_t(site), min, max, polygon, vertices, neighbours, buffer);
+            std::copy(polygon.begin(), polygon.end(), coordinates.begin() + 2 * std::ptrdiff_t(offsets[size_t(site)]));
+        }
+    }
+}
+
+/**
+ * @brief Removes every cell
+*/
+void VoronoiCells::clear()
+{
+    offsets.assign(1, 0);
+    coordinates.clear();
+    areas.clear();
+    centroids.clear();
+}
+
+size_t VoronoiCells::getCellNumber() const
+{
+    return areas.size();
+}
+
+/**
+ * @brief Returns the number of vertices of a cell
+ * @param[in] cell: index of the cell, that is the index of its site
+ * @return size: number of vertices, 0 if the cell is outside the rectangle
+*/
+size_t VoronoiCells::getCellSize(size_t cell) const
+{
+    return offsets[cell + 1] - offsets[cell];
+}
+
+/**
+ * @brief Returns a vertex of a cell, vertices are in counter-clockwise order
+ * @param[in] cell: index of the cell
+ * @param[in] k: position of the vertex in the cell
+ * @return point: the vertex
+*/
+cg3::Point2Dd VoronoiCells::getCellVertex(size_t cell, size_t k) const
+{
+    size_t vertex = offsets[cell] + k;
+    return cg3::Point2Dd(coordinates[2 * vertex], coordinates[2 * vertex + 1]);
+}
+
+double VoronoiCells::getArea(size_t cell) const
+{
+    return areas[cell];
+}
+
+/**
+ * @brief Returns the centroid of a cell
+ * @param[in] cell: index of the cell
+ * @return point: the centroid, the site if the cell has no area
+*/
+cg3::Point2Dd VoronoiCells::getCentroid(size_t cell) const
+{
+    return cg3::Point2Dd(centroids[2 * cell], centroids[2 * cell + 1]);
+}
+
+/**
+ * @brief Returns the offsets of the cells in the vertices, one more than the number of cells
+ * @return offsets: the offsets
+*/
+const std::vector<unsigned int>& VoronoiCells::getOffsets() const
+{
+    return offsets;
+}
+
+/**
+ * @brief Returns the coordinates of the vertices of all the cells, x and y for each vertex
+ * @return coordinates: the coordinates
+*/
+const std::vector<double>& VoronoiCells::getCoordinates() const
+{
+    return coordinates;
+}
+
+const std::vector<double>& VoronoiCells::getAreas() const
+{
+    return areas;
+}
+
+/**
+ * @brief Returns the centroids of the cells, x and y for each cell
+ * @return centroids: the coordinates
+*/
+const std::vector<double>& VoronoiCells::getCentroids() const
+{
+    return centroids;
+}
@@ -0,0 +1,47 @@
+#ifndef VORONOICELLS_H
+#define VORONOICELLS_H
+
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include "voronoidiagram.h"
+
+/**
+ * @brief VoronoiCells: the cells of a Voronoi diagram clipped to a rectangle, with their areas and centroids
+ *
+ * The cell of site i is the polygon with the vertices in [offsets[i], offsets[i + 1]), x and y coordinates in counter-clockwise order;
+ * a cell outside the rectangle has no vertices and area 0.
+ * The cells of the sites next to the bounding triangle are closed by the circumcenters of the triangles with a vertex of the bounding triangle,
+ * which are far outside the rectangle, so clipping them gives the bounded cells.
+ */
+class VoronoiCells
+{
+public:
+    VoronoiCells();
+
+    void build(const VoronoiDiagram& diagram, const cg3::Point2Dd& min, const cg3::Point2Dd& max);
+    void clear();
+
+    size_t getCellNumber() const;
+    size_t getCellSize(size_t cell) const;
+    cg3::Point2Dd getCellVertex(size_t cell, size_t k) const;
+    double getArea(size_t cell) const;
+    cg3::Point2Dd getCentroid(size_t cell) const;
+
+    const std::vector<unsigned int>& getOffsets() const;
+    const std::vector<double>& getCoordinates() const;
+    const std::vector<double>& getAreas() const;
+    const std::vector<double>& getCentroids() const;
+
+private:
+    //vertices of the cell of site i are in [offsets[i], offsets[i + 1])
+    std::vector<unsigned int> offsets;
+    std::vector<double> coordinates;
+
+    //area and x, y coordinates of the centroid of each cell
+    std::vector<double> areas;
+    std::vector<double> centroids;
+};
+
+#endif // VORONOICELLS_H
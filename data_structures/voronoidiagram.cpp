@@ -0,0 +1,683 @@
+#include "voronoidiagram.h"
+
+#include <algorithms/indexedmesh.h>
+
+namespace {
+
+/**
+ * @brief Computes the circumcenter of a triangle
+ *
+ * The coordinates are translated in the first vertex, so the products don't lose precision
+ * when the triangle has a vertex of the bounding triangle.
+ * @param[in] a: first vertex
+ * @param[in] b: second vertex
+ * @param[in] c: third vertex
+ * @param[out] x: x coordinate of the circumcenter
+ * @param[out] y: y coordinate of the circumcenter
+*/
+void computeCircumcenter(const cg3::Point2Dd& a, const cg3::Point2Dd& b, const cg3::Point2Dd& c, double& x, double& y)
+{
+    double bX = b.x() - a.x();
+    double bY = b.y() - a.y();
+    double cX = c.x() - a.x();
+    double cY = c.y() - a.y();
+
+    double bSquared = bX * bX + bY * bY;
+    double cSquared = cX * cX + cY * cY;
+
+    double d = 2 * (bX * cY - bY * cX);
+
+    x = a.x() + (cY * bSquared - bY * cSquared) / d;
+    y = a.y() + (bX * cSquared - cX * bSquared) / d;
+}
+
+/**
+ * @brief Returns a vertex of a triangle
+ * @param[in] triangle: the triangle
+ * @param[in] corner: 0, 1 or 2
+ * @return point: the vertex
+*/
+cg3::Point2Dd getTriangleVertex(const Triangle& triangle, unsigned int corner)
+{
+    return corner == 0 ? triangle.getV1() : (corner == 1 ? triangle.getV2() : triangle.getV3());
+}
+
+}
+
+/**
+ * @brief Creates an empty diagram
+*/
+VoronoiDiagram::VoronoiDiagram() : version(0) {}
+
+/**
+ * @brief Rebuilds the diagram if the triangulation changed since the last build
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @return flag: true if the diagram was rebuilt
+*/
+bool VoronoiDiagram::update(const Triangulation& triangulation, const DAG& dag)
+{
+    if(version == triangulation.getVersion())
+    {
+        return false;
+    }
+
+    build(triangulation, dag);
+    return true;
+}
+
+/**
+ * @brief Updates the diagram with the triangles created and destroyed by the insertion of a point
+ *
+ * The vertices of the destroyed triangles are removed with their edges and the vertices of the created triangles
+ * which are still live are added and linked to their neighbours, so only the cells around the new site change.
+ * If the diagram was not built from the triangulation before the insertion it is rebuilt.
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] changes: the changes of the last insertion
+ * @return flag: true if the diagram changed
+*/
+bool VoronoiDiagram::update(const Triangulation& triangulation, const DAG& dag, const DelaunayTriangulation::TriangulationChanges& changes)
+{
+    if(version == triangulation.getVersion())
+    {
+        return false;
+    }
+
+    if(version == 0 || version != changes.previousVersion)
+    {
+        build(triangulation, dag);
+        return true;
+    }
+
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    triangleVertices.resize(triangles.size(), noVertex);
+
+    //created triangles destroyed by a flip have no vertex
+    for(unsigned int triangle : changes.destroyed)
+    {
+        if(triangleVertices[triangle] != noVertex)
+        {
+            removeVertex(unsigned(triangleVertices[triangle]));
+        }
+    }
+
+    for(unsigned int triangle = changes.firstCreated; triangle < triangles.size(); triangle++)
+    {
+        if(nodes[triangle].isLeaf())
+        {
+            addVertex(triangulation, triangle);
+        }
+    }
+
+    version = triangulation.getVersion();
+    return true;
+}
+
+/**
+ * @brief Builds the diagram from the live triangles
+ *
+ * Circumcenters, sides and edges are computed in parallel: edges are written at the offsets given by the number of edges of each vertex.
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+*/
+void VoronoiDiagram::build(const Triangulation& triangulation, const DAG& dag)
+{
+    std::vector<cg3::Point2Dd> vertices;
+    std::vector<unsigned int> indices;
+    std::vector<unsigned int> triangleIndices;
+
+    DelaunayTriangulation::indexTriangulationVertices(triangulation, dag, true, vertices, indices, triangleIndices);
+
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+
+    clear();
+    version = triangulation.getVersion();
+
+    for(unsigned int k = 0; k < 3; k++)
+    {
+        boundingVertices[k] = getTriangleVertex(triangles[0], k);
+    }
+
+    triangleVertices.assign(triangles.size(), noVertex);
+
+    //the bounding triangle is the only live triangle of an empty triangulation
+    if(triangleIndices.empty() || triangleIndices[0] == 0)
+    {
+        return;
+    }
+
+    //the vertices of the bounding triangle are not sites
+    std::vector<int> vertexSites(vertices.size(), noSite);
+
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        if(vertices[i] != boundingVertices[0] && vertices[i] != boundingVertices[1] && vertices[i] != boundingVertices[2])
+        {
+            vertexSites[i] = int(siteCoordinates.size() / 2);
+            siteIndices.insert(std::make_pair(vertices[i], unsigned(vertexSites[i])));
+            siteCoordinates.push_back(vertices[i].x());
+            siteCoordinates.push_back(vertices[i].y());
+        }
+    }
+
+    long long liveNumber = (long long)(triangleIndices.size());
+    size_t length = size_t(liveNumber);
+
+    vertexTriangles = triangleIndices;
+    vertexCoordinates.resize(2 * length);
+    sideVertices.resize(3 * length);
+    sideEdges.resize(3 * length);
+    cornerSites.resize(3 * length);
+    siteTriangles.resize(siteCoordinates.size() / 2);
+
+    //number of edges stored by each vertex
+    std::vector<unsigned int> edgeOffsets(length + 1, 0);
+
+    #pragma omp parallel
+    {
+        #pragma omp for
+        for(long long i = 0; i < liveNumber; i++)
+        {
+            triangleVertices[triangleIndices[size_t(i)]] = int(i);
+        }
+
+        #pragma omp for
+        for(long long i = 0; i < liveNumber; i++)
+        {
+            const Triangle& triangle = triangles[triangleIndices[size_t(i)]];
+            computeCircumcenter(triangle.getV1(), triangle.getV2(), triangle.getV3(),
+                                vertexCoordinates[size_t(2 * i)], vertexCoordinates[size_t(2 * i + 1)]);
+
+            const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(triangleIndices[size_t(i)]);
+
+            //an edge is stored by the vertex with the lower index between the two adjacent ones
+            unsigned int edgeNumber = 0;
+            for(unsigned int k = 0; k < maxAdjacentTriangles; k++)
+            {
+                int adjacent = adjacencies[k] != noAdjacentTriangle ? triangleVertices[unsigned(adjacencies[k])] : noVertex;
+
+                sideVertices[size_t(3 * i + k)] = adjacent;
+                sideEdges[size_t(3 * i + k)] = noVertex;
+                cornerSites[size_t(3 * i + k)] = vertexSites[indices[size_t(3 * i + k)]];
+
+                if(adjacent != noVertex && adjacent > i)
+                {
+                    edgeNumber++;
+                }
+            }
+            edgeOffsets[size_t(i + 1)] = edgeNumber;
+        }
+    }
+
+    for(long long i = 0; i < liveNumber; i++)
+    {
+        edgeOffsets[size_t(i + 1)] += edgeOffsets[size_t(i)];
+
+        for(unsigned int k = 0; k < 3; k++)
+        {
+            if(cornerSites[size_t(3 * i + k)] != noSite)
+            {
+                siteTriangles[unsigned(cornerSites[size_t(3 * i + k)])] = triangleIndices[size_t(i)];
+            }
+        }
+    }
+
+    edgeVertices.resize(2 * edgeOffsets.back());
+    edgeSites.resize(2 * edgeOffsets.back());
+
+    #pragma omp parallel for
+    for(long long i = 0; i < liveNumber; i++)
+    {
+        unsigned int edge = edgeOffsets[size_t(i)];
+
+        for(unsigned int k = 0; k < maxAdjacentTriangles; k++)
+        {
+            int adjacent = sideVertices[size_t(3 * i + k)];
+            if(adjacent == noVertex || adjacent < i)
+            {
+                continue;
+            }
+
+            //the edge k of a triangle joins its vertices k and k + 1
+            edgeVertices[2 * edge] = unsigned(i);
+            edgeVertices[2 * edge + 1] = unsigned(adjacent);
+            edgeSites[2 * edge] = cornerSites[size_t(3 * i + k)];
+            edgeSites[2 * edge + 1] = cornerSites[size_t(3 * i + (k + 1) % 3)];
+
+            //each side belongs to a single edge, so the sides of the adjacent vertex are written by this vertex only
+            sideEdges[size_t(3 * i + k)] = int(edge);
+            for(unsigned int side = 0; side < maxAdjacentTriangles; side++)
+            {
+                if(sideVertices[3 * unsigned(adjacent) + side] == i)
+                {
+                    sideEdges[3 * unsigned(adjacent) + side] = int(edge);
+                }
+            }
+            edge++;
+        }
+    }
+}
+
+/**
+ * @brief Removes every vertex, edge and site
+*/
+void VoronoiDiagram::clear()
+{
+    vertexCoordinates.clear();
+    vertexTriangles.clear();
+    triangleVertices.clear();
+    sideVertices.clear();
+    sideEdges.clear();
+    cornerSites.clear();
+    edgeVertices.clear();
+    edgeSites.clear();
+    siteCoordinates.clear();
+    siteTriangles.clear();
+    siteIndices.clear();
+    version = 0;
+}
+
+/**
+ * @brief Returns the version of the triangulation the diagram was built from
+ * @return version: 0 if the diagram was never built
+*/
+unsigned long long VoronoiDiagram::getVersion() const
+{
+    return version;
+}
+
+/**
+ * @brief Returns the memory of vertices, edges and sites
+ *
+ * The nodes of the site indices are estimated as the pair and two pointers, plus one pointer for each bucket.
+ * @return usage: the used and reserved bytes of the diagram
+*/
+DelaunayTriangulation::MemoryUsage VoronoiDiagram::getMemoryUsage() const
+{
+    DelaunayTriangulation::MemoryUsage usage;
+    usage.name = "Voronoi diagram";
+
+    usage.add(vertexCoordinates);
+    usage.add(vertexTriangles);
+    usage.add(triangleVertices);
+    usage.add(sideVertices);
+    usage.add(sideEdges);
+    usage.add(cornerSites);
+    usage.add(edgeVertices);
+    usage.add(edgeSites);
+    usage.add(siteCoordinates);
+    usage.add(siteTriangles);
+
+    size_t indexBytes = siteIndices.size() * (sizeof(std::pair<const cg3::Point2Dd, unsigned int>) + 2 * sizeof(void*));
+    usage.usedBytes += indexBytes;
+    usage.reservedBytes += indexBytes + siteIndices.bucket_count() * sizeof(void*);
+
+    return usage;
+}
+
+size_t VoronoiDiagram::getVertexNumber() const
+{
+    return vertexCoordinates.size() / 2;
+}
+
+/**
+ * @brief Returns a vertex of the diagram
+ * @param[in] vertex: index of the vertex
+ * @return point: the circumcenter of a live triangle
+*/
+cg3::Point2Dd VoronoiDiagram::getVertex(size_t vertex) const
+{
+    return cg3::Point2Dd(vertexCoordinates[2 * vertex], vertexCoordinates[2 * vertex + 1]);
+}
+
+/**
+ * @brief Returns the coordinates of the vertices, x and y for each vertex
+ * @return coordinates: the coordinates
+*/
+const std::vector<double>& VoronoiDiagram::getVertexCoordinates() const
+{
+    return vertexCoordinates;
+}
+
+/**
+ * @brief Returns the vertex dual to a triangle
+ * @param[in] triangle: index of the triangle in the triangulation
+ * @return vertex: index of the vertex, noVertex if the triangle is not live
+*/
+int VoronoiDiagram::getVertexOfTriangle(unsigned int triangle) const
+{
+    return triangle < triangleVertices.size() ? triangleVertices[triangle] : noVertex;
+}
+
+size_t VoronoiDiagram::getEdgeNumber() const
+{
+    return edgeVertices.size() / 2;
+}
+
+/**
+ * @brief Returns an endpoint of an edge
+ * @param[in] edge: index of the edge
+ * @param[in] endpoint: 0 or 1
+ * @return vertex: index of the vertex
+*/
+unsigned int VoronoiDiagram::getEdgeVertex(size_t edge, unsigned int endpoint) const
+{
+    return edgeVertices[2 * edge + endpoint];
+}
+
+/**
+ * @brief Returns one of the two sites separated by an edge
+ * @param[in] edge: index of the edge
+ * @param[in] side: 0 or 1
+ * @return site: index of the site, noSite for a vertex of the bounding triangle
+*/
+int VoronoiDiagram::getEdgeSite(size_t edge, unsigned int side) const
+{
+    return edgeSites[2 * edge + side];
+}
+
+/**
+ * @brief Returns the vertex indices of the edges, two for each edge
+ * @return indices: the vertex indices
+*/
+const std::vector<unsigned int>& VoronoiDiagram::getEdgeVertices() const
+{
+    return edgeVertices;
+}
+
+size_t VoronoiDiagram::getSiteNumber() const
+{
+    return siteCoordinates.size() / 2;
+}
+
+/**
+ * @brief Returns a site of the diagram
+ * @param[in] site: index of the site
+ * @return point: the inserted point
+*/
+cg3::Point2Dd VoronoiDiagram::getSite(size_t site) const
+{
+    return cg3::Point2Dd(siteCoordinates[2 * site], siteCoordinates[2 * site + 1]);
+}
+
+/**
+ * @brief Returns the cell of a site, walking counter-clockwise around it
+ *
+ * The k-th edge of the cell, from its k-th to its (k+1)-th vertex, separates the site from its k-th neighbour.
+ * @param[in] site: index of the site
+ * @param[out] vertices: indices of the vertices in counter-clockwise order
+ * @param[out] neighbours: index of the site on the other side of each edge, noSite for a vertex of the bounding triangle
+*/
+void VoronoiDiagram::getCell(size_t site, std::vector<unsigned int>& vertices, std::vector<int>& neighbours) const
+{
+    vertices.clear();
+    neighbours.clear();
+
+    int start = triangleVertices[siteTriangles[site]];
+    unsigned int vertex = unsigned(start);
+
+    do
+    {
+        unsigned int corner = cornerSites[3 * vertex] == int(site) ? 0 : (cornerSites[3 * vertex + 1] == int(site) ? 1 : 2);
+
+        //the side from the previous corner to the site leads to the next vertex in counter-clockwise order
+        unsigned int side = (corner + 2) % 3;
+
+        vertices.push_back(vertex);
+        neighbours.push_back(cornerSites[3 * vertex + side]);
+
+        if(sideVertices[3 * vertex + side] == noVertex)
+        {
+            break;
+        }
+        vertex = unsigned(sideVertices[3 * vertex + side]);
+    }
+    while(int(vertex) != start && vertices.size() < getVertexNumber());
+}
+
+/**
+ * @brief Finds the cell containing a point, that is the nearest site
+ *
+ * The search moves to the neighbour nearest to the point until no neighbour is nearer than the current site:
+ * in a Delaunay triangulation a site which is not the nearest one always has a nearer neighbour.
+ * @param[in] point: the query point
+ * @param[in] startSite: the site where the search starts, a site near the point makes the search shorter
+ * @return site: index of the nearest site, noSite if the diagram has no sites
+*/
+int VoronoiDiagram::findCell(const cg3::Point2Dd& point, size_t startSite) const
+{
+    if(getSiteNumber() == 0)
+    {
+        return noSite;
+    }
+
+    size_t site = startSite < getSiteNumber() ? startSite : 0;
+    double distance = point.dist(getSite(site));
+
+    std::vector<unsigned int> vertices;
+    std::vector<int> neighbours;
+
+    bool moved = true;
+    while(moved)
+    {
+        size_t nearest = site;
+
+        getCell(site, vertices, neighbours);
+        for(int neighbour : neighbours)
+        {
+            if(neighbour == noSite)
+            {
+                continue;
+            }
+
+            double neighbourDistance = point.dist(getSite(size_t(neighbour)));
+            if(neighbourDistance < distance)
+            {
+                distance = neighbourDistance;
+                nearest = size_t(neighbour);
+            }
+        }
+
+        moved = nearest != site;
+        site = nearest;
+    }
+
+    return int(site);
+}
+
+/**
+ * @brief Adds the vertex of a live triangle and the edges to its neighbours already in the diagram
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] triangle: index of the triangle
+*/
+void VoronoiDiagram::addVertex(const Triangulation& triangulation, unsigned int triangle)
+{
+    const Triangle& t = triangulation.getTriangles()[triangle];
+    unsigned int vertex = unsigned(vertexTriangles.size());
+
+    vertexTriangles.push_back(triangle);
+    triangleVertices[triangle] = int(vertex);
+
+    double x, y;
+    computeCircumcenter(t.getV1(), t.getV2(), t.getV3(), x, y);
+    vertexCoordinates.push_back(x);
+    vertexCoordinates.push_back(y);
+
+    for(unsigned int k = 0; k < 3; k++)
+    {
+        cornerSites.push_back(addSite(getTriangleVertex(t, k), triangle));
+        sideVertices.push_back(noVertex);
+        sideEdges.push_back(noVertex);
+    }
+
+    const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(triangle);
+
+    for(unsigned int k = 0; k < maxAdjacentTriangles; k++)
+    {
+        if(adjacencies[k] == noAdjacentTriangle || triangleVertices[unsigned(adjacencies[k])] == noVertex)
+        {
+            continue;
+        }
+
+        const std::array<int, maxAdjacentTriangles>& adjacentAdjacencies = triangulation.getAdjacenciesFromTriangle(unsigned(adjacencies[k]));
+        unsigned int adjacentSide = adjacentAdjacencies[0] == int(triangle) ? 0 : (adjacentAdjacencies[1] == int(triangle) ? 1 : 2);
+
+        addEdge(vertex, k, unsigned(triangleVertices[unsigned(adjacencies[k])]), adjacentSide);
+    }
+}
+
+/**
+ * @brief Removes a vertex with its edges, the last vertex takes its place
+ * @param[in] vertex: index of the vertex
+*/
+void VoronoiDiagram::removeVertex(unsigned int vertex)
+{
+    for(unsigned int k = 0; k < 3; k++)
+    {
+        if(sideEdges[3 * vertex + k] != noVertex)
+        {
+            removeEdge(unsigned(sideEdges[3 * vertex + k]));
+        }
+    }
+
+    triangleVertices[vertexTriangles[vertex]] = noVertex;
+
+    unsigned int last = unsigned(vertexTriangles.size() - 1);
+    if(vertex != last)
+    {
+        vertexTriangles[vertex] = vertexTriangles[last];
+        triangleVertices[vertexTriangles[vertex]] = int(vertex);
+        vertexCoordinates[2 * vertex] = vertexCoordinates[2 * last];
+        vertexCoordinates[2 * vertex + 1] = vertexCoordinates[2 * last + 1];
+
+        for(unsigned int k = 0; k < 3; k++)
+        {
+            sideVertices[3 * vertex + k] = sideVertices[3 * last + k];
+            sideEdges[3 * vertex + k] = sideEdges[3 * last + k];
+            cornerSites[3 * vertex + k] = cornerSites[3 * last + k];
+
+            //the neighbours and the edges of the moved vertex refer to its new index
+            if(sideVertices[3 * vertex + k] != noVertex)
+            {
+                unsigned int adjacent = unsigned(sideVertices[3 * vertex + k]);
+                for(unsigned int side = 0; side < 3; side++)
+                {
+                    if(sideVertices[3 * adjacent + side] == int(last))
+                    {
+                        sideVertices[3 * adjacent + side] = int(vertex);
+                    }
+                }
+            }
+
+            if(sideEdges[3 * vertex + k] != noVertex)
+            {
+                unsigned int edge = unsigned(sideEdges[3 * vertex + k]);
+                edgeVertices[2 * edge + (edgeVertices[2 * edge] == last ? 0 : 1)] = vertex;
+            }
+        }
+    }
+
+    vertexTriangles.pop_back();
+    vertexCoordinates.resize(2 * last);
+    sideVertices.resize(3 * last);
+    sideEdges.resize(3 * last);
+    cornerSites.resize(3 * last);
+}
+
+/**
+ * @brief Adds the edge between two adjacent vertices
+ * @param[in] first: the vertex storing the edge
+ * @param[in] firstSide: the side of the first vertex
+ * @param[in] second: the adjacent vertex
+ * @param[in] secondSide: the side of the second vertex
+*/
+void VoronoiDiagram::addEdge(unsigned int first, unsigned int firstSide, unsigned int second, unsigned int secondSide)
+{
+    int edge = int(edgeVertices.size() / 2);
+
+    //the edge k of a triangle joins its vertices k and k + 1
+    edgeVertices.push_back(first);
+    edgeVertices.push_back(second);
+    edgeSites.push_back(cornerSites[3 * first + firstSide]);
+    edgeSites.push_back(cornerSites[3 * first + (firstSide + 1) % 3]);
+
+    sideVertices[3 * first + firstSide] = int(second);
+    sideVertices[3 * second + secondSide] = int(first);
+    sideEdges[3 * first + firstSide] = edge;
+    sideEdges[3 * second + secondSide] = edge;
+}
+
+/**
+ * @brief Removes an edge and unlinks its vertices, the last edge takes its place
+ * @param[in] edge: index of the edge
+*/
+void VoronoiDiagram::removeEdge(unsigned int edge)
+{
+    for(unsigned int endpoint = 0; endpoint < 2; endpoint++)
+    {
+        unsigned int vertex = edgeVertices[2 * edge + endpoint];
+        for(unsigned int side = 0; side < 3; side++)
+        {
+            if(sideEdges[3 * vertex + side] == int(edge))
+            {
+                sideEdges[3 * vertex + side] = noVertex;
+                sideVertices[3 * vertex + side] = noVertex;
+            }
+        }
+    }
+
+    unsigned int last = unsigned(edgeVertices.size() / 2 - 1);
+    if(edge != last)
+    {
+        for(unsigned int endpoint = 0; endpoint < 2; endpoint++)
+        {
+            edgeVertices[2 * edge + endpoint] = edgeVertices[2 * last + endpoint];
+            edgeSites[2 * edge + endpoint] = edgeSites[2 * last + endpoint];
+
+            unsigned int vertex = edgeVertices[2 * edge + endpoint];
+            for(unsigned int side = 0; side < 3; side++)
+            {
+                if(sideEdges[3 * vertex + side] == int(last))
+                {
+                    sideEdges[3 * vertex + side] = int(edge);
+                }
+            }
+        }
+    }
+
+    edgeVertices.resize(2 * last);
+    edgeSites.resize(2 * last);
+}
+
+/**
+ * @brief Returns the index of a site, the site is added if it is new
+ * @param[in] point: the vertex of a triangle
+ * @param[in] triangle: a live triangle incident to the site
+ * @return site: index of the site, noSite for a vertex of the bounding triangle
+*/
+int VoronoiDiagram::addSite(const cg3::Point2Dd& point, unsigned int triangle)
+{
+    if(point == boundingVertices[0] || point == boundingVertices[1] || point == boundingVertices[2])
+    {
+        return noSite;
+    }
+
+    std::pair<std::unordered_map<cg3::Point2Dd, unsigned int>::iterator, bool> inserted =
+            siteIndices.insert(std::make_pair(point, unsigned(siteTriangles.size())));
+
+    if(inserted.second)
+    {
+        siteCoordinates.push_back(point.x());
+        siteCoordinates.push_back(point.y());
+        siteTriangles.push_back(triangle);
+    }
+    else
+    {
+        siteTriangles[inserted.first->second] = triangle;
+    }
+
+    return int(inserted.first->second);
+}
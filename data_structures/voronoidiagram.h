@@ -0,0 +1,102 @@
+#ifndef VORONOIDIAGRAM_H
+#define VORONOIDIAGRAM_H
+
+#include <unordered_map>
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include <algorithms/delaunay.h>
+#include <utils/memoryusage.h>
+
+#include "dag.h"
+#include "triangulation.h"
+
+//the neighbour site is a vertex of the bounding triangle
+const int noSite = -1;
+
+//the side of a vertex has no adjacent vertex or no edge
+const int noVertex = -1;
+
+/**
+ * @brief VoronoiDiagram: the Voronoi diagram dual to the triangulation
+ *
+ * The diagram is stored in flat arrays, so it can be drawn with vertex arrays and queried without further conversions:
+ * the vertices are the circumcenters of the live triangles (x, y pairs), each edge joins the circumcenters of two adjacent triangles
+ * and it is stored once with the two sites it separates; sites are the inserted points, the vertices of the bounding triangle are not sites.
+ * For each side of a vertex the diagram stores the adjacent vertex, the edge and the site at its first corner,
+ * so the cell of a site is walked counter-clockwise around it without the triangulation.
+ *
+ * Vertices and edges are kept compact: a removed one is replaced by the last one, so the diagram is updated in place
+ * with the changes of an insertion in time proportional to the degree of the new site.
+ * The diagram remembers the version of the triangulation it was built from and it is rebuilt in parallel
+ * when the changes don't start from that version.
+ */
+class VoronoiDiagram
+{
+public:
+    VoronoiDiagram();
+
+    bool update(const Triangulation& triangulation, const DAG& dag);
+    bool update(const Triangulation& triangulation, const DAG& dag, const DelaunayTriangulation::TriangulationChanges& changes);
+    void build(const Triangulation& triangulation, const DAG& dag);
+    void clear();
+
+    unsigned long long getVersion() const;
+    DelaunayTriangulation::MemoryUsage getMemoryUsage() const;
+
+    //vertices
+    size_t getVertexNumber() const;
+    cg3::Point2Dd getVertex(size_t vertex) const;
+    const std::vector<double>& getVertexCoordinates() const;
+    int getVertexOfTriangle(unsigned int triangle) const;
+
+    //edges
+    size_t getEdgeNumber() const;
+    unsigned int getEdgeVertex(size_t edge, unsigned int endpoint) const;
+    int getEdgeSite(size_t edge, unsigned int side) const;
+    const std::vector<unsigned int>& getEdgeVertices() const;
+
+    //sites and cells
+    size_t getSiteNumber() const;
+    cg3::Point2Dd getSite(size_t site) const;
+    void getCell(size_t site, std::vector<unsigned int>& vertices, std::vector<int>& neighbours) const;
+
+    int findCell(const cg3::Point2Dd& point, size_t startSite = 0) const;
+
+private:
+    void addVertex(const Triangulation& triangulation, unsigned int triangle);
+    void removeVertex(unsigned int vertex);
+    void addEdge(unsigned int first, unsigned int firstSide, unsigned int second, unsigned int secondSide);
+    void removeEdge(unsigned int edge);
+    int addSite(const cg3::Point2Dd& point, unsigned int triangle);
+
+    //x, y coordinates of the vertices
+    std::vector<double> vertexCoordinates;
+
+    //triangle of each vertex and vertex of each triangle, noVertex for the deleted triangles
+    std::vector<unsigned int> vertexTriangles;
+    std::vector<int> triangleVertices;
+
+    //three for each vertex, one for each side of its triangle
+    std::vector<int> sideVertices;
+    std::vector<int> sideEdges;
+    std::vector<int> cornerSites;
+
+    //two vertex indices and two site indices for each edge
+    std::vector<unsigned int> edgeVertices;
+    std::vector<int> edgeSites;
+
+    //x, y coordinates of the sites, a live triangle incident to each site and the index of each site
+    std::vector<double> siteCoordinates;
+    std::vector<unsigned int> siteTriangles;
+    std::unordered_map<cg3::Point2Dd, unsigned int> siteIndices;
+
+    //vertices of the bounding triangle, they are not sites
+    cg3::Point2Dd boundingVertices[3];
+
+    //version of the triangulation the diagram was built from, 0 if it was never built
+    unsigned long long version;
+};
+
+#endif // VORONOIDIAGRAM_H
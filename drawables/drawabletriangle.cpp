@@ -14,7 +14,8 @@ DrawableTriangle::DrawableTriangle(const cg3::Point2Dd &v1, const cg3::Point2Dd
 */
 void DrawableTriangle::draw() const
 {
-    cg3::viewer::drawTriangle2D(v1, v2, v3, Qt::red, 1);
+    const std::array<double, 6> coordinates = {{v1.x(), v1.y(), v2.x(), v2.y(), v3.x(), v3.y()}};
+    cg3::viewer::drawTriangles2D(coordinates, Qt::red, 1);
 }
 
 /**
@@ -1,5 +1,15 @@
 #include "drawabletriangulation.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <algorithms/indexedmesh.h>
+
+#include <cg3/viewer/utilities/render_statistics.h>
+
+#include <utils/tracing.h>
+
 /**
  * @brief Initializes the drawable object
  * @param[in] triangulation: array of triangles and adjacencies
@@ -8,37 +18,147 @@
  * @param[in] radius: the radius of the triangulation - radius of the bounding triangle
 */
 DrawableTriangulation::DrawableTriangulation(Triangulation& triangulation, DAG& dag, const cg3::Pointd& center, double radius) :
-    center(center), radius(radius), triangulation(triangulation), dag(dag) {}
+    center(center), radius(radius), triangulation(triangulation), dag(dag),
+    gridX(0), gridY(0), cellSize(1), columns(0), rows(0), vertexSpacing(0), bufferedVersion(0), frozen(false) {}
 //parameters of the bounding triangle are passed because the triangulation is inside this polygon
 
 /**
  * @brief Draws the triangulation
  *
  * This method draws only triangles contained in leaves, it draws green lines for the edges and red points for the vertices.
+ * The buffers are rebuilt only if the triangulation changed and the drawable is not frozen; only the rows of cells intersecting the view are drawn, with a call each,
+ * and far from the triangulation a sample of the vertices replaces the edges.
 */
 void DrawableTriangulation::draw() const
 {
-    std::vector<Triangle>& triangles = triangulation.getTriangles();
-    std::vector<Node>& nodes = dag.getNodeList();
+    Tracing::Scope rendering("rendering");
+
+    if(!frozen && bufferedVersion != triangulation.getVersion())
+    {
+        updateBuffers();
+    }
+
+    if(vertexCoordinates.empty())
+    {
+        return;
+    }
+
+    unsigned int firstColumn = 0;
+    unsigned int lastColumn = columns - 1;
+    unsigned int firstRow = 0;
+    unsigned int lastRow = rows - 1;
+    bool overview = false;
 
-    unsigned int length = unsigned(triangles.size());
+    double minX, minY, maxX, maxY, pixelSize;
+    bool cellsVisible = true;
 
-    //draw each triangle of triangulation
-    for(unsigned int i = 1; i < length; i++)
+    if(computeVisibleRectangle(minX, minY, maxX, maxY, pixelSize))
     {
-        //ignore bounding triangle
-        if(nodes[i].isLeaf())
+        //edges leave their cell by less than a cell, so the cells next to the view are drawn too
+        double left = std::floor((minX - gridX) / cellSize) - 1;
+        double right = std::floor((maxX - gridX) / cellSize) + 1;
+        double bottom = std::floor((minY - gridY) / cellSize) - 1;
+        double top = std::floor((maxY - gridY) / cellSize) + 1;
+
+        cellsVisible = right >= 0 && left < columns && top >= 0 && bottom < rows;
+        if(cellsVisible)
+        {
+            firstColumn = unsigned(std::max(left, 0.0));
+            lastColumn = unsigned(std::min(right, double(columns - 1)));
+            firstRow = unsigned(std::max(bottom, 0.0));
+            lastRow = unsigned(std::min(top, double(rows - 1)));
+        }
+
+        overview = vertexSpacing < overviewPixelSpacing * pixelSize;
+    }
+
+    //bytes read from the client arrays for each vertex, and for each index of an edge
+    const size_t vertexBytes = 2 * sizeof(double);
+    const size_t edgeVertexBytes = vertexBytes + sizeof(unsigned int);
+
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, vertexCoordinates.data());
+
+    if(!overview)
+    {
+        //draw lines
+        glLineWidth(1);
+        glColor3f(0, 1, 0);
+
+        for(unsigned int row = firstRow; cellsVisible && row <= lastRow; row++)
+        {
+            unsigned int begin = edgeOffsets[row * columns + firstColumn];
+            unsigned int end = edgeOffsets[row * columns + lastColumn + 1];
+            if(end > begin)
+            {
+                glDrawElements(GL_LINES, GLsizei(2 * (end - begin)), GL_UNSIGNED_INT, edgeIndices.data() + 2 * begin);
+                cg3::viewer::recordDrawCall(GL_LINES, GLsizei(2 * (end - begin)), 2 * (end - begin) * edgeVertexBytes);
+            }
+        }
+
+        unsigned int longEdges = edgeOffsets[rows * columns];
+        if(2 * longEdges < edgeIndices.size())
         {
-            //draw points and lines
-            cg3::viewer::drawPoint2D(triangles[i].getV1(), Qt::red, 5);
-            cg3::viewer::drawPoint2D(triangles[i].getV2(), Qt::red, 5);
-            cg3::viewer::drawPoint2D(triangles[i].getV3(), Qt::red, 5);
+            glDrawElements(GL_LINES, GLsizei(edgeIndices.size() - 2 * longEdges), GL_UNSIGNED_INT, edgeIndices.data() + 2 * longEdges);
+            cg3::viewer::recordDrawCall(GL_LINES, GLsizei(edgeIndices.size() - 2 * longEdges), (edgeIndices.size() - 2 * longEdges) * edgeVertexBytes);
+        }
 
-            cg3::viewer::drawLine2D(triangles[i].getV1(), triangles[i].getV2(), Qt::green, 1);
-            cg3::viewer::drawLine2D(triangles[i].getV2(), triangles[i].getV3(), Qt::green, 1);
-            cg3::viewer::drawLine2D(triangles[i].getV3(), triangles[i].getV1(), Qt::green, 1);
+        //draw points over the lines
+        glEnable(GL_POINT_SMOOTH);
+        glPointSize(5);
+        glColor3f(1, 0, 0);
+
+        for(unsigned int row = firstRow; cellsVisible && row <= lastRow; row++)
+        {
+            unsigned int begin = vertexOffsets[row * columns + firstColumn];
+            unsigned int end = vertexOffsets[row * columns + lastColumn + 1];
+            if(end > begin)
+            {
+                glDrawArrays(GL_POINTS, GLint(begin), GLsizei(end - begin));
+                cg3::viewer::recordDrawCall(GL_POINTS, GLsizei(end - begin), (end - begin) * vertexBytes);
+            }
+        }
+    }
+    else
+    {
+        //about one vertex for each pixel, vertices of a cell are not sorted so every stride-th one is a uniform sample
+        double verticesPerPixel = (pixelSize / vertexSpacing) * (pixelSize / vertexSpacing);
+        unsigned int stride = unsigned(std::max(1.0, std::min(std::ceil(verticesPerPixel), double(vertexCoordinates.size()))));
+
+        glPointSize(1);
+        glColor3f(1, 0, 0);
+
+        for(unsigned int row = firstRow; cellsVisible && row <= lastRow; row++)
+        {
+            unsigned int begin = vertexOffsets[row * columns + firstColumn];
+            unsigned int end = vertexOffsets[row * columns + lastColumn + 1];
+            if(end > begin)
+            {
+                glVertexPointer(2, GL_DOUBLE, GLsizei(2 * stride * sizeof(double)), vertexCoordinates.data() + 2 * begin);
+                glDrawArrays(GL_POINTS, 0, GLsizei((end - begin + stride - 1) / stride));
+                cg3::viewer::recordDrawCall(GL_POINTS, GLsizei((end - begin + stride - 1) / stride), (end - begin + stride - 1) / stride * vertexBytes);
+            }
         }
     }
+
+    //draw the flipped edges over the triangulation
+    if(!flippedEdgeCoordinates.empty())
+    {
+        glVertexPointer(2, GL_DOUBLE, 0, flippedEdgeCoordinates.data());
+        glLineWidth(2);
+        glColor3f(1, 0.5f, 0);
+        glDrawArrays(GL_LINES, 0, GLsizei(flippedEdgeCoordinates.size() / 2));
+        cg3::viewer::recordDrawCall(GL_LINES, GLsizei(flippedEdgeCoordinates.size() / 2), flippedEdgeCoordinates.size() * sizeof(double));
+    }
+
+    glDisableClientState(GL_VERTEX_ARRAY);
+
+    //draw the picked triangle and vertex over everything else
+    if(!pickedTriangleCoordinates.empty())
+    {
+        cg3::viewer::drawTriangles2D(pickedTriangleCoordinates, QColor(0, 255, 255), 2, true);
+        cg3::viewer::drawPoints2D(pickedVertexCoordinates, QColor(255, 0, 255), 10);
+    }
 }
 
 /**
@@ -58,3 +178,331 @@ double DrawableTriangulation::sceneRadius() const
 {
     return radius;
 }
+
+/**
+ * @brief Stops or restarts rebuilding the buffers while drawing
+ * @param[in] frozen: true while the triangulation is modified by another thread
+*/
+void DrawableTriangulation::setFrozen(bool frozen)
+{
+    this->frozen = frozen;
+}
+
+/**
+ * @brief Rebuilds the buffers if the triangulation changed, it must be called only when the triangulation is consistent
+*/
+void DrawableTriangulation::refresh()
+{
+    if(bufferedVersion != triangulation.getVersion())
+    {
+        updateBuffers();
+    }
+}
+
+/**
+ * @brief Highlights the edges created by some flips, the ones destroyed by a following flip are ignored
+ *
+ * It must be called only when the triangulation is consistent.
+ * @param[in] flips: the first of the two triangles created by each flip, as in TriangulationChanges
+*/
+void DrawableTriangulation::setHighlightedFlips(const std::vector<unsigned int>& flips)
+{
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    flippedEdgeCoordinates.clear();
+
+    for(unsigned int triangle : flips)
+    {
+        if(!nodes[triangle].isLeaf() || !nodes[triangle + 1].isLeaf())
+        {
+            continue;
+        }
+
+        //the flipped edge is the one the two triangles share
+        const cg3::Point2Dd first[3] = {triangles[triangle].getV1(), triangles[triangle].getV2(), triangles[triangle].getV3()};
+        const Triangle& second = triangles[triangle + 1];
+
+        for(const cg3::Point2Dd& vertex : first)
+        {
+            if(vertex == second.getV1() || vertex == second.getV2() || vertex == second.getV3())
+            {
+                flippedEdgeCoordinates.push_back(vertex.x());
+                flippedEdgeCoordinates.push_back(vertex.y());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Removes the highlighted flipped edges
+*/
+void DrawableTriangulation::clearHighlightedFlips()
+{
+    flippedEdgeCoordinates.clear();
+}
+
+/**
+ * @brief Highlights a picked triangle and one of its vertices
+ * @param[in] triangle: the picked triangle
+ * @param[in] vertex: the picked vertex
+*/
+void DrawableTriangulation::setPickedElement(const Triangle& triangle, const cg3::Point2Dd& vertex)
+{
+    pickedTriangleCoordinates = {triangle.getV1().x(), triangle.getV1().y(),
+                                 triangle.getV2().x(), triangle.getV2().y(),
+                                 triangle.getV3().x(), triangle.getV3().y()};
+    pickedVertexCoordinates = {vertex.x(), vertex.y()};
+}
+
+/**
+ * @brief Removes the highlighted picked triangle and vertex
+*/
+void DrawableTriangulation::clearPickedElement()
+{
+    pickedTriangleCoordinates.clear();
+    pickedVertexCoordinates.clear();
+}
+
+/**
+ * @brief Returns the memory of the buffers drawn and of the highlighted edges and triangle
+ * @return usage: the used and reserved bytes of the buffers
+*/
+DelaunayTriangulation::MemoryUsage DrawableTriangulation::getMemoryUsage() const
+{
+    DelaunayTriangulation::MemoryUsage usage;
+    usage.name = "drawable buffers";
+
+    usage.add(vertexCoordinates);
+    usage.add(edgeIndices);
+    usage.add(vertexOffsets);
+    usage.add(edgeOffsets);
+    usage.add(flippedEdgeCoordinates);
+    usage.add(pickedTriangleCoordinates);
+    usage.add(pickedVertexCoordinates);
+
+    return usage;
+}
+
+/**
+ * @brief Builds the vertex and edge buffers from the live triangles
+ *
+ * The bounding triangle is ignored; an edge is stored by the triangle with the lower index between the two that share it.
+*/
+void DrawableTriangulation::updateBuffers() const
+{
+    std::vector<cg3::Point2Dd> vertices;
+    std::vector<unsigned int> triangleVertices;
+    std::vector<unsigned int> triangleIndices;
+
+    DelaunayTriangulation::indexTriangulationVertices(triangulation, dag, true, vertices, triangleVertices, triangleIndices);
+
+    vertexCoordinates.clear();
+    edgeIndices.clear();
+    vertexOffsets.clear();
+    edgeOffsets.clear();
+    bufferedVersion = triangulation.getVersion();
+
+    //the bounding triangle is the only live triangle of an empty triangulation
+    if(triangleIndices.empty() || triangleIndices[0] == 0)
+    {
+        return;
+    }
+
+    std::vector<double> coordinates(2 * vertices.size());
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        coordinates[2 * i] = vertices[i].x();
+        coordinates[2 * i + 1] = vertices[i].y();
+    }
+
+    //a triangulation has about 3 edges for every 2 triangles
+    std::vector<unsigned int> edges;
+    edges.reserve(3 * triangleIndices.size() + 6);
+
+    for(size_t i = 0; i < triangleIndices.size(); i++)
+    {
+        const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(triangleIndices[i]);
+
+        for(unsigned int edge = 0; edge < maxAdjacentTriangles; edge++)
+        {
+            int adjacent = adjacencies[edge];
+
+            if(adjacent == noAdjacentTriangle || unsigned(adjacent) > triangleIndices[i])
+            {
+                edges.push_back(triangleVertices[3 * i + edge]);
+                edges.push_back(triangleVertices[3 * i + (edge + 1) % 3]);
+            }
+        }
+    }
+
+    buildGrid(coordinates, edges);
+}
+
+/**
+ * @brief Sorts vertices and edges by the cell of a uniform grid
+ *
+ * The grid covers the inserted points with about verticesPerGridCell vertices in each cell, the vertices of the bounding triangle
+ * are moved to the nearest cell; an edge belongs to the cell of its first vertex, unless it is longer than a cell.
+ * Both are sorted by counting the elements of each cell.
+ * @param[in] coordinates: x, y coordinates of each vertex
+ * @param[in] edges: pairs of vertex indices
+*/
+void DrawableTriangulation::buildGrid(const std::vector<double>& coordinates, const std::vector<unsigned int>& edges) const
+{
+    //a very thin triangulation has at most this many cells in a row or in a column
+    const double maxGridSide = 1024;
+
+    const Triangle& boundingTriangle = triangulation.getTriangles()[0];
+    const cg3::Point2Dd boundingVertices[] = {boundingTriangle.getV1(), boundingTriangle.getV2(), boundingTriangle.getV3()};
+
+    size_t vertexNumber = coordinates.size() / 2;
+    size_t edgeNumber = edges.size() / 2;
+
+    double minX = std::numeric_limits<double>::max(), minY = minX;
+    double maxX = std::numeric_limits<double>::lowest(), maxY = maxX;
+
+    for(size_t i = 0; i < vertexNumber; i++)
+    {
+        cg3::Point2Dd vertex(coordinates[2 * i], coordinates[2 * i + 1]);
+        if(vertex != boundingVertices[0] && vertex != boundingVertices[1] && vertex != boundingVertices[2])
+        {
+            minX = std::min(minX, vertex.x());
+            minY = std::min(minY, vertex.y());
+            maxX = std::max(maxX, vertex.x());
+            maxY = std::max(maxY, vertex.y());
+        }
+    }
+
+    double width = maxX - minX;
+    double height = maxY - minY;
+    double side = std::max(std::max(width, height), std::numeric_limits<double>::min());
+    double cellNumber = std::max(1.0, double(vertexNumber / verticesPerGridCell));
+
+    gridX = minX;
+    gridY = minY;
+    cellSize = std::max(std::sqrt(width * height / cellNumber), side / maxGridSide);
+    columns = unsigned(width / cellSize) + 1;
+    rows = unsigned(height / cellSize) + 1;
+    vertexSpacing = width * height > 0 ? std::sqrt(width * height / double(vertexNumber)) : side / double(vertexNumber);
+
+    unsigned int cells = columns * rows;
+    std::vector<unsigned int> vertexCells(vertexNumber);
+
+    vertexOffsets.assign(cells + 1, 0);
+    for(size_t i = 0; i < vertexNumber; i++)
+    {
+        double column = std::min(std::max(std::floor((coordinates[2 * i] - gridX) / cellSize), 0.0), double(columns - 1));
+        double row = std::min(std::max(std::floor((coordinates[2 * i + 1] - gridY) / cellSize), 0.0), double(rows - 1));
+
+        vertexCells[i] = unsigned(row) * columns + unsigned(column);
+        vertexOffsets[vertexCells[i] + 1]++;
+    }
+
+    for(unsigned int cell = 0; cell < cells; cell++)
+    {
+        vertexOffsets[cell + 1] += vertexOffsets[cell];
+    }
+
+    //new position of each vertex
+    std::vector<unsigned int> positions(vertexNumber);
+    std::vector<unsigned int> next(vertexOffsets.begin(), vertexOffsets.end() - 1);
+
+    vertexCoordinates.resize(coordinates.size());
+    for(size_t i = 0; i < vertexNumber; i++)
+    {
+        positions[i] = next[vertexCells[i]]++;
+        vertexCoordinates[2 * positions[i]] = coordinates[2 * i];
+        vertexCoordinates[2 * positions[i] + 1] = coordinates[2 * i + 1];
+    }
+
+    //the long edges are in an additional cell after the last one
+    std::vector<unsigned int> edgeCells(edgeNumber);
+
+    edgeOffsets.assign(cells + 2, 0);
+    for(size_t i = 0; i < edgeNumber; i++)
+    {
+        unsigned int first = edges[2 * i];
+        unsigned int second = edges[2 * i + 1];
+
+        bool longEdge = std::fabs(coordinates[2 * first] - coordinates[2 * second]) > cellSize ||
+                std::fabs(coordinates[2 * first + 1] - coordinates[2 * second + 1]) > cellSize;
+
+        edgeCells[i] = longEdge ? cells : vertexCells[first];
+        edgeOffsets[edgeCells[i] + 1]++;
+    }
+
+    for(unsigned int cell = 0; cell <= cells; cell++)
+    {
+        edgeOffsets[cell + 1] += edgeOffsets[cell];
+    }
+
+    next.assign(edgeOffsets.begin(), edgeOffsets.end() - 1);
+
+    edgeIndices.resize(edges.size());
+    for(size_t i = 0; i < edgeNumber; i++)
+    {
+        unsigned int edge = next[edgeCells[i]]++;
+        edgeIndices[2 * edge] = positions[edges[2 * i]];
+        edgeIndices[2 * edge + 1] = positions[edges[2 * i + 1]];
+    }
+}
+
+/**
+ * @brief Computes the rectangle of the plane z = 0 seen by the camera, from the matrices set by the viewer
+ * @param[out] minX: left side of the rectangle
+ * @param[out] minY: bottom side of the rectangle
+ * @param[out] maxX: right side of the rectangle
+ * @param[out] maxY: top side of the rectangle
+ * @param[out] pixelSize: size of a pixel in the plane
+ * @return flag: false if the view is not bounded, for example when the camera sees the horizon
+*/
+bool DrawableTriangulation::computeVisibleRectangle(double& minX, double& minY, double& maxX, double& maxY, double& pixelSize) const
+{
+    GLdouble modelview[16];
+    GLdouble projection[16];
+    GLint viewport[4];
+
+    glGetDoublev(GL_MODELVIEW_MATRIX, modelview);
+    glGetDoublev(GL_PROJECTION_MATRIX, projection);
+    glGetIntegerv(GL_VIEWPORT, viewport);
+
+    if(viewport[2] <= 0 || viewport[3] <= 0)
+    {
+        return false;
+    }
+
+    minX = minY = std::numeric_limits<double>::max();
+    maxX = maxY = std::numeric_limits<double>::lowest();
+
+    for(unsigned int corner = 0; corner < 4; corner++)
+    {
+        GLdouble windowX = viewport[0] + (corner % 2 == 0 ? 0 : viewport[2]);
+        GLdouble windowY = viewport[1] + (corner < 2 ? 0 : viewport[3]);
+
+        GLdouble nearX, nearY, nearZ, farX, farY, farZ;
+        if(gluUnProject(windowX, windowY, 0, modelview, projection, viewport, &nearX, &nearY, &nearZ) != GL_TRUE ||
+                gluUnProject(windowX, windowY, 1, modelview, projection, viewport, &farX, &farY, &farZ) != GL_TRUE)
+        {
+            return false;
+        }
+
+        //the ray of the corner must cross the plane between the near and the far planes
+        double t = nearZ / (nearZ - farZ);
+        if(nearZ == farZ || t < 0 || t > 1)
+        {
+            return false;
+        }
+
+        double x = nearX + t * (farX - nearX);
+        double y = nearY + t * (farY - nearY);
+
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    pixelSize = std::max((maxX - minX) / viewport[2], (maxY - minY) / viewport[3]);
+    return true;
+}
@@ -4,13 +4,32 @@
 #include <data_structures/dag.h>
 #include <data_structures/triangulation.h>
 
+#include <utils/memoryusage.h>
+
 #include <cg3/viewer/interfaces/drawable_object.h>
 #include <cg3/viewer/renderable_objects/2d/renderable_objects2d.h>
 
+//mean number of vertices in a cell of the grid
+const unsigned int verticesPerGridCell = 256;
+
+//when vertices are closer than this on the screen (in pixels) only a sample of them is drawn, without edges
+const double overviewPixelSpacing = 3;
+
 /**
  * @brief DrawableTriangulation: drawable object for the triangulation
  *
  * This class inherits only from DrawableObject, this implementation follows the composition pattern: the drawable object for the triangulation has two members that are references to the DAG, used to draw only leaves, and to the triangulation data structure. Triangles are drawn using points and lines.
+ *
+ * The live triangles are converted in a vertex buffer, with each vertex stored once, and in an index buffer with each edge stored once;
+ * the buffers are rebuilt only when the version of the triangulation changes and they are drawn with vertex arrays, like DrawableMesh does.
+ *
+ * Vertices and edges are sorted by the cell of a uniform grid containing them, so only the rows of cells inside the view are drawn;
+ * edges longer than a cell are kept apart and always drawn. When the mean distance between the vertices is less than
+ * overviewPixelSpacing pixels only a sample of the vertices is drawn, about one for each pixel.
+ *
+ * While the triangulation is modified by another thread the drawable is frozen: it draws the buffers it has
+ * and they are rebuilt only by refresh, called when the triangulation is consistent.
+ * The edges created by the last flips and a picked triangle with one of its vertices can be highlighted over the triangulation.
  */
 class DrawableTriangulation : public cg3::DrawableObject
 {
@@ -21,12 +40,59 @@ public:
     cg3::Pointd sceneCenter() const;
     double sceneRadius() const;
 
+    void setFrozen(bool frozen);
+    void refresh();
+
+    void setHighlightedFlips(const std::vector<unsigned int>& flips);
+    void clearHighlightedFlips();
+
+    void setPickedElement(const Triangle& triangle, const cg3::Point2Dd& vertex);
+    void clearPickedElement();
+
+    DelaunayTriangulation::MemoryUsage getMemoryUsage() const;
+
 private:
+    void updateBuffers() const;
+    void buildGrid(const std::vector<double>& coordinates, const std::vector<unsigned int>& edges) const;
+    bool computeVisibleRectangle(double& minX, double& minY, double& maxX, double& maxY, double& pixelSize) const;
+
     const cg3::Pointd center;
     const double radius;
 
     Triangulation& triangulation;
     DAG& dag;
+
+    //x, y coordinates of each vertex and pairs of vertex indices for each edge, sorted by cell
+    mutable std::vector<double> vertexCoordinates;
+    mutable std::vector<unsigned int> edgeIndices;
+
+    //vertices and edges of cell i are in [offsets[i], offsets[i + 1]), cells are stored by rows
+    //the edges after the last cell are longer than a cell
+    mutable std::vector<unsigned int> vertexOffsets;
+    mutable std::vector<unsigned int> edgeOffsets;
+
+    //lower left corner, side of the cells, number of columns and rows of the grid
+    mutable double gridX;
+    mutable double gridY;
+    mutable double cellSize;
+    mutable unsigned int columns;
+    mutable unsigned int rows;
+
+    //mean distance between the vertices
+    mutable double vertexSpacing;
+
+    //version of the triangulation described by the buffers
+    mutable unsigned long long bufferedVersion;
+
+    //the buffers are not rebuilt by draw
+    bool frozen;
+
+    //x, y coordinates of the endpoints of the highlighted flipped edges
+    std::vector<double> flippedEdgeCoordinates;
+
+    //x, y coordinates of the picked triangle and of the picked vertex, copied so they don't change with the triangulation
+    std::vector<double> pickedTriangleCoordinates;
+    std::vector<double> pickedVertexCoordinates;
 };
 
 #endif // DRAWABLETRIANGULATION_H
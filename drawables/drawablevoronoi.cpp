@@ -1,55 +1,58 @@
 #include "drawablevoronoi.h"
 
+#include <cg3/viewer/utilities/render_statistics.h>
+
+#include <utils/tracing.h>
+
 /**
  * @brief Initializes the drawable object
+ * @param[in] diagram: the Voronoi diagram, updated before drawing it
  * @param[in] triangulation: array of triangles and adjacencies
  * @param[in] dag: the search data structure
  * @param[in] center: the center of the triangulation - center of the bounding triangle
  * @param[in] radius: the radius of the triangulation - radius of the bounding triangle
 */
-DrawableVoronoi::DrawableVoronoi(Triangulation& triangulation, DAG& dag, const cg3::Pointd& center, double radius) :
-    center(center), radius(radius), triangulation(triangulation), dag(dag) {}
+DrawableVoronoi::DrawableVoronoi(VoronoiDiagram& diagram, Triangulation& triangulation, DAG& dag, const cg3::Pointd& center, double radius) :
+    center(center), radius(radius), diagram(diagram), triangulation(triangulation), dag(dag), frozen(false) {}
 //parameters of the bounding triangle are passed because the triangulation is inside this polygon
 
 /**
  * @brief Draws the Voronoi diagram
  *
  * This method draws only triangles contained in leaves, it draws blue lines for the edges and yellow points for the circumcenters.
+ * Lines and circumcenters are drawn with a single call each, the diagram is rebuilt only if the triangulation changed and the drawable is not frozen.
 */
 void DrawableVoronoi::draw() const
 {
-    std::vector<Triangle>& triangles = triangulation.getTriangles();
-    std::vector<Node>& nodes = dag.getNodeList();
+    Tracing::Scope rendering("rendering");
 
-    unsigned int length = unsigned(triangles.size());
+    if(!frozen)
+    {
+        diagram.update(triangulation, dag);
+    }
 
-    //draw each triangle of triangulation
-    for(unsigned int i = 1; i < length; i++)
+    if(diagram.getVertexNumber() == 0)
     {
-        //ignore bounding triangle
-        if(nodes[i].isLeaf())
-        {
-            //draw circumcenter
-            cg3::Point2Dd circumCenter = triangles[i].getCircumcenter();
-            cg3::viewer::drawPoint2D(circumCenter, Qt::yellow, 5);
+        return;
+    }
 
-            //draw line from the circumcenter to each circumcenter of adjacent triangles
-            const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(i);
+    glEnableClientState(GL_VERTEX_ARRAY);
+    glVertexPointer(2, GL_DOUBLE, 0, diagram.getVertexCoordinates().data());
 
-            if(adjacencies[v1v2Edge] != noAdjacentTriangle)
-            {
-                cg3::viewer::drawLine2D(circumCenter, triangles[unsigned(adjacencies[v1v2Edge])].getCircumcenter(), Qt::blue, 1);
-            }
-            if(adjacencies[v2v3Edge] != noAdjacentTriangle)
-            {
-                cg3::viewer::drawLine2D(circumCenter, triangles[unsigned(adjacencies[v2v3Edge])].getCircumcenter(), Qt::blue, 1);
-            }
-            if(adjacencies[v3v1Edge] != noAdjacentTriangle)
-            {
-                cg3::viewer::drawLine2D(circumCenter, triangles[unsigned(adjacencies[v3v1Edge])].getCircumcenter(), Qt::blue, 1);
-            }
-        }
-    }
+    //draw lines
+    glLineWidth(1);
+    glColor3f(0, 0, 1);
+    glDrawElements(GL_LINES, GLsizei(diagram.getEdgeVertices().size()), GL_UNSIGNED_INT, diagram.getEdgeVertices().data());
+    cg3::viewer::recordDrawCall(GL_LINES, GLsizei(diagram.getEdgeVertices().size()), diagram.getEdgeVertices().size() * (2 * sizeof(double) + sizeof(unsigned int)));
+
+    //draw circumcenters over the lines
+    glEnable(GL_POINT_SMOOTH);
+    glPointSize(5);
+    glColor3f(1, 1, 0);
+    glDrawArrays(GL_POINTS, 0, GLsizei(diagram.getVertexNumber()));
+    cg3::viewer::recordDrawCall(GL_POINTS, GLsizei(diagram.getVertexNumber()), diagram.getVertexNumber() * 2 * sizeof(double));
+
+    glDisableClientState(GL_VERTEX_ARRAY);
 }
 
 /**
@@ -69,3 +72,20 @@ double DrawableVoronoi::sceneRadius() const
 {
     return radius;
 }
+
+/**
+ * @brief Stops or restarts updating the diagram while drawing
+ * @param[in] frozen: true while the triangulation is modified by another thread
+*/
+void DrawableVoronoi::setFrozen(bool frozen)
+{
+    this->frozen = frozen;
+}
+
+/**
+ * @brief Updates the diagram if the triangulation changed, it must be called only when the triangulation is consistent
+*/
+void DrawableVoronoi::refresh()
+{
+    diagram.update(triangulation, dag);
+}
@@ -3,6 +3,7 @@
 
 #include <data_structures/dag.h>
 #include <data_structures/triangulation.h>
+#include <data_structures/voronoidiagram.h>
 
 #include <cg3/viewer/interfaces/drawable_object.h>
 #include <cg3/viewer/renderable_objects/2d/renderable_objects2d.h>
@@ -11,22 +12,33 @@
  * @brief DrawableVoronoi: drawable object for Voronoi diagram
  *
  * This class inherits only from DrawableObject, this implementation follows the composition pattern: the drawable object for the triangulation has two members that are references to the DAG, used to draw only leaves, and to the triangulation data structure. The diagram is drawn using circumcenters of each triangle and lines from the circumcenter to the circumcenter of each adjacent triangle.
+ *
+ * Circumcenters and lines are taken from a Voronoi diagram shared with the other users of the diagram,
+ * which is rebuilt only when the version of the triangulation changes; each line is stored once.
+ * While the triangulation is modified by another thread the drawable is frozen and the diagram is updated only by refresh.
  */
 class DrawableVoronoi : public cg3::DrawableObject
 {
 public:
-    DrawableVoronoi(Triangulation& triangulation, DAG& dag, const cg3::Pointd& center, const double radius);
+    DrawableVoronoi(VoronoiDiagram& diagram, Triangulation& triangulation, DAG& dag, const cg3::Pointd& center, const double radius);
 
     void draw() const;
     cg3::Pointd sceneCenter() const;
     double sceneRadius() const;
 
+    void setFrozen(bool frozen);
+    void refresh();
+
 private:
     const cg3::Pointd center;
     const double radius;
 
+    VoronoiDiagram& diagram;
     Triangulation& triangulation;
     DAG& dag;
+
+    //the diagram is not updated by draw
+    bool frozen;
 };
 
 #endif // DRAWABLEVORONOI_H
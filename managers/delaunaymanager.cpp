@@ -4,17 +4,32 @@
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QInputDialog>
+#include <QStandardPaths>
+#include <QDir>
 
 #include <ctime>
+#include <random>
+#include <sstream>
 
 #include "utils/fileutils.h"
+#include "utils/binarypointfile.h"
+#include "utils/pointstreamreader.h"
+#include "utils/pointgenerator.h"
 #include "utils/delaunay_checker.h"
+#include "utils/topology_checker.h"
+#include "utils/triangulationsnapshot.h"
+#include "utils/meshexporter.h"
+#include "utils/softwarerenderer.h"
+#include "utils/tracing.h"
+#include "utils/memoryreport.h"
 
 #include <cg3/data_structures/arrays/arrays.h>
 #include <cg3/utilities/timer.h>
 
 #include "data_structures/triangulation.h"
 #include "algorithms/delaunay.h"
+#include "algorithms/spatialsort.h"
+#include "algorithms/picking.h"
 
 //Limits for the bounding box
 //It defines where points can be added
@@ -44,6 +59,34 @@ const cg3::Pointd SCENECENTER(0,0,0);
 //----------------------------------------------------------------------------------------------
 
 
+//Interval between two updates of the progress of the algorithm
+//and between two refreshes of the canvas, in milliseconds
+const int algorithmProgressInterval = 100;
+const std::chrono::milliseconds canvasRefreshInterval(1000);
+
+//In the progressive view the canvas is refreshed at most progressiveFrameRate times per second
+const int progressiveFrameRate = 30;
+
+//In both views the algorithm is paused by the refreshes at most for a canvasRefreshBudget fraction of the time
+const double canvasRefreshBudget = 0.2;
+
+//A refresh waits at most canvasPauseTimeout for the algorithm to reach a consistent triangulation,
+//then it is tried again at the next update, so a long step doesn't freeze the interface
+const std::chrono::milliseconds canvasPauseTimeout(5);
+
+//Maximum number of flips highlighted in a refresh
+const size_t maxHighlightedFlips = 100000;
+
+//Maximum number of instances with a session journal
+const unsigned int maxSessions = 16;
+
+//The streaming algorithm collects the chunks in a pool of streamMixingPoints points,
+//a random half of the pool is inserted each time it is full
+const size_t streamMixingPoints = 4 * defaultStreamChunkPoints;
+
+//While the reader is behind, the streaming algorithm reaches a step every streamWaitStep, so it can be paused or cancelled
+const std::chrono::milliseconds streamWaitStep(10);
+
 
 /* ----- Constructors/Destructors ----- */
 
@@ -56,6 +99,7 @@ DelaunayManager::DelaunayManager(QWidget *parent) :
     mainWindow(static_cast<cg3::viewer::MainWindow&>(*parent)),
     boundingBox(cg3::Point2Dd(-BOUNDINGBOX, -BOUNDINGBOX),
                 cg3::Point2Dd(BOUNDINGBOX, BOUNDINGBOX)),
+    voronoiCellsVersion(0),
     boundingTriangle(BT_P1,
                      BT_P2,
                      BT_P3), //bounding triangle initialization
@@ -63,10 +107,14 @@ DelaunayManager::DelaunayManager(QWidget *parent) :
                           dag,
                           boundingTriangle.sceneCenter(),
                           boundingTriangle.sceneRadius()), //drawable triangulation initialization
-     voronoiDiagram(triangulation,
+     voronoiDiagram(voronoi,
+                    triangulation,
                     dag,
                     boundingTriangle.sceneCenter(),
-                    boundingTriangle.sceneRadius()) //drawable Voronoi initialization
+                    boundingTriangle.sceneRadius()), //drawable Voronoi initialization
+    algorithmTimer("Delaunay Triangulation generation", false),
+    recordFlips(false),
+    streamingAlgorithm(false)
 {
     //UI setup
     ui->setupUi(this);
@@ -102,6 +150,17 @@ DelaunayManager::DelaunayManager(QWidget *parent) :
     triangulation.addAdjacenciesForNewTriangle(noAdjacentTriangle, noAdjacentTriangle, noAdjacentTriangle);
     dag.addNode(Node(0));
 
+    //restore the points of a session that ended with a crash
+    restoreSession();
+
+    connect(&algorithmProgressTimer, SIGNAL(timeout()), this, SLOT(updateAlgorithmProgress()));
+
+    //the phases of the gui thread (loading, rendering) are traced with this name
+    Tracing::setThreadName("gui");
+
+    //the counters are compiled only with DELAUNAY_STATISTICS
+    ui->statisticsLabel->setVisible(DelaunayTriangulation::statisticsEnabled);
+
     mainWindow.updateGlCanvas();
     fitScene();
 
@@ -126,7 +185,14 @@ DelaunayManager::~DelaunayManager() {
     //      dynamicObject = nullptr;
     /********************************************************************************************************************/
 
-    /* WRITE YOUR CODE HERE! Read carefully the above comments! This line can be deleted */
+    //the algorithm uses the data structures, so it is stopped before them
+    algorithmProgressTimer.stop();
+    algorithmJob.cancel();
+    algorithmJob.join();
+
+    //the session ended without errors, so it doesn't need to be recovered
+    journalCommitTimer.stop();
+    journal.discard();
 
     /********************************************************************************************************************/
 
@@ -174,12 +240,63 @@ void DelaunayManager::computeDelaunayTriangulation(const std::vector<cg3::Point2
     //fills your output Triangulation data structure.
     /********************************************************************************************************************/
 
-    std::random_shuffle(points.begin(), points.end());
+    Tracing::Scope triangulationScope("triangulation");
+
+    if(loadedPointFile.isOpen())
+    {
+        //the points are gathered from the mapped file in random order, so they are copied and shuffled in a single pass
+        Tracing::Scope load("load");
+
+        std::vector<uint64_t> order(size_t(loadedPointFile.getPointNumber()));
+        for(size_t i = 0; i < order.size(); i++)
+        {
+            order[i] = i;
+        }
+        std::shuffle(order.begin(), order.end(), std::mt19937(std::random_device{}()));
+
+        points.resize(order.size());
+        long long pointNumber = (long long)(order.size());
+
+        #pragma omp parallel for
+        for(long long i = 0; i < pointNumber; i++)
+        {
+            points[size_t(i)] = loadedPointFile.getPoint(order[size_t(i)]);
+        }
+
+        loadedPointFile.close();
+    }
+    else
+    {
+        Tracing::Scope shuffle("shuffle");
+        std::random_shuffle(points.begin(), points.end());
+    }
+
+    //the canvas can be refreshed after the shuffle, before the first insertion
+    if(!algorithmJob.step(0))
+    {
+        return;
+    }
 
     unsigned int length = unsigned(inputPoints.size());
     for(unsigned int i = 0; i < length; i++)
     {
-         DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points[i]);
+         bool flips = recordFlips.load(std::memory_order_relaxed);
+
+         DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points[i], flips ? &insertionChanges : nullptr);
+
+         //the flips are read by the canvas refresh while the job is paused
+         if(flips && recentFlips.size() < maxHighlightedFlips)
+         {
+             recentFlips.insert(recentFlips.end(), insertionChanges.flips.begin(), insertionChanges.flips.end());
+         }
+
+         checkTopologyPeriodically(i + 1);
+
+         //the triangulation is consistent between two insertions, here the job can be paused or cancelled
+         if(!algorithmJob.step(i + 1))
+         {
+             break;
+         }
     }
 
     /********************************************************************************************************************/
@@ -194,10 +311,31 @@ void DelaunayManager::addPointToDelaunayTriangulation(const cg3::Point2Dd& p) {
     //Here you have to launch the incremental algorithm for the insertion of a new single point into the current triangulation.
     /********************************************************************************************************************/
 
+    //the triangulation is being computed by another thread
+    if(algorithmJob.isRunning())
+    {
+        return;
+    }
+
+    //the picked triangle may be split by the insertion
+    clearPickedElement();
+
     points.push_back(p);
     unsigned int pointIndex = unsigned(points.size() - 1);
 
-    DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points[pointIndex]);
+    DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points[pointIndex], &insertionChanges);
+
+    //a hidden diagram is rebuilt when it is shown again
+    if(mainWindow.contains(&voronoiDiagram))
+    {
+        voronoi.update(triangulation, dag, insertionChanges);
+    }
+
+    journal.appendInsert(points[pointIndex]);
+    if(journal.needsCheckpoint())
+    {
+        checkpointJournal();
+    }
 
     /********************************************************************************************************************/
     CG3_SUPPRESS_WARNING(p);
@@ -216,6 +354,13 @@ void DelaunayManager::clearDelaunayTriangulation() {
     //clear the DAG
     dag.clearDataStructure();
 
+    clearPickedElement();
+    ui->statisticsLabel->setText("");
+
+    //the journal restarts from the empty triangulation
+    journal.appendClear();
+    checkpointJournal();
+
     /********************************************************************************************************************/
 }
 
@@ -330,7 +475,428 @@ void DelaunayManager::checkTriangulation() {
 //Define your private methods here if you need some
 /********************************************************************************************************************/
 
-/* WRITE YOUR CODE HERE! Read carefully the above comments! This line can be deleted */
+/**
+ * @brief Launch the incremental algorithm on the points read by the stream
+ *
+ * Chunks are inserted while the reader thread parses the next ones. The file may be sorted (e.g. a grid written by rows),
+ * so the chunks are mixed in a pool and a random half of it is inserted each time it is full: the points are inserted
+ * in randomized rounds sorted along the Morton curve, which keep the DAG shallow and consecutive insertions close.
+ * @param[in] reader: the started reader
+ */
+void DelaunayManager::computeDelaunayTriangulationFromStream(PointStreamReader& reader)
+{
+    Tracing::Scope triangulationScope("triangulation");
+
+    std::mt19937 generator(std::random_device{}());
+
+    std::vector<cg3::Point2Dd> chunk;
+    std::vector<cg3::Point2Dd> pool;
+    std::vector<cg3::Point2Dd> rounds;
+
+    bool endOfFile = false;
+    while(!endOfFile)
+    {
+        //while the reader is behind the job can be paused or cancelled
+        while(!reader.waitForChunk(streamWaitStep))
+        {
+            if(!algorithmJob.step(points.size()))
+            {
+                return;
+            }
+        }
+
+        endOfFile = !reader.nextChunk(chunk);
+        if(!endOfFile)
+        {
+            pool.insert(pool.end(), chunk.begin(), chunk.end());
+        }
+
+        if(pool.size() < streamMixingPoints && !endOfFile)
+        {
+            continue;
+        }
+
+        //the whole pool at the end of the file
+        std::shuffle(pool.begin(), pool.end(), generator);
+        size_t kept = endOfFile ? 0 : pool.size() / 2;
+        rounds.assign(pool.begin() + std::ptrdiff_t(kept), pool.end());
+        pool.resize(kept);
+
+        if(!algorithmJob.step(points.size()))
+        {
+            return;
+        }
+
+        DelaunayTriangulation::sortPointsByRandomizedRounds(rounds, generator);
+
+        if(!algorithmJob.step(points.size()))
+        {
+            return;
+        }
+
+        for(const cg3::Point2Dd& point : rounds)
+        {
+            bool flips = recordFlips.load(std::memory_order_relaxed);
+
+            points.push_back(point);
+            DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points.back(), flips ? &insertionChanges : nullptr);
+
+            //the flips are read by the canvas refresh while the job is paused
+            if(flips && recentFlips.size() < maxHighlightedFlips)
+            {
+                recentFlips.insert(recentFlips.end(), insertionChanges.flips.begin(), insertionChanges.flips.end());
+            }
+
+            checkTopologyPeriodically(unsigned(points.size()));
+
+            //the triangulation is consistent between two insertions, here the job can be paused or cancelled
+            if(!algorithmJob.step(points.size()))
+            {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Check the topology of the triangulation every topologyCheckInterval insertions, only in debug builds
+ *
+ * Broken flips are found near the insertion that caused them.
+ * @param[in] insertedPoints: number of points inserted so far
+ */
+void DelaunayManager::checkTopologyPeriodically(unsigned int insertedPoints)
+{
+#ifdef DEBUG
+    if(insertedPoints % DelaunayTriangulation::Checker::topologyCheckInterval == 0)
+    {
+        const DelaunayTriangulation::Checker::TopologyReport report =
+                DelaunayTriangulation::Checker::checkTopology(triangulation, dag);
+        if(!report.isValid())
+        {
+            std::cerr << "Topology check failed after " << insertedPoints << " points: " << report << std::endl;
+        }
+    }
+#else
+    CG3_SUPPRESS_WARNING(insertedPoints);
+#endif
+}
+
+/**
+ * @brief Show a warning if some lines of the loaded file were ignored or if some points are missing
+ * @param[in] report: the ignored lines and the declared and read points of the file
+ */
+void DelaunayManager::warnPointFileReport(const FileUtils::PointFileReport& report)
+{
+    QStringList warnings;
+
+    if(report.hasCountMismatch()) {
+        warnings << "The file declares " + QString::number(report.declaredPoints) + " points, but " +
+                    QString::number(report.readPoints) + " points were read.";
+    }
+    if(!report.malformedLines.empty()) {
+        warnings << QString::number(report.malformedLines.size()) + " lines were ignored, the first one is line " +
+                    QString::number(report.malformedLines.front()) + ".";
+    }
+
+    if(!warnings.isEmpty()) {
+        QMessageBox::warning(this, "Malformed points file", warnings.join("\n"));
+    }
+}
+
+/**
+ * @brief Open the journal of the session, replaying the operations of a previous session that ended with a crash
+ *
+ * The journal is stored in the data directory of the application; its records are committed in groups
+ * by the insertions and by a timer, so at most the last groupCommitDelay of editing is lost.
+ * Each running instance locks its own session: the lock of an instance that crashed is stale,
+ * so the next instance takes its session and recovers it.
+ */
+void DelaunayManager::restoreSession()
+{
+    QString directory = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation);
+    if(directory.isEmpty() || !QDir().mkpath(directory))
+    {
+        std::cerr << "The session journal can't be created, the session will not be recovered after a crash" << std::endl;
+        return;
+    }
+
+    QString session;
+    for(unsigned int i = 0; i < maxSessions && session.isEmpty(); i++)
+    {
+        QString name = i == 0 ? QString("session") : "session-" + QString::number(i);
+
+        std::unique_ptr<QLockFile> lock(new QLockFile(QDir(directory).filePath(name + ".lock")));
+        //the lock is held for the whole session, only the locks of dead processes are stale
+        lock->setStaleLockTime(0);
+        if(lock->tryLock(0))
+        {
+            sessionLock = std::move(lock);
+            session = name;
+        }
+    }
+
+    if(session.isEmpty())
+    {
+        std::cerr << "The session journals are used by other instances, the session will not be recovered after a crash" << std::endl;
+        return;
+    }
+
+    std::string basename = QDir(directory).filePath(session).toStdString();
+    if(!journal.open(basename, triangulation, dag, points))
+    {
+        std::cerr << "The session journal " << basename << " can't be opened, the session will not be recovered after a crash" << std::endl;
+        return;
+    }
+
+    if(!points.empty())
+    {
+        std::cout << "Restored " << points.size() << " points of the previous session (" <<
+                     journal.getReplayedRecords() << " operations replayed)" << std::endl;
+    }
+
+    if(journal.needsCheckpoint())
+    {
+        checkpointJournal();
+    }
+
+    connect(&journalCommitTimer, SIGNAL(timeout()), this, SLOT(commitJournal()));
+    journalCommitTimer.start(int(groupCommitDelay.count()));
+}
+
+/**
+ * @brief Store the current triangulation as the checkpoint of the journal
+ *
+ * After the algorithm it is called by the job, which still owns the data structures, so the canvas is not blocked.
+ * Nothing is written if the journal is not open or if the triangulation didn't change since the last checkpoint.
+ */
+void DelaunayManager::checkpointJournal()
+{
+    if(journal.isOpen() && !journal.checkpoint(triangulation, dag))
+    {
+        std::cerr << "The checkpoint of the session journal can't be written" << std::endl;
+    }
+}
+
+/**
+ * @brief Enable the progress of the algorithm and disable the buttons that use the triangulation while it is computed
+ * @param[in] running: true if the algorithm is running
+ */
+void DelaunayManager::setAlgorithmRunning(const bool running)
+{
+    ui->algorithmProgressBar->setEnabled(running);
+    ui->cancelAlgorithmPushButton->setEnabled(running);
+
+    ui->loadPointsPushButton->setEnabled(!running);
+    ui->clearPointsPushButton->setEnabled(!running);
+    ui->checkTriangulationPushButton->setEnabled(!running);
+    ui->voronoiDiagramPushButton->setEnabled(!running);
+    ui->clearVoronoiDiagramPushButton->setEnabled(!running);
+    ui->saveSnapshotPushButton->setEnabled(!running);
+    ui->loadSnapshotPushButton->setEnabled(!running);
+    ui->exportTriangulationPushButton->setEnabled(!running);
+    ui->renderImagePushButton->setEnabled(!running);
+    ui->exportTracePushButton->setEnabled(!running);
+
+    //the drawables show the last refreshed triangulation while it is modified
+    drawableTriangulation.setFrozen(running);
+    voronoiDiagram.setFrozen(running);
+}
+
+/**
+ * @brief Highlight the triangle containing a point and its closest vertex, showing their attributes
+ *
+ * The triangle is found with the DAG, so picking takes the time of the point location of an insertion.
+ * @param[in] p: the clicked point
+ */
+void DelaunayManager::pickTriangulationElement(const cg3::Point2Dd& p)
+{
+    //the triangulation is being computed by another thread
+    if(algorithmJob.isRunning())
+    {
+        return;
+    }
+
+    //the cell of the picked vertex is shown with the diagram, the cells are clipped only if the diagram changed
+    bool cellShown = mainWindow.contains(&voronoiDiagram);
+    if(cellShown)
+    {
+        voronoiDiagram.refresh();
+        if(voronoiCellsVersion != voronoi.getVersion())
+        {
+            voronoiCells.build(voronoi, cg3::Point2Dd(-BOUNDINGBOX, -BOUNDINGBOX), cg3::Point2Dd(BOUNDINGBOX, BOUNDINGBOX));
+            voronoiCellsVersion = voronoi.getVersion();
+        }
+    }
+
+    cg3::Timer t("Triangulation picking");
+
+    DelaunayTriangulation::PickedElement element = DelaunayTriangulation::pickElement(triangulation, dag, p);
+    if(element.triangle == noAdjacentTriangle)
+    {
+        clearPickedElement();
+        mainWindow.updateGlCanvas();
+        return;
+    }
+
+    unsigned int triangleIndex = unsigned(element.triangle);
+    const Triangle& triangle = triangulation.getTriangles()[triangleIndex];
+    const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(triangleIndex);
+    const cg3::Point2Dd vertex = DelaunayTriangulation::getCorner(triangle, element.corner);
+    unsigned int incidentTriangles = DelaunayTriangulation::countIncidentTriangles(triangulation, triangleIndex, element.corner);
+
+    t.stop();
+
+    drawableTriangulation.setPickedElement(triangle, vertex);
+
+    bool boundingVertex = vertex == BT_P1 || vertex == BT_P2 || vertex == BT_P3;
+
+    QString cell;
+    if(cellShown && !boundingVertex)
+    {
+        int site = voronoi.findCell(vertex);
+        if(site != noSite && size_t(site) < voronoiCells.getCellNumber())
+        {
+            cg3::Point2Dd centroid = voronoiCells.getCentroid(size_t(site));
+            cell = "\nVoronoi cell: area " + QString::number(voronoiCells.getArea(size_t(site))) +
+                   ", centroid [" + QString::number(centroid.x()) + "," + QString::number(centroid.y()) + "]";
+        }
+    }
+
+    ui->pickLabel->setText("Triangle " + QString::number(triangleIndex) +
+                           ": area " + QString::number(DelaunayTriangulation::getArea(triangle)) +
+                           ", adjacent " + QString::number(adjacencies[v1v2Edge]) + " " +
+                           QString::number(adjacencies[v2v3Edge]) + " " + QString::number(adjacencies[v3v1Edge]) +
+                           "\nVertex [" + QString::number(vertex.x()) + "," + QString::number(vertex.y()) + "]" +
+                           (boundingVertex ? " of the bounding triangle" : "") +
+                           ": " + QString::number(incidentTriangles) + " triangles" + cell +
+                           "\nPicked in " + QString::number(t.delay()) + " secs");
+
+    mainWindow.updateGlCanvas();
+}
+
+/**
+ * @brief Remove the highlight and the attributes of the picked triangle
+ */
+void DelaunayManager::clearPickedElement()
+{
+    drawableTriangulation.clearPickedElement();
+    ui->pickLabel->setText("");
+}
+
+/**
+ * @brief Print the counters of the last run of the algorithm and show them under its time
+ */
+void DelaunayManager::showAlgorithmStatistics()
+{
+    if(!DelaunayTriangulation::statisticsEnabled)
+    {
+        return;
+    }
+
+    std::ostringstream stream;
+    stream << algorithmStatistics;
+
+    std::cout << "Statistics: " << stream.str() << std::endl;
+    ui->statisticsLabel->setText(QString::fromStdString(stream.str()));
+}
+
+/**
+ * @brief Print the memory of the triangulation, of the points and of the structures derived from them
+ *
+ * The derived structures are the Voronoi diagram, the buffers of the drawable triangulation and the changes of the insertions:
+ * the diagram and the buffers are refreshed first, so they are the ones of the measured triangulation.
+ * A hidden diagram is not refreshed, it is rebuilt when it is shown again.
+ */
+void DelaunayManager::showMemoryReport()
+{
+    drawableTriangulation.refresh();
+    if(mainWindow.contains(&voronoiDiagram))
+    {
+        voronoiDiagram.refresh();
+    }
+
+    DelaunayTriangulation::MemoryReport report = DelaunayTriangulation::measureMemory(triangulation, dag, this->points);
+
+    DelaunayTriangulation::MemoryUsage changes;
+    changes.name = "insertion changes";
+    changes.add(insertionChanges.destroyed);
+    changes.add(insertionChanges.flips);
+    changes.add(recentFlips);
+
+    report.structures.push_back(voronoi.getMemoryUsage());
+    report.structures.push_back(drawableTriangulation.getMemoryUsage());
+    report.structures.push_back(changes);
+
+    std::cout << "Memory:" << std::endl << report << std::endl;
+}
+
+/**
+ * @brief Show the time of the finished algorithm and draw its triangulation
+ *
+ * If the algorithm was cancelled only the inserted points are kept, so the points are the vertices of the triangulation.
+ */
+void DelaunayManager::finishAlgorithm()
+{
+    algorithmProgressTimer.stop();
+    algorithmJob.join();
+
+    //Timer stop and visualization (both on console and UI), the time on the UI doesn't include the refreshes
+    algorithmTimer.stopAndPrint();
+
+    double compute = algorithmJob.getComputeTime();
+    uint64_t inserted = algorithmJob.getDone();
+
+    if(algorithmJob.isCancelled())
+    {
+        this->points.resize(size_t(inserted));
+        std::cout << "Cancelled after " << inserted << " points" << std::endl;
+    }
+
+    //the time spent waiting for the reader is not part of the computation
+    double ioWait = 0;
+    if(streamingAlgorithm)
+    {
+        streamReader.stop();
+        ioWait = streamReader.getWaitTime();
+        compute -= ioWait;
+    }
+
+    std::cout << "[" << compute << " secs]\tcompute, " << inserted << " points" << std::endl;
+    if(streamingAlgorithm)
+    {
+        std::cout << "[" << ioWait << " secs]\tI/O wait" << std::endl;
+    }
+    showAlgorithmStatistics();
+    showMemoryReport();
+    std::cout << std::endl;
+
+    if(streamingAlgorithm)
+    {
+        ui->timeLabel->setText(QString::number(compute) + " (I/O wait " + QString::number(ioWait) + ")");
+        ui->algorithmProgressBar->setRange(0, int(inserted));
+    }
+    else
+    {
+        ui->timeLabel->setNum(compute);
+    }
+    ui->algorithmProgressBar->setValue(ui->algorithmProgressBar->maximum());
+
+    recentFlips.clear();
+    drawableTriangulation.clearHighlightedFlips();
+
+    setAlgorithmRunning(false);
+
+    //Draw Delaunay Triangulation
+    drawDelaunayTriangulation();
+
+    if(streamingAlgorithm)
+    {
+        streamingAlgorithm = false;
+        warnPointFileReport(streamReader.getReport());
+    }
+
+    loadedSnapshot.close();
+}
 
 /********************************************************************************************************************/
 
@@ -369,6 +935,156 @@ void DelaunayManager::on_clearVoronoiDiagramPushButton_clicked() {
     }
 }
 
+/**
+ * @brief Commits the operations of the journal that are still pending
+ */
+void DelaunayManager::commitJournal() {
+    //the job may be writing a checkpoint, the records are appended only when it is not running
+    if(algorithmJob.isRunning())
+    {
+        return;
+    }
+
+    if(!journal.commit())
+    {
+        std::cerr << "The session journal can't be written" << std::endl;
+    }
+}
+
+/**
+ * @brief Shows the inserted points and the remaining time, refreshing the canvas periodically
+ *
+ * The drawables are rebuilt while the job is paused between two insertions, so they are rebuilt from a consistent triangulation,
+ * and they are drawn after the job is resumed. In both views the time between two refreshes grows with the time
+ * of the rebuild, so the insertions and the canvas are slowed down by a bounded fraction on large triangulations.
+ */
+void DelaunayManager::updateAlgorithmProgress() {
+    if(algorithmJob.isFinished())
+    {
+        finishAlgorithm();
+        return;
+    }
+
+    //the streaming algorithm doesn't know the number of points, its progress bar shows only that it is running
+    if(algorithmJob.getTotal() > 0)
+    {
+        double remainingTime = algorithmJob.getRemainingTime();
+        ui->algorithmProgressBar->setValue(int(algorithmJob.getDone()));
+        ui->algorithmProgressBar->setFormat(remainingTime < 0 ? QString("%v / %m") :
+                                            "%v / %m, " + QString::number(remainingTime, 'f', 1) + " s left");
+    }
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if(now >= nextCanvasRefresh && algorithmJob.pause(canvasPauseTimeout))
+    {
+        drawableTriangulation.refresh();
+        if(mainWindow.contains(&voronoiDiagram))
+        {
+            voronoiDiagram.refresh();
+        }
+
+        if(recordFlips)
+        {
+            drawableTriangulation.setHighlightedFlips(recentFlips);
+        }
+        recentFlips.clear();
+
+        algorithmJob.resume();
+
+        std::chrono::steady_clock::duration refreshTime = std::chrono::steady_clock::now() - now;
+        std::chrono::steady_clock::duration refreshInterval = ui->progressiveViewCheckBox->isChecked() ?
+                    std::chrono::steady_clock::duration(std::chrono::milliseconds(1000 / progressiveFrameRate)) :
+                    std::chrono::steady_clock::duration(canvasRefreshInterval);
+        nextCanvasRefresh = now + std::max(refreshInterval,
+                                           std::chrono::duration_cast<std::chrono::steady_clock::duration>(refreshTime / canvasRefreshBudget));
+
+        mainWindow.updateGlCanvas();
+    }
+}
+
+/**
+ * @brief Stops the algorithm after the point it is inserting
+ */
+void DelaunayManager::on_cancelAlgorithmPushButton_clicked() {
+    algorithmJob.cancel();
+}
+
+/**
+ * @brief Progressive view checkbox handler.
+ *
+ * In the progressive view the canvas shows the triangulation while it grows, at a bounded frame rate.
+ *
+ * @param[in] arg1 It contains Qt::Checked if the checkbox is checked,
+ * Qt::Unchecked otherwise
+ */
+void DelaunayManager::on_progressiveViewCheckBox_stateChanged(int arg1) {
+    if(algorithmProgressTimer.isActive())
+    {
+        algorithmProgressTimer.start(arg1 == Qt::Checked ? 1000 / progressiveFrameRate : algorithmProgressInterval);
+        nextCanvasRefresh = std::chrono::steady_clock::now();
+    }
+}
+
+/**
+ * @brief Highlight flips checkbox handler.
+ *
+ * The edges flipped since the previous refresh of the canvas are highlighted while the triangulation is computed.
+ *
+ * @param[in] arg1 It contains Qt::Checked if the checkbox is checked,
+ * Qt::Unchecked otherwise
+ */
+void DelaunayManager::on_highlightFlipsCheckBox_stateChanged(int arg1) {
+    recordFlips = arg1 == Qt::Checked;
+
+    if(!recordFlips)
+    {
+        drawableTriangulation.clearHighlightedFlips();
+        mainWindow.updateGlCanvas();
+    }
+}
+
+/**
+ * @brief Pick triangles checkbox handler.
+ *
+ * While it is checked the clicked points pick the triangles instead of being inserted.
+ *
+ * @param[in] arg1 It contains Qt::Checked if the checkbox is checked,
+ * Qt::Unchecked otherwise
+ */
+void DelaunayManager::on_pickCheckBox_stateChanged(int arg1) {
+    if(arg1 != Qt::Checked)
+    {
+        clearPickedElement();
+        mainWindow.updateGlCanvas();
+    }
+}
+
+/**
+ * @brief Performance overlay checkbox handler.
+ *
+ * The overlay shows the draw calls, the primitives, the uploaded bytes and the times of the last frame,
+ * and a graph of the times of the last frames drawn by the canvas.
+ *
+ * @param[in] arg1 It contains Qt::Checked if the checkbox is checked,
+ * Qt::Unchecked otherwise
+ */
+void DelaunayManager::on_performanceOverlayCheckBox_stateChanged(int arg1) {
+    mainWindow.setPerformanceOverlayShown(arg1 == Qt::Checked);
+}
+
+/**
+ * @brief Tracing checkbox handler.
+ *
+ * The phases opened while the tracing is off are neither aggregated
+ * nor kept in the trace.
+ *
+ * @param[in] arg1 It contains Qt::Checked if the checkbox is checked,
+ * Qt::Unchecked otherwise
+ */
+void DelaunayManager::on_tracingCheckBox_stateChanged(int arg1) {
+    Tracing::setEnabled(arg1 == Qt::Checked);
+}
+
 /********************************************************************************************************************/
 
 
@@ -385,22 +1101,137 @@ void DelaunayManager::on_clearVoronoiDiagramPushButton_clicked() {
  * @brief Launch the algorithm for computing the Delaunay Triangulation
  * on the input points (a vector) of this manager and measure
  * its time efficiency.
+ *
+ * The algorithm runs on another thread, finishAlgorithm shows
+ * its time and draws the triangulation when it ends.
  */
 void DelaunayManager::launchAlgorithmAndMeasureTime() { //Do not write code here
+    //the points of a binary file are read by the job
+    size_t pointNumber = loadedPointFile.isOpen() ? size_t(loadedPointFile.getPointNumber()) : this->points.size();
+
     //Output message
-    std::cout << "Executing the algorithm for " << this->points.size() << " points..." << std::endl;
+    std::cout << "Executing the algorithm for " << pointNumber << " points..." << std::endl;
+
+    ui->timeLabel->setText("");
+    ui->statisticsLabel->setText("");
+    ui->algorithmProgressBar->setRange(0, int(pointNumber));
+    ui->algorithmProgressBar->setValue(0);
+    ui->algorithmProgressBar->setFormat("%v / %m");
+
+    clearPickedElement();
+    setAlgorithmRunning(true);
 
     //Timer for evaluating the efficiency of the algorithm
-    cg3::Timer t("Delaunay Triangulation generation");
+    algorithmTimer.start();
 
     //Launch delaunay algorithm on the vector of input points
-    computeDelaunayTriangulation(this->points);
+    algorithmJob.start([this]() {
+        Tracing::setThreadName("algorithm");
+        DelaunayTriangulation::resetStatistics();
+        computeDelaunayTriangulation(this->points);
+        algorithmStatistics = DelaunayTriangulation::getStatistics();
+
+        //the loaded points are not in the journal, the checkpoint is not part of the measured time
+        algorithmJob.endSteps();
+        checkpointJournal();
+    }, pointNumber);
+
+    //the progressive view shows the triangulation from the first points
+    bool progressive = ui->progressiveViewCheckBox->isChecked();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    nextCanvasRefresh = progressive ? now : now + canvasRefreshInterval;
+    algorithmProgressTimer.start(progressive ? 1000 / progressiveFrameRate : algorithmProgressInterval);
+}
+
+/**
+ * @brief Launch the algorithm while the file is read by another
+ * thread and measure separately the time spent waiting for the
+ * reader and the time spent computing.
+ *
+ * The algorithm runs on the job like the one on the loaded points,
+ * so it can be cancelled and the canvas shows its progress.
+ * @param[in] filename: the path of the points file
+ * @return flag: false if the file can't be read
+ */
+bool DelaunayManager::launchStreamingAlgorithmAndMeasureTime(const std::string& filename) {
+    this->points.clear();
 
-    //Timer stop and visualization (both on console and UI)
-    t.stopAndPrint();
-    ui->timeLabel->setNum(t.delay());
+    if (!streamReader.start(filename)) {
+        return false;
+    }
 
-    std::cout << std::endl;
+    //Output message
+    std::cout << "Executing the algorithm while reading the points..." << std::endl;
+
+    ui->timeLabel->setText("");
+    ui->statisticsLabel->setText("");
+    //the number of points is known only at the end of the file
+    ui->algorithmProgressBar->setRange(0, 0);
+    ui->algorithmProgressBar->setValue(0);
+
+    clearPickedElement();
+    setAlgorithmRunning(true);
+    streamingAlgorithm = true;
+
+    //Timer for evaluating the efficiency of the algorithm
+    algorithmTimer.start();
+
+    //Launch delaunay algorithm on the points of the reader
+    algorithmJob.start([this]() {
+        Tracing::setThreadName("algorithm");
+        DelaunayTriangulation::resetStatistics();
+        computeDelaunayTriangulationFromStream(streamReader);
+        algorithmStatistics = DelaunayTriangulation::getStatistics();
+
+        //the read points are not in the journal, the checkpoint is not part of the measured time
+        algorithmJob.endSteps();
+        checkpointJournal();
+    }, 0);
+
+    //the progressive view shows the triangulation from the first points
+    bool progressive = ui->progressiveViewCheckBox->isChecked();
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    nextCanvasRefresh = progressive ? now : now + canvasRefreshInterval;
+    algorithmProgressTimer.start(progressive ? 1000 / progressiveFrameRate : algorithmProgressInterval);
+
+    return true;
+}
+
+/**
+ * @brief Restore the snapshot with the DAG on another thread
+ * and measure its time.
+ *
+ * The restore can't be paused or cancelled, so the canvas is not
+ * refreshed until finishAlgorithm draws the triangulation.
+ */
+void DelaunayManager::launchRestoreAndMeasureTime() {
+    //Output message
+    std::cout << "Restoring the triangulation of " << this->points.size() << " points..." << std::endl;
+
+    ui->timeLabel->setText("");
+    ui->statisticsLabel->setText("");
+    ui->algorithmProgressBar->setRange(0, 0);
+    ui->algorithmProgressBar->setValue(0);
+
+    clearPickedElement();
+    setAlgorithmRunning(true);
+    ui->cancelAlgorithmPushButton->setEnabled(false);
+
+    //Timer for evaluating the efficiency of the restore
+    algorithmTimer.start();
+
+    algorithmJob.start([this]() {
+        Tracing::setThreadName("algorithm");
+        loadedSnapshot.restore(triangulation, dag);
+        algorithmJob.step(this->points.size());
+
+        //the restored points are not in the journal, the checkpoint is not part of the measured time
+        algorithmJob.endSteps();
+        checkpointJournal();
+    }, this->points.size());
+
+    nextCanvasRefresh = std::chrono::steady_clock::time_point::max();
+    algorithmProgressTimer.start(algorithmProgressInterval);
 }
 
 /**
@@ -426,7 +1257,7 @@ void DelaunayManager::on_loadPointsPushButton_clicked() { //Do not write code he
     QString filename = QFileDialog::getOpenFileName(nullptr,
                        "Open points",
                        ".",
-                       "*.txt");
+                       "Points (*.txt *.gpts)");
 
     if (!filename.isEmpty()) {
         //Clear current data
@@ -435,15 +1266,39 @@ void DelaunayManager::on_loadPointsPushButton_clicked() { //Do not write code he
         //Delete from the canvas the Delaunay Triangulation
         eraseDrawnDelaunayTriangulation();
 
+        //Read the file while the points are inserted
+        if (ui->streamingLoadCheckBox->isChecked()) {
+            if (!launchStreamingAlgorithmAndMeasureTime(filename.toStdString())) {
+                QMessageBox::warning(this, "Cannot load points", "The file is not a valid points file.");
+            }
+            return;
+        }
+
         //Load input points in the vector (deleting the previous ones)
-        this->points = FileUtils::getPointsFromFile(filename.toStdString());
+        FileUtils::PointFileReport report;
+        bool loaded = false;
+        {
+            Tracing::Scope load("load");
+            if(FileUtils::isBinaryPointFile(filename.toStdString())) {
+                //only the header is read here, the job takes the points from the mapped file
+                loaded = loadedPointFile.open(filename.toStdString());
+                this->points.clear();
+            }
+            else {
+                loaded = FileUtils::loadPointsFromFile(filename.toStdString(), this->points, report);
+            }
+        }
+
+        if(!loaded) {
+            QMessageBox::warning(this, "Cannot load points", "The file is not a valid points file.");
+            return;
+        }
+
+        warnPointFileReport(report);
 
         //Launch the algorithm on the current vector of points and measure
-        //its efficiency with a timer
+        //its efficiency with a timer, the triangulation is drawn when it ends
         launchAlgorithmAndMeasureTime();
-
-        //Draw Delaunay Triangulation
-        drawDelaunayTriangulation();
     }
 }
 
@@ -486,6 +1341,9 @@ void DelaunayManager::point2DClicked(const cg3::Point2Dd& p) { //Do not write co
                              "] is not contained in the bounding box.");
         return;
     }
+    else if (ui->pickCheckBox->isChecked()) {
+        pickTriangulationElement(p);
+    }
     else {
         addPointToDelaunayTriangulation(p);
     }
@@ -534,7 +1392,7 @@ void DelaunayManager::on_generatePointsFilePushButton_clicked() { //Do not write
     QString filename = QFileDialog::getSaveFileName(nullptr,
                        "File containing points",
                        ".",
-                       "TXT(*.txt)", &selectedFilter);
+                       "TXT(*.txt);;GPTS(*.gpts)", &selectedFilter);
 
     if (!filename.isEmpty()){
         int number = QInputDialog::getInt(
@@ -542,11 +1400,233 @@ void DelaunayManager::on_generatePointsFilePushButton_clicked() { //Do not write
                     tr("Generate file"),
                     tr("Number of random points:"), 1000, 0, 1000000000, 1);
 
-        //Generate points and save them in the chosen file
-        FileUtils::generateRandomPointFile(filename.toStdString(), BOUNDINGBOX, number);
+        QStringList distributions;
+        for (unsigned int i = 0; i < FileUtils::distributionNumber; i++) {
+            distributions << FileUtils::distributionNames[i];
+        }
+
+        bool selected = false;
+        QString distribution = QInputDialog::getItem(
+                    this,
+                    tr("Generate file"),
+                    tr("Distribution of points:"), distributions, 0, false, &selected);
+
+        if (selected) {
+            //Generate points and save them in the chosen file
+            bool binary = selectedFilter.startsWith("GPTS") || filename.endsWith(".gpts");
+            if (!FileUtils::generatePointFile(filename.toStdString(), BOUNDINGBOX, uint64_t(number),
+                                              unsigned(distributions.indexOf(distribution)), binary, std::random_device()())) {
+                QMessageBox::warning(this, "Cannot generate points", "The file can't be written.");
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Convert points file handler.
+ *
+ * It converts a text file of points in a binary file
+ * that can be loaded without parsing.
+ */
+void DelaunayManager::on_convertPointsFilePushButton_clicked() {
+    QString textFilename = QFileDialog::getOpenFileName(nullptr,
+                           "Text file containing points",
+                           ".",
+                           "TXT(*.txt)");
+
+    if (!textFilename.isEmpty()) {
+        QString binaryFilename = QFileDialog::getSaveFileName(nullptr,
+                                 "Binary file containing points",
+                                 ".",
+                                 "GPTS(*.gpts)");
+
+        if (!binaryFilename.isEmpty()) {
+            FileUtils::PointFileReport report;
+            if (!FileUtils::convertTextToBinaryPointFile(textFilename.toStdString(), binaryFilename.toStdString(), report)) {
+                QMessageBox::warning(this, "Cannot convert points", "The file can't be converted.");
+            }
+            else {
+                warnPointFileReport(report);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Save snapshot handler.
+ *
+ * It saves the current triangulation in a file that can be
+ * mapped in memory, with the DAG if the checkbox is checked.
+ */
+void DelaunayManager::on_saveSnapshotPushButton_clicked() {
+    QString filename = QFileDialog::getSaveFileName(nullptr,
+                       "Triangulation snapshot",
+                       ".",
+                       "GSNAP(*.gsnap)");
+
+    if (!filename.isEmpty()) {
+        if (!FileUtils::saveTriangulationSnapshot(filename.toStdString(), triangulation, dag,
+                                                  ui->snapshotWithDagCheckBox->isChecked())) {
+            QMessageBox::warning(this, "Cannot save snapshot", "The file can't be written.");
+        }
     }
 }
 
+/**
+ * @brief Load snapshot handler.
+ *
+ * It restores the triangulation saved in a snapshot: with the DAG
+ * the data structures are copied from the mapped file, otherwise
+ * the triangulation is computed again from its vertices.
+ */
+void DelaunayManager::on_loadSnapshotPushButton_clicked() {
+    QString filename = QFileDialog::getOpenFileName(nullptr,
+                       "Triangulation snapshot",
+                       ".",
+                       "GSNAP(*.gsnap)");
+
+    if (!filename.isEmpty()) {
+        if (!loadedSnapshot.open(filename.toStdString())) {
+            QMessageBox::warning(this, "Cannot load snapshot", "The file is not a valid snapshot.");
+            return;
+        }
+
+        //Clear current data
+        clearDelaunayTriangulation();
+
+        //Delete from the canvas the Delaunay Triangulation
+        eraseDrawnDelaunayTriangulation();
+
+        //The input points are the vertices without the bounding triangle
+        this->points.clear();
+        for (uint64_t i = 0; i < loadedSnapshot.getVertexNumber(); i++) {
+            const cg3::Point2Dd vertex = loadedSnapshot.getVertex(i);
+            if (vertex != BT_P1 && vertex != BT_P2 && vertex != BT_P3) {
+                this->points.push_back(vertex);
+            }
+        }
+
+        //The triangulation is drawn when the job ends
+        if (!loadedSnapshot.hasDag()) {
+            loadedSnapshot.close();
+            launchAlgorithmAndMeasureTime();
+        }
+        else {
+            launchRestoreAndMeasureTime();
+        }
+    }
+}
+
+/**
+ * @brief Export triangulation handler.
+ *
+ * It exports the live triangles as an indexed mesh, in a text OBJ
+ * or in a binary PLY file. The triangles incident to the bounding
+ * triangle are exported only if the bounding triangle is shown.
+ */
+void DelaunayManager::on_exportTriangulationPushButton_clicked() {
+    QString selectedFilter;
+    QString filename = QFileDialog::getSaveFileName(nullptr,
+                       "Triangulation mesh",
+                       ".",
+                       "OBJ(*.obj);;PLY(*.ply)", &selectedFilter);
+
+    if (!filename.isEmpty()) {
+        bool withBoundingTriangle = ui->showBoundingTriangleCheckBox->isChecked();
+        bool ply = selectedFilter.startsWith("PLY") || filename.endsWith(".ply");
+
+        cg3::Timer t("Triangulation export");
+
+        bool exported = ply ?
+                    FileUtils::exportTriangulationToPly(filename.toStdString(), triangulation, dag, withBoundingTriangle) :
+                    FileUtils::exportTriangulationToObj(filename.toStdString(), triangulation, dag, withBoundingTriangle);
+
+        t.stopAndPrint();
+
+        if (!exported) {
+            QMessageBox::warning(this, "Cannot export triangulation", "The file can't be written.");
+        }
+    }
+}
+
+/**
+ * @brief Render image handler.
+ *
+ * It draws the bounding box in a PNG image without OpenGL, with the
+ * triangulation, its vertices and, if it is shown, the Voronoi diagram.
+ * The triangles incident to the bounding triangle are drawn only if
+ * the bounding triangle is shown.
+ */
+void DelaunayManager::on_renderImagePushButton_clicked() {
+    QString filename = QFileDialog::getSaveFileName(nullptr,
+                       "Triangulation image",
+                       ".",
+                       "PNG(*.png)");
+
+    if (!filename.isEmpty()) {
+        bool selected = false;
+        int size = QInputDialog::getInt(
+                    this,
+                    tr("Render image"),
+                    tr("Image size (pixels):"), 2048, 16, 16384, 1, &selected);
+
+        if (!selected) {
+            return;
+        }
+
+        cg3::Timer t("Triangulation rendering");
+        Tracing::Scope rendering("rendering");
+
+        unsigned int imageSize = unsigned(size);
+        SoftwareRenderer renderer(imageSize, imageSize,
+                                  cg3::Point2Dd(-BOUNDINGBOX, -BOUNDINGBOX),
+                                  cg3::Point2Dd(BOUNDINGBOX, BOUNDINGBOX));
+
+        renderer.drawTriangulation(triangulation, dag, ui->showBoundingTriangleCheckBox->isChecked(), renderTriangulationColor);
+
+        if (mainWindow.contains(&voronoiDiagram)) {
+            voronoi.update(triangulation, dag);
+            renderer.drawVoronoi(voronoi, renderVoronoiEdgeColor, renderVoronoiVertexColor, 3);
+        }
+
+        renderer.drawPoints(this->points, renderPointColor, 3);
+
+        bool saved = renderer.savePng(filename.toStdString());
+
+        t.stopAndPrint();
+
+        if (!saved) {
+            QMessageBox::warning(this, "Cannot render image", "The file can't be written.");
+        }
+    }
+}
+
+/**
+ * @brief Export trace handler.
+ *
+ * It prints the aggregated times of the traced phases and writes
+ * the traced scopes of all the threads in a Chrome trace file,
+ * then clears them, so the next trace starts from this export.
+ */
+void DelaunayManager::on_exportTracePushButton_clicked() {
+    QString filename = QFileDialog::getSaveFileName(nullptr,
+                       "Trace",
+                       ".",
+                       "Chrome trace(*.json)");
+
+    if (!filename.isEmpty()) {
+        Tracing::printPhaseStatistics(std::cout);
+        std::cout << std::endl;
+
+        if (!Tracing::exportChromeTrace(filename.toStdString())) {
+            QMessageBox::warning(this, "Cannot export trace", "The file can't be written.");
+        }
+
+        //the button is disabled while the algorithm runs, so no traced thread is running
+        Tracing::clear();
+    }
+}
 
 /**
  * @brief Check triangulation event handler.
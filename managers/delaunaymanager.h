@@ -2,18 +2,35 @@
 #define DELAUNAYMANAGER_H
 
 #include <QFrame>
+#include <QLockFile>
+#include <QTimer>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
 
 #include <cg3/viewer/mainwindow.h>
 
+#include <cg3/utilities/timer.h>
+
 #include <cg3/viewer/drawable_objects/2d/drawable_bounding_box2d.h>
 
 #include <data_structures/dag.h>
 #include <data_structures/triangulation.h>
+#include <data_structures/voronoicells.h>
+#include <data_structures/voronoidiagram.h>
 
 #include <drawables/drawabletriangle.h>
 #include <drawables/drawabletriangulation.h>
 #include <drawables/drawablevoronoi.h>
 
+#include <algorithms/insertionstatistics.h>
+
+#include <utils/backgroundjob.h>
+#include <utils/insertionjournal.h>
+#include <utils/pointstreamreader.h>
+#include <utils/triangulationsnapshot.h>
+
 
 namespace Ui {
     class DelaunayManager;
@@ -51,10 +68,48 @@ private:
     Triangulation triangulation;
     DAG dag;
 
+    //Voronoi diagram of the triangulation, rebuilt only when the triangulation changes
+    //and updated with the changes of each clicked point while it is shown
+    VoronoiDiagram voronoi;
+    DelaunayTriangulation::TriangulationChanges insertionChanges;
+
+    //cells of the diagram clipped to the bounding box, clipped again when a vertex is picked after the diagram changed
+    VoronoiCells voronoiCells;
+    unsigned long long voronoiCellsVersion;
+
     const DrawableTriangle boundingTriangle;
     DrawableTriangulation drawableTriangulation;
     DrawableVoronoi voronoiDiagram;
 
+    //Operations of the session, replayed after a crash; the lock keeps other instances from using the same journal
+    InsertionJournal journal;
+    QTimer journalCommitTimer;
+    std::unique_ptr<QLockFile> sessionLock;
+
+    //The algorithm runs on another thread: the timer shows its progress and refreshes the canvas
+    //while the job is paused, the time of the algorithm doesn't include the pauses
+    BackgroundJob algorithmJob;
+    QTimer algorithmProgressTimer;
+    cg3::Timer algorithmTimer;
+    std::chrono::steady_clock::time_point nextCanvasRefresh;
+
+    //Flips of the insertions since the last refresh of the canvas, recorded by the algorithm if they are highlighted
+    std::atomic<bool> recordFlips;
+    std::vector<unsigned int> recentFlips;
+
+    //Counters of the last run of the algorithm, copied from the thread that computed it
+    DelaunayTriangulation::InsertionStatistics algorithmStatistics;
+
+    //The streaming algorithm runs on the job too and reads the chunks parsed by the reader thread
+    PointStreamReader streamReader;
+    bool streamingAlgorithm;
+
+    //Binary point file read by the job, its points are copied from the mapping directly in random order
+    BinaryPointFile loadedPointFile;
+
+    //Snapshot with the DAG restored by the job
+    TriangulationSnapshot loadedSnapshot;
+
     /********************************************************************************************************************/
 
 
@@ -78,7 +133,23 @@ private:
     //Declare your private methods here if you need some
     /********************************************************************************************************************/
 
-    /* WRITE YOUR CODE HERE! Read carefully the above comments! This line can be deleted */
+    void computeDelaunayTriangulationFromStream(PointStreamReader& reader);
+
+    void checkTopologyPeriodically(unsigned int insertedPoints);
+
+    void warnPointFileReport(const FileUtils::PointFileReport& report);
+
+    void restoreSession();
+    void checkpointJournal();
+
+    void setAlgorithmRunning(const bool running);
+    void finishAlgorithm();
+
+    void pickTriangulationElement(const cg3::Point2Dd& p);
+    void clearPickedElement();
+
+    void showAlgorithmStatistics();
+    void showMemoryReport();
 
     /********************************************************************************************************************/
 
@@ -91,6 +162,16 @@ private slots:
     void on_voronoiDiagramPushButton_clicked();
     void on_clearVoronoiDiagramPushButton_clicked();
 
+    void commitJournal();
+
+    void updateAlgorithmProgress();
+    void on_cancelAlgorithmPushButton_clicked();
+    void on_progressiveViewCheckBox_stateChanged(int arg1);
+    void on_highlightFlipsCheckBox_stateChanged(int arg1);
+    void on_pickCheckBox_stateChanged(int arg1);
+    void on_performanceOverlayCheckBox_stateChanged(int arg1);
+    void on_tracingCheckBox_stateChanged(int arg1);
+
     /********************************************************************************************************************/
 
 
@@ -100,6 +181,8 @@ private:
 
     void fitScene();
     void launchAlgorithmAndMeasureTime();
+    bool launchStreamingAlgorithmAndMeasureTime(const std::string& filename);
+    void launchRestoreAndMeasureTime();
 
 
 private slots:
@@ -119,6 +202,14 @@ private slots:
     void on_resetScenePushButton_clicked();
 
     void on_generatePointsFilePushButton_clicked();	
+    void on_convertPointsFilePushButton_clicked();
+
+    void on_saveSnapshotPushButton_clicked();
+    void on_loadSnapshotPushButton_clicked();
+
+    void on_exportTriangulationPushButton_clicked();
+    void on_renderImagePushButton_clicked();
+    void on_exportTracePushButton_clicked();
 	
     void on_checkTriangulationPushButton_clicked();
 
@@ -0,0 +1,123 @@
+#include "tests.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include <utils/binarypointfile.h>
+
+namespace {
+
+const char* const binaryFilename = "binarypoints_test.gpts";
+const char* const textFilename = "binarypoints_test.txt";
+
+/**
+ * @brief Saves the points, opens the file and compares its points
+ * @param[in] points: the saved points
+ * @param[in] coordinateSize: FileUtils::floatCoordinates or FileUtils::doubleCoordinates
+ * @return flag: true if the file has the points converted to the size of its coordinates
+*/
+bool roundTrip(const std::vector<cg3::Point2Dd>& points, uint32_t coordinateSize)
+{
+    if(!FileUtils::savePointsToBinaryFile(binaryFilename, points, coordinateSize) || !FileUtils::isBinaryPointFile(binaryFilename))
+    {
+        return false;
+    }
+
+    BinaryPointFile file;
+    if(!file.open(binaryFilename) || file.getPointNumber() != points.size() || file.getCoordinateSize() != coordinateSize)
+    {
+        return false;
+    }
+
+    std::vector<cg3::Point2Dd> read;
+    file.getPoints(read);
+
+    bool equal = read.size() == points.size();
+    for(size_t i = 0; equal && i < points.size(); i++)
+    {
+        cg3::Point2Dd expected = coordinateSize == FileUtils::doubleCoordinates ? points[i] :
+                cg3::Point2Dd(double(float(points[i].x())), double(float(points[i].y())));
+        equal = read[i] == expected && file.getPoint(i) == expected;
+    }
+
+    return equal;
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Writes points in binary files with float and double coordinates and reads them back
+ *
+ * Also a text file converted to the binary format must give the same points, and a truncated file must be rejected.
+ */
+bool testBinaryPointFile()
+{
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    std::vector<cg3::Point2Dd> points;
+    for(unsigned int i = 0; i < 100000; i++)
+    {
+        points.push_back(cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    bool passed = check(roundTrip(points, FileUtils::doubleCoordinates), "the double coordinates are read back");
+    passed = check(roundTrip(points, FileUtils::floatCoordinates), "the float coordinates are read back") && passed;
+    passed = check(!FileUtils::savePointsToBinaryFile(binaryFilename, points, 2), "an unknown coordinate size is refused") && passed;
+
+    //the bounding box is written in the header
+    FileUtils::savePointsToBinaryFile(binaryFilename, points);
+    BinaryPointFile file;
+    file.open(binaryFilename);
+    bool inside = true;
+    for(const cg3::Point2Dd& point : points)
+    {
+        inside = inside && point.x() >= file.getMin().x() && point.y() >= file.getMin().y() &&
+                point.x() <= file.getMax().x() && point.y() <= file.getMax().y();
+    }
+    passed = check(file.isOpen() && inside, "the header has the bounding box of the points") && passed;
+    file.close();
+    passed = check(!file.isOpen() && file.getPointNumber() == 0, "a closed file has no points") && passed;
+
+    //a file without the last coordinate is rejected
+    std::vector<char> content;
+    {
+        std::ifstream input(binaryFilename, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream output(binaryFilename, std::ios::binary);
+        output.write(content.data(), std::streamsize(content.size() - sizeof(double)));
+    }
+    passed = check(!file.open(binaryFilename), "a truncated file is rejected") && passed;
+
+    //the conversion of a text file keeps the points
+    {
+        std::ofstream text(textFilename);
+        text.precision(17);
+        text << points.size() << "\n";
+        for(const cg3::Point2Dd& point : points)
+        {
+            text << point.x() << " " << point.y() << "\n";
+        }
+    }
+    FileUtils::PointFileReport report;
+    std::vector<cg3::Point2Dd> converted;
+    passed = check(!FileUtils::isBinaryPointFile(textFilename), "a text file is not a binary file") && passed;
+    passed = check(FileUtils::convertTextToBinaryPointFile(textFilename, binaryFilename, report), "the text file is converted") && passed;
+    passed = check(file.open(binaryFilename), "the converted file is opened") && passed;
+    file.getPoints(converted);
+    passed = check(converted == points, "the converted file has the points of the text file") && passed;
+    file.close();
+
+    std::remove(binaryFilename);
+    std::remove(textFilename);
+
+    return passed;
+}
+
+}
@@ -0,0 +1,95 @@
+#include "tests.h"
+
+#include <random>
+
+#include <algorithms/delaunay.h>
+#include <utils/delaunay_checker.h>
+
+namespace {
+
+/**
+ * @brief ReallocatingTriangulation: triangulation whose vectors can be made full
+ *
+ * With room for exactly the three triangles of the next insertion, the first flip of the insertion
+ * moves triangles and adjacencies while legalizeEdge is running.
+ */
+class ReallocatingTriangulation : public Triangulation
+{
+public:
+    void reserveExactly(size_t triangleNumber)
+    {
+        std::vector<Triangle> newTriangles;
+        newTriangles.reserve(triangleNumber);
+        newTriangles.insert(newTriangles.end(), triangles.begin(), triangles.end());
+        triangles.swap(newTriangles);
+
+        std::vector<std::array<int, maxAdjacentTriangles>> newAdjacencies;
+        newAdjacencies.reserve(triangleNumber);
+        newAdjacencies.insert(newAdjacencies.end(), adjacencies.begin(), adjacencies.end());
+        adjacencies.swap(newAdjacencies);
+    }
+};
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Inserts points with full vectors before each insertion and checks the final triangulation
+ *
+ * Each live triangle must be adjacent to triangles that know it, and each live triangle of the bounded points
+ * must pass the Delaunay check.
+ */
+bool testFlipAfterReallocation()
+{
+    ReallocatingTriangulation triangulation;
+    DAG dag;
+
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    for(unsigned int i = 0; i < 2000; i++)
+    {
+        triangulation.reserveExactly(triangulation.getTriangles().size() + 3);
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    bool passed = check(nodes.size() == triangles.size(), "the DAG has a node for each triangle");
+
+    unsigned int asymmetric = 0;
+    for(unsigned int t = 0; t < triangles.size() && passed; t++)
+    {
+        if(!nodes[t].isLeaf())
+        {
+            continue;
+        }
+        const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(t);
+        for(int adjacent : adjacencies)
+        {
+            if(adjacent == noAdjacentTriangle)
+            {
+                continue;
+            }
+            if(adjacent < 0 || unsigned(adjacent) >= triangles.size() || !nodes[unsigned(adjacent)].isLeaf() ||
+                    triangulation.findAdjacency(unsigned(adjacent), t) < 0)
+            {
+                asymmetric++;
+            }
+        }
+    }
+    passed = check(asymmetric == 0, "live triangles are adjacent to live triangles that know them") && passed;
+
+    std::vector<cg3::Point2Dd> points;
+    cg3::Array2D<unsigned int> triangleIndices;
+    DelaunayTriangulation::Checker::fillDataStructures(triangulation, dag, points, triangleIndices);
+    passed = check(DelaunayTriangulation::Checker::isDeulaunayTriangulation(points, triangleIndices), "the triangulation is Delaunay") && passed;
+
+    return passed;
+}
+
+}
@@ -0,0 +1,175 @@
+#include "tests.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include <algorithms/delaunay.h>
+#include <utils/insertionjournal.h>
+#include <utils/topology_checker.h>
+
+namespace {
+
+const char* const journalBasename = "journal_test";
+
+bool exists(const std::string& filename)
+{
+    return std::ifstream(filename).good();
+}
+
+std::string checkpointFilename(uint32_t slot)
+{
+    return std::string(journalBasename) + "." + std::to_string(slot) + ".gsnap";
+}
+
+std::string journalFilename()
+{
+    return std::string(journalBasename) + ".gjournal";
+}
+
+/**
+ * @brief Inserts random points in the triangulation and in the journal
+ * @param[in/out] journal: the open journal
+ * @param[in/out] triangulation: the triangulation data structure
+ * @param[in/out] dag: the search data structure
+ * @param[in/out] points: the inserted points
+ * @param[in] number: number of points to insert
+ * @param[in/out] generator: the random generator
+*/
+void insertPoints(InsertionJournal& journal, Triangulation& triangulation, DAG& dag, std::vector<cg3::Point2Dd>& points,
+                  unsigned int number, std::mt19937& generator)
+{
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+    for(unsigned int i = 0; i < number; i++)
+    {
+        points.push_back(cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points.back());
+        journal.appendInsert(points.back());
+    }
+}
+
+/**
+ * @brief Opens the journal on an empty triangulation and compares the restored points with the expected ones
+ * @param[out] journal: the journal to open
+ * @param[in] expected: the points inserted before closing the journal
+ * @param[in] liveTriangles: the live triangles of the triangulation before closing the journal
+ * @return flag: true if the restored triangulation has the same points and triangles and it is valid
+*/
+bool restoresPoints(InsertionJournal& journal, std::vector<cg3::Point2Dd> expected, unsigned int liveTriangles)
+{
+    Triangulation triangulation;
+    DAG dag;
+    Tests::addBoundingTriangle(triangulation, dag);
+
+    std::vector<cg3::Point2Dd> restored;
+    if(!journal.open(journalBasename, triangulation, dag, restored))
+    {
+        return false;
+    }
+
+    //the points of the checkpoint are restored in the order of the snapshot
+    const auto lexicographic = [](const cg3::Point2Dd& a, const cg3::Point2Dd& b) {
+        return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+    };
+    std::sort(expected.begin(), expected.end(), lexicographic);
+    std::sort(restored.begin(), restored.end(), lexicographic);
+
+    DelaunayTriangulation::Checker::TopologyReport report = DelaunayTriangulation::Checker::checkTopology(triangulation, dag);
+    return restored == expected && report.isValid() && report.liveTriangles == liveTriangles;
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Replays a journal whose last record was written only partially and rotates the checkpoint slots
+ *
+ * The broken record must be dropped with the file truncated before it, so new records follow the valid ones.
+ * Each checkpoint must be written in the slot not referenced by the journal on disk and remove the previous one.
+ */
+bool testInsertionJournal()
+{
+    std::remove(journalFilename().c_str());
+    std::remove(checkpointFilename(1).c_str());
+    std::remove(checkpointFilename(2).c_str());
+
+    InsertionJournal journal;
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+    std::vector<cg3::Point2Dd> points;
+    std::vector<cg3::Point2Dd> restored;
+
+    std::mt19937 generator(23);
+
+    bool passed = check(journal.open(journalBasename, triangulation, dag, restored) && restored.empty(), "a new journal is created");
+
+    insertPoints(journal, triangulation, dag, points, 100, generator);
+    journal.close();
+
+    //the last record loses its last bytes
+    std::vector<char> content;
+    {
+        std::ifstream input(journalFilename(), std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream output(journalFilename(), std::ios::binary);
+        output.write(content.data(), std::streamsize(content.size() - 10));
+    }
+
+    //the triangulation without the last point
+    Triangulation truncated;
+    DAG truncatedDag;
+    addBoundingTriangle(truncated, truncatedDag);
+    for(size_t i = 0; i + 1 < points.size(); i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(truncated, truncatedDag, points[i]);
+    }
+    points.pop_back();
+
+    unsigned int liveTriangles = DelaunayTriangulation::Checker::checkTopology(truncated, truncatedDag).liveTriangles;
+    passed = check(restoresPoints(journal, points, liveTriangles), "the records before the broken one are replayed") && passed;
+    passed = check(journal.getReplayedRecords() == 99, "the broken record is dropped") && passed;
+
+    //new records follow the valid ones
+    insertPoints(journal, truncated, truncatedDag, points, 10, generator);
+    journal.close();
+    liveTriangles = DelaunayTriangulation::Checker::checkTopology(truncated, truncatedDag).liveTriangles;
+    passed = check(restoresPoints(journal, points, liveTriangles) && journal.getReplayedRecords() == 109,
+                   "the records appended after the truncation are replayed") && passed;
+    journal.close();
+
+    //the checkpoints alternate between the two slots
+    restored.clear();
+    Triangulation rebuilt;
+    DAG rebuiltDag;
+    addBoundingTriangle(rebuilt, rebuiltDag);
+    passed = check(journal.open(journalBasename, rebuilt, rebuiltDag, restored), "the journal is opened again") && passed;
+
+    const uint32_t slots[] = {1, 2, 1};
+    for(uint32_t slot : slots)
+    {
+        insertPoints(journal, rebuilt, rebuiltDag, restored, 50, generator);
+        bool written = journal.checkpoint(rebuilt, rebuiltDag);
+        passed = check(written && exists(checkpointFilename(slot)) && !exists(checkpointFilename(slot == 1 ? 2 : 1)),
+                       "the checkpoint is written in the other slot and the old one is removed") && passed;
+    }
+
+    insertPoints(journal, rebuilt, rebuiltDag, restored, 5, generator);
+    journal.close();
+    liveTriangles = DelaunayTriangulation::Checker::checkTopology(rebuilt, rebuiltDag).liveTriangles;
+    passed = check(restoresPoints(journal, restored, liveTriangles) && journal.getReplayedRecords() == 5,
+                   "the last checkpoint is restored and only the records after it are replayed") && passed;
+
+    journal.discard();
+    passed = check(!exists(journalFilename()) && !exists(checkpointFilename(1)) && !exists(checkpointFilename(2)),
+                   "the discarded journal is removed with its checkpoints") && passed;
+
+    return passed;
+}
+
+}
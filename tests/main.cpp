@@ -0,0 +1,97 @@
+#include "tests.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+/* The freed memory is overwritten, so a test that reads through a reference
+ * into a reallocated vector reads garbage instead of the old values. */
+
+namespace {
+
+const size_t allocationHeader = alignof(std::max_align_t) > sizeof(size_t) ? alignof(std::max_align_t) : sizeof(size_t);
+
+const unsigned char freedByte = 0xAB;
+
+}
+
+void* operator new(size_t size)
+{
+    unsigned char* block = static_cast<unsigned char*>(std::malloc(size + allocationHeader));
+    if(block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    std::memcpy(block, &size, sizeof(size_t));
+    return block + allocationHeader;
+}
+
+void operator delete(void* pointer) noexcept
+{
+    if(pointer == nullptr)
+    {
+        return;
+    }
+    unsigned char* block = static_cast<unsigned char*>(pointer) - allocationHeader;
+    size_t size;
+    std::memcpy(&size, block, sizeof(size_t));
+    std::memset(pointer, freedByte, size);
+    std::free(block);
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+int main()
+{
+    struct Test
+    {
+        const char* name;
+        bool (*function)();
+    };
+
+    const Test tests[] = {
+        {"flip after reallocation", Tests::testFlipAfterReallocation},
+        {"corrupted snapshot", Tests::testCorruptedSnapshot},
+        {"Voronoi cells", Tests::testVoronoiCells},
+        {"mesh load and save", Tests::testMeshLoadSave},
+        {"serialized size check", Tests::testSerializedSizeCheck},
+        {"stream early stop", Tests::testStreamEarlyStop},
+        {"binary point file", Tests::testBinaryPointFile},
+        {"topology checker", Tests::testTopologyChecker},
+        {"point file parser", Tests::testPointFileParser},
+        {"insertion journal", Tests::testInsertionJournal},
+        {"incremental Voronoi", Tests::testIncrementalVoronoi},
+        {"picking", Tests::testPicking},
+    };
+
+    int failed = 0;
+    for(const Test& test : tests)
+    {
+        bool passed = test.function();
+        std::cout << (passed ? "PASS " : "FAIL ") << test.name << std::endl;
+        if(!passed)
+        {
+            failed++;
+        }
+    }
+
+    return failed;
+}
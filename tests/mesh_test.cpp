@@ -0,0 +1,121 @@
+#include "tests.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+
+#include <cg3/io/load_save_file.h>
+
+#include <algorithms/delaunay.h>
+#include <algorithms/indexedmesh.h>
+#include <utils/meshexporter.h>
+
+namespace {
+
+const char* const objFilename = "mesh_test.obj";
+const char* const plyFilename = "mesh_test.ply";
+
+void writeFile(const std::string& filename, const std::string& content)
+{
+    std::ofstream file(filename, std::ios::binary);
+    file << content;
+}
+
+/**
+ * @brief Loads an OBJ file written from a string
+ * @param[in] content: the text of the file
+ * @param[out] coords: the coordinates of the vertices
+ * @param[out] faces: the vertex indices of the faces
+ * @param[out] colors: the colors of the vertices
+ * @return flag: true if the file was loaded
+*/
+bool loadObj(const std::string& content, std::vector<double>& coords, std::vector<unsigned int>& faces, std::vector<cg3::Color>& colors)
+{
+    writeFile(objFilename, content);
+
+    cg3::loadSave::MeshType meshType;
+    int modality = 0;
+    std::vector<double> normals;
+    return cg3::loadSave::loadMeshFromObj(objFilename, coords, faces, meshType, modality, normals, colors);
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Loads OBJ vertices with a weight and with a color, and checks that the exported meshes are loaded back
+ *
+ * A vertex line can end with the weight w, that is ignored, or with a color r g b [alpha]; any other number of values is an error.
+ */
+bool testMeshLoadSave()
+{
+    std::vector<double> coords;
+    std::vector<unsigned int> faces;
+    std::vector<cg3::Color> colors;
+
+    bool loaded = loadObj("v 1 2 3 1.0\r\nv 4 5 6 1.0\nv 7 8 9 1.0\nf 1 2 3\n", coords, faces, colors);
+    bool passed = check(loaded, "vertices with a weight are loaded");
+    passed = check(coords == std::vector<double>({1, 2, 3, 4, 5, 6, 7, 8, 9}), "the weights are not read as coordinates") && passed;
+    passed = check(faces == std::vector<unsigned int>({0, 1, 2}), "the face of the vertices with a weight is loaded") && passed;
+    passed = check(colors.empty(), "the weights are not read as colors") && passed;
+
+    coords.clear();
+    faces.clear();
+    colors.clear();
+    loaded = loadObj("v 1 2 3 1 0 0\nv 4 5 6 0 1 0 0.5\nv 7 8 9 0 0 1 1\nf 1 2 3\n", coords, faces, colors);
+    passed = check(loaded, "vertices with a color are loaded") && passed;
+    passed = check(coords.size() == 9 && colors.size() == 3, "there is a color for each vertex") && passed;
+    passed = check(colors.size() == 3 && colors[0].red() == 255 && colors[1].green() == 255 && colors[2].blue() == 255,
+                   "the colors are scaled to [0, 255]") && passed;
+
+    coords.clear();
+    faces.clear();
+    colors.clear();
+    passed = check(!loadObj("v 1 2 3 4 5\n", coords, faces, colors), "a vertex with two extra values is rejected") && passed;
+    passed = check(!loadObj("v 1 2 3 4 5 6 7 8\n", coords, faces, colors), "a vertex with five extra values is rejected") && passed;
+
+    //the exported triangulation is loaded back with the same vertices and triangles
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(5);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+    for(unsigned int i = 0; i < 1000; i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    std::vector<cg3::Point2Dd> vertices;
+    std::vector<unsigned int> triangleVertices;
+    std::vector<unsigned int> triangleIndices;
+    DelaunayTriangulation::indexTriangulationVertices(triangulation, dag, true, vertices, triangleVertices, triangleIndices);
+
+    cg3::loadSave::MeshType meshType;
+    std::vector<double> objCoords;
+    std::vector<unsigned int> objFaces;
+    passed = check(FileUtils::exportTriangulationToObj(objFilename, triangulation, dag, true), "the OBJ file is saved") && passed;
+    passed = check(cg3::loadSave::loadMeshFromObj(objFilename, objCoords, objFaces, meshType), "the saved OBJ file is loaded") && passed;
+    passed = check(objCoords.size() == 3 * vertices.size() && objFaces == triangleVertices, "the OBJ file has the exported mesh") && passed;
+
+    std::vector<double> plyCoords;
+    std::vector<unsigned int> plyFaces;
+    passed = check(FileUtils::exportTriangulationToPly(plyFilename, triangulation, dag, true), "the PLY file is saved") && passed;
+    passed = check(cg3::loadSave::loadMeshFromPly(plyFilename, plyCoords, plyFaces, meshType), "the saved PLY file is loaded") && passed;
+    passed = check(plyCoords == objCoords && plyFaces == objFaces, "the PLY file has the same mesh of the OBJ file") && passed;
+
+    bool samePoints = objCoords.size() == 3 * vertices.size();
+    for(size_t i = 0; samePoints && i < vertices.size(); i++)
+    {
+        samePoints = objCoords[3 * i] == vertices[i].x() && objCoords[3 * i + 1] == vertices[i].y();
+    }
+    passed = check(samePoints, "the coordinates are saved without losing precision") && passed;
+
+    std::remove(objFilename);
+    std::remove(plyFilename);
+
+    return passed;
+}
+
+}
@@ -0,0 +1,148 @@
+#include "tests.h"
+
+#include <cmath>
+#include <random>
+
+#include <algorithms/delaunay.h>
+#include <algorithms/picking.h>
+
+namespace {
+
+/**
+ * @brief Checks if a point is inside a counter-clockwise triangle or on its boundary
+ * @param[in] triangle: the triangle
+ * @param[in] point: the point
+ * @return flag: true if the point is not on the right of any edge
+*/
+bool contains(const Triangle& triangle, const cg3::Point2Dd& point)
+{
+    for(unsigned int edge = 0; edge < 3; edge++)
+    {
+        Triangle side(DelaunayTriangulation::getCorner(triangle, edge), DelaunayTriangulation::getCorner(triangle, (edge + 1) % 3), point);
+        if(DelaunayTriangulation::getArea(side) < 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Counts the live triangles with a vertex, searching all the triangles
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] vertex: the vertex
+ * @param[out] triangle: the last live triangle with the vertex
+ * @return number: the number of live triangles with the vertex
+*/
+unsigned int countTrianglesWithVertex(const Triangulation& triangulation, const DAG& dag, const cg3::Point2Dd& vertex, int& triangle)
+{
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    unsigned int number = 0;
+    triangle = noAdjacentTriangle;
+    for(unsigned int i = 0; i < triangles.size(); i++)
+    {
+        if(nodes[i].isLeaf() && (triangles[i].getV1() == vertex || triangles[i].getV2() == vertex || triangles[i].getV3() == vertex))
+        {
+            number++;
+            triangle = int(i);
+        }
+    }
+
+    return number;
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Picks random points and compares the results with a search in all the live triangles
+ *
+ * The picked triangle must be live and contain the point, its corner must be the closest vertex
+ * and the incident triangles must be the live triangles with that vertex; a point outside the bounding triangle picks nothing.
+ */
+bool testPicking()
+{
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(29);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    for(unsigned int i = 0; i < 2000; i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    //the live triangles cover the bounding triangle
+    double area = 0;
+    for(unsigned int triangle = 0; triangle < triangles.size(); triangle++)
+    {
+        if(nodes[triangle].isLeaf())
+        {
+            area += DelaunayTriangulation::getArea(triangles[triangle]);
+        }
+    }
+    double boundingArea = DelaunayTriangulation::getArea(triangles[0]);
+    bool passed = check(std::abs(area - boundingArea) <= 1e-9 * boundingArea, "the areas of the live triangles sum to the bounding triangle");
+
+    unsigned int wrongTriangles = 0;
+    unsigned int wrongCorners = 0;
+    unsigned int wrongDegrees = 0;
+    for(unsigned int i = 0; i < 500; i++)
+    {
+        cg3::Point2Dd point(coordinate(generator), coordinate(generator));
+        DelaunayTriangulation::PickedElement element = DelaunayTriangulation::pickElement(triangulation, dag, point);
+
+        if(element.triangle == noAdjacentTriangle || !nodes[unsigned(element.triangle)].isLeaf() ||
+                !contains(triangles[unsigned(element.triangle)], point))
+        {
+            wrongTriangles++;
+            continue;
+        }
+
+        const Triangle& picked = triangles[unsigned(element.triangle)];
+        cg3::Point2Dd vertex = DelaunayTriangulation::getCorner(picked, element.corner);
+        for(unsigned int corner = 0; corner < 3; corner++)
+        {
+            if(DelaunayTriangulation::getCorner(picked, corner).dist(point) < vertex.dist(point))
+            {
+                wrongCorners++;
+            }
+        }
+
+        int last;
+        if(DelaunayTriangulation::countIncidentTriangles(triangulation, unsigned(element.triangle), element.corner) !=
+                countTrianglesWithVertex(triangulation, dag, vertex, last))
+        {
+            wrongDegrees++;
+        }
+    }
+
+    passed = check(wrongTriangles == 0, "the picked triangle is live and contains the point") && passed;
+    passed = check(wrongCorners == 0, "the picked vertex is the closest corner") && passed;
+    passed = check(wrongDegrees == 0, "the incident triangles are counted around the picked vertex") && passed;
+
+    //a vertex of the bounding triangle has no triangles on the other side
+    int bounding;
+    unsigned int incident = countTrianglesWithVertex(triangulation, dag, triangles[0].getV1(), bounding);
+    passed = check(bounding != noAdjacentTriangle &&
+                   DelaunayTriangulation::countIncidentTriangles(triangulation, unsigned(bounding),
+                                                                 DelaunayTriangulation::findClosestCorner(triangles[unsigned(bounding)], triangles[0].getV1())) == incident,
+                   "the incident triangles of a bounding vertex are counted in both directions") && passed;
+
+    DelaunayTriangulation::PickedElement outside = DelaunayTriangulation::pickElement(triangulation, dag, cg3::Point2Dd(2e10, 2e10));
+    passed = check(outside.triangle == noAdjacentTriangle, "a point outside the bounding triangle picks nothing") && passed;
+
+    return passed;
+}
+
+}
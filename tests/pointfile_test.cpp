@@ -0,0 +1,115 @@
+#include "tests.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <utils/fileutils.h>
+#include <utils/pointstreamreader.h>
+
+namespace {
+
+const char* const pointsFilename = "pointfile_test.txt";
+
+/**
+ * @brief Writes the content in the test file and loads it with the parallel parser
+ * @param[in] content: the text of the file
+ * @param[out] points: the loaded points
+ * @param[out] report: the report of the parser
+ * @return flag: the result of the parser
+*/
+bool load(const std::string& content, std::vector<cg3::Point2Dd>& points, FileUtils::PointFileReport& report)
+{
+    {
+        std::ofstream file(pointsFilename, std::ios::binary);
+        file << content;
+    }
+    return FileUtils::loadPointsFromFile(pointsFilename, points, report);
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Loads point files with CRLF line ends, without the last new line, with blank and malformed lines
+ *
+ * The malformed lines and the count mismatch are reported apart; an empty file or a file without the count is rejected.
+ * A file larger than a chunk must give the same points and line numbers of the stream reader, that parses it in order.
+ */
+bool testPointFileParser()
+{
+    std::vector<cg3::Point2Dd> points;
+    FileUtils::PointFileReport report;
+
+    bool loaded = load("3\r\n1 2\r\n3.5 -4\r\n5e1 6\r\n", points, report);
+    bool passed = check(loaded && points == std::vector<cg3::Point2Dd>({cg3::Point2Dd(1, 2), cg3::Point2Dd(3.5, -4), cg3::Point2Dd(50, 6)}),
+                        "the CRLF lines are read");
+    passed = check(report.malformedLines.empty() && !report.hasCountMismatch(), "the CRLF file is clean") && passed;
+
+    loaded = load("2\n1 2\n3 4", points, report);
+    passed = check(loaded && points.size() == 2 && points[1] == cg3::Point2Dd(3, 4), "the last line without new line is read") && passed;
+
+    loaded = load("4\n1 2\n\n  \t\nx 3\n3 4 5\n6\n7 8\n", points, report);
+    passed = check(loaded && points.size() == 2, "the blank and malformed lines are ignored") && passed;
+    passed = check(report.malformedLines == std::vector<unsigned long>({5, 6, 7}), "the malformed lines are reported, not the blank ones") && passed;
+    passed = check(report.hasCountMismatch() && report.declaredPoints == 4 && report.readPoints == 2, "the missing points are reported") && passed;
+
+    loaded = load("1\n1 2\n3 4\n", points, report);
+    passed = check(loaded && points.size() == 2 && report.malformedLines.empty() && report.hasCountMismatch(),
+                   "more points than declared are read and reported") && passed;
+
+    passed = check(!load("", points, report) && points.empty(), "an empty file is rejected") && passed;
+    passed = check(!load("1 2\n3 4\n", points, report), "a file without the count is rejected") && passed;
+
+    //larger than a chunk of the parallel parser, with malformed lines spread in the file
+    const unsigned int lineNumber = 50000;
+    std::string content = std::to_string(lineNumber) + "\n";
+    std::vector<unsigned long> malformedLines;
+    for(unsigned int i = 0; i < lineNumber; i++)
+    {
+        if(i % 997 == 0)
+        {
+            content += "malformed\r\n";
+            malformedLines.push_back(i + 2);
+        }
+        else
+        {
+            content += std::to_string(i) + " " + std::to_string(-double(i) / 8) + (i % 2 == 0 ? "\r\n" : "\n");
+        }
+    }
+
+    loaded = load(content, points, report);
+    passed = check(loaded && points.size() == lineNumber - malformedLines.size(), "the points of a large file are read") && passed;
+    passed = check(report.malformedLines == malformedLines, "the line numbers are counted across the chunks") && passed;
+
+    bool ordered = points.size() == lineNumber - malformedLines.size();
+    for(size_t i = 0, line = 0; ordered && i < points.size(); i++, line++)
+    {
+        if(line % 997 == 0)
+        {
+            line++;
+        }
+        ordered = points[i] == cg3::Point2Dd(double(line), -double(line) / 8);
+    }
+    passed = check(ordered, "the points keep the order of the file") && passed;
+
+    PointStreamReader reader(1000, 4);
+    std::vector<cg3::Point2Dd> streamed;
+    std::vector<cg3::Point2Dd> chunk;
+    passed = check(reader.start(pointsFilename), "the stream reader opens the large file") && passed;
+    while(reader.nextChunk(chunk))
+    {
+        streamed.insert(streamed.end(), chunk.begin(), chunk.end());
+    }
+    passed = check(streamed == points && reader.getReport().malformedLines == report.malformedLines &&
+                   reader.getReport().readPoints == report.readPoints, "the stream reader gives the same points and report") && passed;
+    reader.stop();
+
+    std::remove(pointsFilename);
+
+    return passed;
+}
+
+}
@@ -0,0 +1,62 @@
+#include "tests.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#include <utils/pointstreamreader.h>
+
+namespace {
+
+const char* const pointsFilename = "pointstream_test.txt";
+
+const unsigned int pointNumber = 10000;
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Stops the reader after the first chunk and reads the file again
+ *
+ * After the stop the consumer must get no more chunks without waiting, and the report must not be filled;
+ * the same reader must then read the whole file.
+ */
+bool testStreamEarlyStop()
+{
+    {
+        std::ofstream file(pointsFilename);
+        file << pointNumber << "\n";
+        for(unsigned int i = 0; i < pointNumber; i++)
+        {
+            file << i << " " << -double(i) << "\n";
+        }
+    }
+
+    PointStreamReader reader(100, 2);
+    std::vector<cg3::Point2Dd> chunk;
+
+    bool passed = check(reader.start(pointsFilename), "the file is opened");
+    passed = check(reader.nextChunk(chunk) && chunk.size() == 100, "the first chunk is read") && passed;
+
+    reader.stop();
+    passed = check(reader.waitForChunk(std::chrono::milliseconds(1000)), "a stopped reader doesn't make the consumer wait") && passed;
+    passed = check(!reader.nextChunk(chunk), "a stopped reader returns no more chunks") && passed;
+    passed = check(reader.getReport().readPoints == 0, "the report of a stopped reader is empty") && passed;
+
+    size_t readPoints = 0;
+    passed = check(reader.start(pointsFilename), "the file is opened again") && passed;
+    while(reader.nextChunk(chunk))
+    {
+        readPoints += chunk.size();
+    }
+    passed = check(readPoints == pointNumber, "the restarted reader reads all the points") && passed;
+    passed = check(!reader.getReport().hasCountMismatch() && reader.getReport().malformedLines.empty(), "the report of the whole file is clean") && passed;
+
+    reader.stop();
+    std::remove(pointsFilename);
+
+    return passed;
+}
+
+}
@@ -0,0 +1,117 @@
+#include "tests.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <cg3/io/serialize.h>
+
+namespace {
+
+const char* const serializedFilename = "serialize_test.bin";
+
+/**
+ * @brief Serializes a vector and replaces its size
+ * @param[in] vector: the serialized vector
+ * @param[in] size: the size written in the file
+ * @param[in] truncatedBytes: number of bytes removed from the end of the file
+*/
+template<typename T>
+void writeVector(const std::vector<T>& vector, unsigned long long int size, size_t truncatedBytes)
+{
+    std::string content;
+    {
+        std::ofstream file(serializedFilename, std::ios::binary);
+        cg3::serializer::serialize(vector, file);
+    }
+    {
+        std::ifstream file(serializedFilename, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    //the size follows the name of the container
+    std::string name;
+    {
+        std::ofstream file(serializedFilename, std::ios::binary);
+        cg3::serializer::serialize(std::string("stdvector"), file);
+    }
+    {
+        std::ifstream file(serializedFilename, std::ios::binary);
+        name.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    content.replace(name.size(), sizeof(size), reinterpret_cast<const char*>(&size), sizeof(size));
+    content.resize(content.size() - truncatedBytes);
+
+    std::ofstream file(serializedFilename, std::ios::binary);
+    file.write(content.data(), std::streamsize(content.size()));
+}
+
+/**
+ * @brief Deserializes a vector from the test file
+ * @param[in/out] vector: the deserialized vector, unchanged if the deserialization fails
+ * @return flag: false if the deserialization throws
+*/
+template<typename T>
+bool readVector(std::vector<T>& vector)
+{
+    std::ifstream file(serializedFilename, std::ios::binary);
+    try
+    {
+        cg3::serializer::deserialize(vector, file);
+    }
+    catch(std::ios_base::failure&)
+    {
+        return false;
+    }
+    return true;
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Deserializes vectors with corrupted sizes and nested small vectors
+ *
+ * A huge size is rejected before the allocation, a small wrong size when the elements are read;
+ * in both cases the vector is unchanged.
+ */
+bool testSerializedSizeCheck()
+{
+    const std::vector<double> values(100000, 0.5);
+    const std::vector<double> previous(3, 1.0);
+
+    std::vector<double> read = previous;
+    writeVector(values, values.size(), 0);
+    bool passed = check(readVector(read) && read == values, "a valid vector is deserialized");
+
+    read = previous;
+    writeVector(values, std::numeric_limits<unsigned long long int>::max() / 16, 0);
+    passed = check(!readVector(read) && read == previous, "a huge size is rejected") && passed;
+
+    read = previous;
+    writeVector(values, values.size(), sizeof(double));
+    passed = check(!readVector(read) && read == previous, "a truncated large vector is rejected") && passed;
+
+    const std::vector<double> small(10, 0.25);
+    read = previous;
+    writeVector(small, small.size() + 1, 0);
+    passed = check(!readVector(read) && read == previous, "a small vector with a wrong size is rejected") && passed;
+
+    const std::vector<std::vector<int>> nested(1000, std::vector<int>({1, 2, 3}));
+    std::vector<std::vector<int>> nestedRead;
+    {
+        std::ofstream file(serializedFilename, std::ios::binary);
+        cg3::serializer::serialize(nested, file);
+    }
+    passed = check(readVector(nestedRead) && nestedRead == nested, "nested small vectors are deserialized") && passed;
+
+    std::remove(serializedFilename);
+
+    return passed;
+}
+
+}
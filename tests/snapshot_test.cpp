@@ -0,0 +1,170 @@
+#include "tests.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+
+#include <algorithms/delaunay.h>
+#include <utils/triangulationsnapshot.h>
+
+namespace {
+
+const char* const snapshotFilename = "snapshot_test.snap";
+const char* const corruptedFilename = "snapshot_test_corrupted.snap";
+
+std::vector<char> readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::string& filename, const std::vector<char>& content)
+{
+    std::ofstream file(filename, std::ios::binary);
+    file.write(content.data(), std::streamsize(content.size()));
+}
+
+/**
+ * @brief Writes the snapshot with a 32 bit value replaced and checks that it can't be opened
+ * @param[in] content: the bytes of a valid snapshot
+ * @param[in] offset: the position of the value
+ * @param[in] value: the new value
+ * @return flag: true if open rejects the file
+*/
+bool isRejected(std::vector<char> content, uint64_t offset, int32_t value)
+{
+    std::memcpy(content.data() + offset, &value, sizeof(value));
+    writeFile(corruptedFilename, content);
+
+    TriangulationSnapshot snapshot;
+    return !snapshot.open(corruptedFilename);
+}
+
+/**
+ * @brief Opens a snapshot with random flipped bytes and, if it is accepted, queries and restores it
+ *
+ * A flipped coordinate still gives a valid snapshot, a flipped index must be rejected:
+ * in both cases the snapshot must not be read outside the file.
+ *
+ * @param[in] content: the bytes of a valid snapshot
+ * @param[in] generator: the random generator
+ * @return flag: true if the located triangles are triangles of the snapshot
+*/
+bool queryFlippedSnapshot(std::vector<char> content, std::mt19937& generator)
+{
+    std::uniform_int_distribution<size_t> position(sizeof(TriangulationSnapshotHeader), content.size() - 1);
+    std::uniform_int_distribution<int> bit(0, 7);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    for(unsigned int i = 0; i < 4; i++)
+    {
+        content[position(generator)] ^= char(1 << bit(generator));
+    }
+    writeFile(corruptedFilename, content);
+
+    TriangulationSnapshot snapshot;
+    if(!snapshot.open(corruptedFilename))
+    {
+        return true;
+    }
+
+    bool valid = true;
+    for(unsigned int i = 0; i < 20; i++)
+    {
+        int64_t triangle = snapshot.locate(cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+        valid = valid && triangle < int64_t(snapshot.getTriangleNumber());
+    }
+
+    Triangulation triangulation;
+    DAG dag;
+    snapshot.restore(triangulation, dag);
+
+    return valid;
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Checks that open rejects snapshots with indices out of their sections and DAG cycles
+ *
+ * The snapshots are saved with and without the DAG; a vertex, an adjacency and a child are replaced
+ * by invalid indices, then random bytes are flipped.
+ */
+bool testCorruptedSnapshot()
+{
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(11);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    for(unsigned int i = 0; i < 500; i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    bool passed = true;
+
+    for(bool withDag : {true, false})
+    {
+        if(!check(FileUtils::saveTriangulationSnapshot(snapshotFilename, triangulation, dag, withDag), "the snapshot is saved"))
+        {
+            return false;
+        }
+
+        std::vector<char> content = readFile(snapshotFilename);
+
+        TriangulationSnapshotHeader header;
+        std::memcpy(&header, content.data(), sizeof(header));
+
+        uint64_t triangleNumber = header.triangleNumber;
+        uint64_t middle = triangleNumber / 2;
+
+        {
+            TriangulationSnapshot snapshot;
+            passed = check(snapshot.open(snapshotFilename), "a valid snapshot is opened") && passed;
+            passed = check(snapshot.locate(cg3::Point2Dd(0, 0)) >= 0, "a point of the valid snapshot is located") && passed;
+        }
+
+        passed = check(isRejected(content, header.trianglesOffset + 3 * middle * sizeof(uint32_t), int32_t(header.vertexNumber)),
+                       "a vertex after the vertex section is rejected") && passed;
+        passed = check(isRejected(content, header.adjacenciesOffset + (3 * middle + 1) * sizeof(int32_t), int32_t(triangleNumber)),
+                       "an adjacency after the triangle section is rejected") && passed;
+        passed = check(isRejected(content, header.adjacenciesOffset + (3 * middle + 2) * sizeof(int32_t), -2),
+                       "a negative adjacency is rejected") && passed;
+
+        if(withDag)
+        {
+            //the root always has children
+            passed = check(isRejected(content, header.nodesOffset, 0), "a node child of itself is rejected") && passed;
+            passed = check(isRejected(content, header.nodesOffset + 3 * middle * sizeof(int32_t), int32_t(middle / 2)),
+                           "a child before its parent is rejected") && passed;
+            passed = check(isRejected(content, header.nodesOffset + 3 * sizeof(int32_t), int32_t(triangleNumber)),
+                           "a child after the node section is rejected") && passed;
+        }
+
+        std::vector<char> truncated(content.begin(), content.begin() + std::ptrdiff_t(content.size() / 2));
+        writeFile(corruptedFilename, truncated);
+        TriangulationSnapshot snapshot;
+        passed = check(!snapshot.open(corruptedFilename), "a truncated snapshot is rejected") && passed;
+
+        bool queried = true;
+        for(unsigned int i = 0; i < 200; i++)
+        {
+            queried = queryFlippedSnapshot(content, generator) && queried;
+        }
+        passed = check(queried, "the snapshots with flipped bytes locate only their triangles") && passed;
+    }
+
+    std::remove(snapshotFilename);
+    std::remove(corruptedFilename);
+
+    return passed;
+}
+
+}
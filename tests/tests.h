@@ -0,0 +1,52 @@
+#ifndef TESTS_H
+#define TESTS_H
+
+#include <iostream>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+
+/**
+ * Tests: checks of the data structures and of the algorithms without the viewer
+ *
+ * Each test returns true if all its checks pass; check prints the failed ones.
+ */
+namespace Tests {
+
+inline bool check(bool condition, const char* description)
+{
+    if(!condition)
+    {
+        std::cerr << "  failed: " << description << std::endl;
+    }
+    return condition;
+}
+
+/**
+ * @brief Adds the bounding triangle of the manager, so points in [-1e6, 1e6] can be inserted
+ * @param[out] triangulation: the empty triangulation
+ * @param[out] dag: the empty DAG
+*/
+inline void addBoundingTriangle(Triangulation& triangulation, DAG& dag)
+{
+    triangulation.addTriangle(Triangle(cg3::Point2Dd(1e+10, 0), cg3::Point2Dd(0, 1e+10), cg3::Point2Dd(-1e+10, -1e+10)));
+    triangulation.addAdjacenciesForNewTriangle(noAdjacentTriangle, noAdjacentTriangle, noAdjacentTriangle);
+    dag.addNode(Node(0));
+}
+
+bool testFlipAfterReallocation();
+bool testCorruptedSnapshot();
+bool testVoronoiCells();
+bool testMeshLoadSave();
+bool testSerializedSizeCheck();
+bool testStreamEarlyStop();
+bool testBinaryPointFile();
+bool testTopologyChecker();
+bool testPointFileParser();
+bool testInsertionJournal();
+bool testIncrementalVoronoi();
+bool testPicking();
+
+}
+
+#endif // TESTS_H
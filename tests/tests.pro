@@ -0,0 +1,33 @@
+# Tests of the data structures and of the algorithms, they don't need the viewer
+# Build with qmake and run the executable: the exit code is the number of failed tests
+
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+CONFIG += c++11
+
+CONFIG += CG3_CORE
+include (../cg3lib/cg3.pri)
+
+INCLUDEPATH += ..
+
+HEADERS += \
+    tests.h
+
+SOURCES += \
+    main.cpp \
+    delaunay_test.cpp \
+    snapshot_test.cpp \
+    voronoi_test.cpp \
+    mesh_test.cpp \
+    serialize_test.cpp \
+    pointstream_test.cpp \
+    binarypoints_test.cpp \
+    topology_test.cpp \
+    pointfile_test.cpp \
+    journal_test.cpp \
+    picking_test.cpp \
+    $$files(../data_structures/*.cpp) \
+    $$files(../algorithms/*.cpp) \
+    $$files(../utils/*.cpp)
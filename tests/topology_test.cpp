@@ -0,0 +1,73 @@
+#include "tests.h"
+
+#include <random>
+
+#include <algorithms/delaunay.h>
+#include <utils/topology_checker.h>
+
+namespace Tests {
+
+/**
+ * @brief Checks a valid triangulation, then breaks an adjacency and the sizes of the data structures
+ *
+ * A live triangle whose neighbour doesn't know it must be reported as an asymmetric adjacency,
+ * a triangle without adjacencies and node as a size mismatch.
+ */
+bool testTopologyChecker()
+{
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(17);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+    for(unsigned int i = 0; i < 1000; i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    DelaunayTriangulation::Checker::TopologyReport report = DelaunayTriangulation::Checker::checkTopology(triangulation, dag);
+    bool passed = check(report.isValid() && report.eulerCharacteristic, "the triangulation is valid");
+
+    //the first live triangle with a live neighbour forgets it
+    Triangulation broken = triangulation;
+    const std::vector<Node>& nodes = dag.getNodeList();
+    bool injected = false;
+    for(unsigned int i = 0; i < nodes.size() && !injected; i++)
+    {
+        if(!nodes[i].isLeaf())
+        {
+            continue;
+        }
+        for(int adjacent : broken.getAdjacenciesFromTriangle(i))
+        {
+            if(adjacent != noAdjacentTriangle && !injected)
+            {
+                std::array<int, maxAdjacentTriangles>& back = broken.getAdjacenciesFromTriangle(unsigned(adjacent));
+                for(int& triangle : back)
+                {
+                    if(triangle == int(i))
+                    {
+                        triangle = noAdjacentTriangle;
+                        injected = true;
+                    }
+                }
+            }
+        }
+    }
+
+    report = DelaunayTriangulation::Checker::checkTopology(broken, dag);
+    passed = check(injected, "an adjacency is broken") && passed;
+    passed = check(report.asymmetricAdjacencies == 1, "the asymmetric adjacency is reported") && passed;
+    passed = check(!report.isValid(), "the broken triangulation is not valid") && passed;
+
+    //a triangle without adjacencies and node
+    Triangulation grown = triangulation;
+    grown.addTriangle(Triangle(cg3::Point2Dd(0, 0), cg3::Point2Dd(1, 0), cg3::Point2Dd(0, 1)));
+    report = DelaunayTriangulation::Checker::checkTopology(grown, dag);
+    passed = check(report.sizeMismatch && !report.isValid(), "the size mismatch is reported") && passed;
+
+    return passed;
+}
+
+}
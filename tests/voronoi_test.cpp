@@ -0,0 +1,205 @@
+#include "tests.h"
+
+#include <cmath>
+#include <random>
+#include <unordered_map>
+
+#include <algorithms/delaunay.h>
+#include <data_structures/voronoicells.h>
+#include <data_structures/voronoidiagram.h>
+
+namespace {
+
+/**
+ * @brief Compares two diagrams of the same triangulation, whatever the order of their vertices, edges and sites
+ *
+ * Each live triangle must have a vertex in both diagrams at the same circumcenter, and each site must have
+ * the same cell: the same triangles and neighbour sites, counter-clockwise, starting from the same triangle.
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] first: the first diagram
+ * @param[in] second: the second diagram
+ * @return flag: true if the diagrams are equal
+*/
+bool equalDiagrams(const Triangulation& triangulation, const VoronoiDiagram& first, const VoronoiDiagram& second)
+{
+    if(first.getVertexNumber() != second.getVertexNumber() || first.getEdgeNumber() != second.getEdgeNumber() ||
+            first.getSiteNumber() != second.getSiteNumber() || first.getVersion() != second.getVersion())
+    {
+        return false;
+    }
+
+    const unsigned int triangleNumber = unsigned(triangulation.getTriangles().size());
+    std::vector<unsigned int> firstTriangles(first.getVertexNumber());
+    std::vector<unsigned int> secondTriangles(second.getVertexNumber());
+    for(unsigned int triangle = 0; triangle < triangleNumber; triangle++)
+    {
+        int firstVertex = first.getVertexOfTriangle(triangle);
+        int secondVertex = second.getVertexOfTriangle(triangle);
+        if((firstVertex == noVertex) != (secondVertex == noVertex))
+        {
+            return false;
+        }
+        if(firstVertex != noVertex)
+        {
+            if(first.getVertex(unsigned(firstVertex)) != second.getVertex(unsigned(secondVertex)))
+            {
+                return false;
+            }
+            firstTriangles[unsigned(firstVertex)] = triangle;
+            secondTriangles[unsigned(secondVertex)] = triangle;
+        }
+    }
+
+    std::unordered_map<cg3::Point2Dd, size_t> secondSites;
+    for(size_t site = 0; site < second.getSiteNumber(); site++)
+    {
+        secondSites[second.getSite(site)] = site;
+    }
+
+    std::vector<unsigned int> firstVertices, secondVertices;
+    std::vector<int> firstNeighbours, secondNeighbours;
+    for(size_t site = 0; site < first.getSiteNumber(); site++)
+    {
+        auto match = secondSites.find(first.getSite(site));
+        if(match == secondSites.end())
+        {
+            return false;
+        }
+
+        first.getCell(site, firstVertices, firstNeighbours);
+        second.getCell(match->second, secondVertices, secondNeighbours);
+        if(firstVertices.empty() || firstVertices.size() != secondVertices.size())
+        {
+            return false;
+        }
+
+        //the cells may start from different vertices
+        size_t offset = 0;
+        while(offset < secondVertices.size() && secondTriangles[secondVertices[offset]] != firstTriangles[firstVertices[0]])
+        {
+            offset++;
+        }
+        if(offset == secondVertices.size())
+        {
+            return false;
+        }
+
+        for(size_t k = 0; k < firstVertices.size(); k++)
+        {
+            size_t j = (k + offset) % secondVertices.size();
+            if(firstTriangles[firstVertices[k]] != secondTriangles[secondVertices[j]] ||
+                    (firstNeighbours[k] == noSite) != (secondNeighbours[j] == noSite) ||
+                    (firstNeighbours[k] != noSite && first.getSite(unsigned(firstNeighbours[k])) != second.getSite(unsigned(secondNeighbours[j]))))
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+}
+
+namespace Tests {
+
+/**
+ * @brief Clips the cells of random sites to a square and checks that they tile it
+ *
+ * Each vertex of a clipped cell must be inside the square and the areas of the cells must sum to the area of the square.
+ */
+bool testVoronoiCells()
+{
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(13);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    for(unsigned int i = 0; i < 5000; i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    }
+
+    VoronoiDiagram diagram;
+    diagram.build(triangulation, dag);
+
+    const cg3::Point2Dd min(-1e6, -1e6);
+    const cg3::Point2Dd max(1e6, 1e6);
+    const double tolerance = 1e-6;
+
+    VoronoiCells cells;
+    cells.build(diagram, min, max);
+
+    bool passed = check(cells.getCellNumber() == diagram.getSiteNumber(), "there is a cell for each site");
+
+    unsigned int outside = 0;
+    double area = 0;
+    for(size_t cell = 0; cell < cells.getCellNumber(); cell++)
+    {
+        for(size_t k = 0; k < cells.getCellSize(cell); k++)
+        {
+            cg3::Point2Dd vertex = cells.getCellVertex(cell, k);
+            if(vertex.x() < min.x() - tolerance || vertex.x() > max.x() + tolerance ||
+                    vertex.y() < min.y() - tolerance || vertex.y() > max.y() + tolerance)
+            {
+                outside++;
+            }
+        }
+        area += cells.getArea(cell);
+    }
+
+    double squareArea = (max.x() - min.x()) * (max.y() - min.y());
+    passed = check(outside == 0, "the vertices of the cells are inside the square") && passed;
+    passed = check(std::abs(area - squareArea) <= 1e-9 * squareArea, "the areas of the cells sum to the area of the square") && passed;
+
+    return passed;
+}
+
+/**
+ * @brief Updates a diagram with the changes of each insertion and compares it with a diagram built from scratch
+ *
+ * The changes of an insertion the diagram was not built from must rebuild it, not be applied.
+ */
+bool testIncrementalVoronoi()
+{
+    Triangulation triangulation;
+    DAG dag;
+    addBoundingTriangle(triangulation, dag);
+
+    std::mt19937 generator(19);
+    std::uniform_real_distribution<double> coordinate(-1e6, 1e6);
+
+    VoronoiDiagram incremental;
+    VoronoiDiagram rebuilt;
+    DelaunayTriangulation::TriangulationChanges changes;
+
+    bool passed = true;
+    bool updated = true;
+    for(unsigned int i = 0; i < 2000; i++)
+    {
+        DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)), &changes);
+        updated = incremental.update(triangulation, dag, changes) && updated;
+
+        if(i % 250 == 0)
+        {
+            rebuilt.build(triangulation, dag);
+            passed = check(equalDiagrams(triangulation, incremental, rebuilt), "the updated diagram is equal to the rebuilt one") && passed;
+        }
+    }
+    passed = check(updated && incremental.getVersion() == triangulation.getVersion(), "each insertion updates the diagram") && passed;
+    passed = check(!incremental.update(triangulation, dag, changes), "the same changes are not applied twice") && passed;
+
+    //the diagram misses the first of two insertions
+    DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)));
+    DelaunayTriangulation::incrementalTriangulation(triangulation, dag, cg3::Point2Dd(coordinate(generator), coordinate(generator)), &changes);
+    passed = check(incremental.update(triangulation, dag, changes), "the diagram is rebuilt from stale changes") && passed;
+
+    rebuilt.build(triangulation, dag);
+    passed = check(equalDiagrams(triangulation, incremental, rebuilt), "the diagram rebuilt from stale changes is equal to the rebuilt one") && passed;
+
+    return passed;
+}
+
+}
@@ -0,0 +1,227 @@
+#include "backgroundjob.h"
+
+/**
+ * @brief Creates a job that is not running
+*/
+BackgroundJob::BackgroundJob() :
+    done(0), total(0), finished(false), cancelled(false), pauseRequested(false), paused(false), stepping(false),
+    pausedTime(std::chrono::steady_clock::duration::zero()) {}
+
+/**
+ * @brief Cancels the job and waits for it
+*/
+BackgroundJob::~BackgroundJob()
+{
+    cancel();
+    join();
+}
+
+/**
+ * @brief Starts the job on a new thread
+ * @param[in] job: the computation, it must call step after each unit of work
+ * @param[in] total: the number of units of work, used to estimate the remaining time
+ * @return flag: false if a job is already running
+*/
+bool BackgroundJob::start(const std::function<void()>& job, uint64_t total)
+{
+    if(worker.joinable())
+    {
+        return false;
+    }
+
+    this->total = total;
+    done = 0;
+    finished = false;
+    cancelled = false;
+    pauseRequested = false;
+    paused = false;
+    stepping = true;
+    pausedTime = std::chrono::steady_clock::duration::zero();
+    startTime = std::chrono::steady_clock::now();
+
+    worker = std::thread(&BackgroundJob::run, this, job);
+    return true;
+}
+
+/**
+ * @brief Waits for the end of the job
+*/
+void BackgroundJob::join()
+{
+    if(worker.joinable())
+    {
+        worker.join();
+    }
+}
+
+/**
+ * @brief Publishes the progress of the job and waits while it is paused
+ * @param[in] done: the number of units of work done so far
+ * @return flag: false if the job has been cancelled and it must stop
+*/
+bool BackgroundJob::step(uint64_t done)
+{
+    this->done.store(done, std::memory_order_relaxed);
+
+    if(pauseRequested.load(std::memory_order_acquire))
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        paused = true;
+        pauseTime = std::chrono::steady_clock::now();
+        condition.notify_all();
+
+        condition.wait(lock, [this]() { return !pauseRequested || cancelled; });
+
+        paused = false;
+        pausedTime += std::chrono::steady_clock::now() - pauseTime;
+    }
+
+    return !cancelled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Ends the measured part of the job, called by the job after its last step
+ *
+ * The pauses requested from now on are refused, so the owner doesn't wait for the rest of the job.
+*/
+void BackgroundJob::endSteps()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    endTime = std::chrono::steady_clock::now();
+    stepping = false;
+    condition.notify_all();
+}
+
+/**
+ * @brief Asks the job to stop at the next step
+*/
+void BackgroundJob::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    cancelled = true;
+    condition.notify_all();
+}
+
+/**
+ * @brief Waits until the job reaches a step and stops there
+ *
+ * If the job doesn't reach a step within the timeout the request is withdrawn, so the job is never paused
+ * when the owner is not waiting for it.
+ * @param[in] timeout: the maximum waiting time
+ * @return flag: false if the job didn't reach a step in time or if it ended its steps, in that case it must not be resumed
+*/
+bool BackgroundJob::pause(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if(!worker.joinable() || finished || !stepping)
+    {
+        return false;
+    }
+
+    pauseRequested = true;
+    condition.wait_for(lock, timeout, [this]() { return paused || finished || !stepping; });
+
+    if(!paused)
+    {
+        pauseRequested = false;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Lets a paused job go on
+*/
+void BackgroundJob::resume()
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    pauseRequested = false;
+    condition.notify_all();
+}
+
+/**
+ * @brief Returns true if the job has been started and not joined yet
+ * @return flag: the running flag
+*/
+bool BackgroundJob::isRunning() const
+{
+    return worker.joinable();
+}
+
+/**
+ * @brief Returns true if the job returned, so it can be joined without waiting
+ * @return flag: the finished flag
+*/
+bool BackgroundJob::isFinished() const
+{
+    return finished;
+}
+
+bool BackgroundJob::isCancelled() const
+{
+    return cancelled;
+}
+
+uint64_t BackgroundJob::getDone() const
+{
+    return done.load(std::memory_order_relaxed);
+}
+
+uint64_t BackgroundJob::getTotal() const
+{
+    return total;
+}
+
+/**
+ * @brief Returns the time spent computing, without the pauses
+ * @return seconds: the time until now, or until the end of the steps if the job ended them
+*/
+double BackgroundJob::getComputeTime() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::chrono::steady_clock::time_point now = finished || !stepping ? endTime : std::chrono::steady_clock::now();
+    std::chrono::steady_clock::duration computeTime = now - startTime - pausedTime;
+    if(paused)
+    {
+        computeTime -= now - pauseTime;
+    }
+
+    return std::chrono::duration<double>(computeTime).count();
+}
+
+/**
+ * @brief Estimates the remaining time from the mean time of the units of work done so far
+ * @return seconds: the estimated time, a negative number if nothing has been done yet
+*/
+double BackgroundJob::getRemainingTime() const
+{
+    uint64_t done = getDone();
+    if(done == 0)
+    {
+        return -1;
+    }
+
+    return getComputeTime() * double(total > done ? total - done : 0) / double(done);
+}
+
+/**
+ * @brief Body of the thread
+ * @param[in] job: the computation
+*/
+void BackgroundJob::run(const std::function<void()>& job)
+{
+    job();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if(stepping)
+    {
+        endTime = std::chrono::steady_clock::now();
+        stepping = false;
+    }
+    finished = true;
+    condition.notify_all();
+}
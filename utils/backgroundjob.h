@@ -0,0 +1,79 @@
+#ifndef BACKGROUNDJOB_H
+#define BACKGROUNDJOB_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+/**
+ * @brief BackgroundJob: runs a long computation on a separate thread
+ *
+ * The job calls step after each unit of work: step publishes the progress, waits while the job is paused
+ * and returns false when the job has been cancelled, so the job can stop between two units of work.
+ * Pausing waits until the job reaches the next step, so until resume the data modified by the job are consistent
+ * and they can be read by the caller. The owner waits at most a timeout: a job busy in a long unit of work
+ * (e.g. waiting for I/O) is not paused and the owner can try again later. The compute time doesn't include the time spent paused.
+ * After its last step the job can call endSteps and go on with work that is not measured (e.g. saving its result):
+ * from then on the job can't be paused, so the owner never waits for that work.
+ */
+class BackgroundJob
+{
+public:
+    BackgroundJob();
+    ~BackgroundJob();
+
+    BackgroundJob(const BackgroundJob&) = delete;
+    BackgroundJob& operator=(const BackgroundJob&) = delete;
+
+    bool start(const std::function<void()>& job, uint64_t total);
+    void join();
+
+    //called by the job
+    bool step(uint64_t done);
+    void endSteps();
+
+    //called by the owner
+    void cancel();
+    bool pause(std::chrono::milliseconds timeout);
+    void resume();
+
+    bool isRunning() const;
+    bool isFinished() const;
+    bool isCancelled() const;
+
+    uint64_t getDone() const;
+    uint64_t getTotal() const;
+    double getComputeTime() const;
+    double getRemainingTime() const;
+
+private:
+    void run(const std::function<void()>& job);
+
+    std::thread worker;
+
+    //units of work done and to do
+    std::atomic<uint64_t> done;
+    uint64_t total;
+
+    std::atomic<bool> finished;
+    std::atomic<bool> cancelled;
+    std::atomic<bool> pauseRequested;
+
+    //the job waits on the condition while it is paused, the owner waits until it is paused
+    mutable std::mutex mutex;
+    std::condition_variable condition;
+    bool paused;
+    bool stepping;
+
+    //the compute time is the time from start to the end of the steps without the pauses
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point endTime;
+    std::chrono::steady_clock::time_point pauseTime;
+    std::chrono::steady_clock::duration pausedTime;
+};
+
+#endif // BACKGROUNDJOB_H
@@ -0,0 +1,308 @@
+#include "binarypointfile.h"
+#include "fileutils.h"
+
+#include <cassert>
+#include <fstream>
+#include <cstring>
+#include <limits>
+
+namespace {
+
+//the first 8 bytes of each binary point file
+const char binaryPointMagic[8] = {'G', 'A', 'S', 'P', 'T', 'S', '\0', '\0'};
+
+//points written with a single call to the stream
+const size_t writeBlockPoints = 1 << 16;
+
+/**
+ * @brief Writes the coordinates converting them to the type stored in the file
+ * @param[in] file: the output stream
+ * @param[in] points: the points to write
+*/
+template<typename T>
+bool writeCoordinates(std::ofstream& file, const std::vector<cg3::Point2Dd>& points)
+{
+    std::vector<T> block;
+    block.reserve(2 * writeBlockPoints);
+
+    for(size_t first = 0; first < points.size(); first += writeBlockPoints)
+    {
+        size_t last = std::min(points.size(), first + writeBlockPoints);
+
+        block.clear();
+        for(size_t i = first; i < last; i++)
+        {
+            block.push_back(T(points[i].x()));
+            block.push_back(T(points[i].y()));
+        }
+
+        if(!file.write(reinterpret_cast<const char*>(block.data()), std::streamsize(block.size() * sizeof(T))))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}
+
+/**
+ * @brief Creates an empty view
+*/
+BinaryPointFile::BinaryPointFile()
+    : header(nullptr) {}
+
+/**
+ * @brief Maps the file and validates its header
+ * @param[in] filename: the path of the file
+ * @return flag: false if the file can't be opened, if it is not a binary point file or if it was written with different endianness
+*/
+bool BinaryPointFile::open(const std::string& filename)
+{
+    close();
+
+    if(!file.open(filename) || file.size() < sizeof(BinaryPointHeader))
+    {
+        close();
+        return false;
+    }
+
+    const BinaryPointHeader* fileHeader = reinterpret_cast<const BinaryPointHeader*>(file.data());
+
+    bool valid = std::memcmp(fileHeader->magic, binaryPointMagic, sizeof(binaryPointMagic)) == 0 &&
+            fileHeader->version == FileUtils::binaryPointFileVersion &&
+            fileHeader->endianness == FileUtils::endiannessMarker &&
+            (fileHeader->coordinateSize == FileUtils::floatCoordinates || fileHeader->coordinateSize == FileUtils::doubleCoordinates);
+
+    //the file must contain all the declared coordinates
+    if(valid)
+    {
+        uint64_t coordinatesSize = file.size() - sizeof(BinaryPointHeader);
+        valid = fileHeader->pointNumber <= coordinatesSize / (2 * fileHeader->coordinateSize);
+    }
+
+    if(!valid)
+    {
+        close();
+        return false;
+    }
+
+    header = fileHeader;
+    return true;
+}
+
+/**
+ * @brief Releases the view
+*/
+void BinaryPointFile::close()
+{
+    file.close();
+    header = nullptr;
+}
+
+/**
+ * @brief Returns true if a file is open, so its points can be read
+ * @return flag: the open flag
+*/
+bool BinaryPointFile::isOpen() const
+{
+    return header != nullptr;
+}
+
+/**
+ * @brief Returns the number of points
+ * @return pointNumber: number of points in the file
+*/
+uint64_t BinaryPointFile::getPointNumber() const
+{
+    return header == nullptr ? 0 : header->pointNumber;
+}
+
+/**
+ * @brief Returns the size of the coordinates
+ * @return coordinateSize: floatCoordinates or doubleCoordinates
+*/
+uint32_t BinaryPointFile::getCoordinateSize() const
+{
+    return header == nullptr ? 0 : header->coordinateSize;
+}
+
+/**
+ * @brief Returns the minimum corner of the bounding box of the points
+ * @return min: the minimum coordinates
+*/
+cg3::Point2Dd BinaryPointFile::getMin() const
+{
+    return header == nullptr ? cg3::Point2Dd() : cg3::Point2Dd(header->minX, header->minY);
+}
+
+/**
+ * @brief Returns the maximum corner of the bounding box of the points
+ * @return max: the maximum coordinates
+*/
+cg3::Point2Dd BinaryPointFile::getMax() const
+{
+    return header == nullptr ? cg3::Point2Dd() : cg3::Point2Dd(header->maxX, header->maxY);
+}
+
+/**
+ * @brief Returns the coordinates stored in the mapped file
+ * @return coordinates: pointer to x, y pairs of float or double, according to getCoordinateSize
+*/
+const void* BinaryPointFile::getCoordinates() const
+{
+    return header == nullptr ? nullptr : file.data() + sizeof(BinaryPointHeader);
+}
+
+/**
+ * @brief Returns a point of the file, the file must be open
+ * @param[in] i: index of the point, less than the number of points
+ * @return point: the point
+*/
+cg3::Point2Dd BinaryPointFile::getPoint(uint64_t i) const
+{
+    assert(header != nullptr && i < header->pointNumber);
+
+    if(header->coordinateSize == FileUtils::doubleCoordinates)
+    {
+        const double* coordinates = static_cast<const double*>(getCoordinates());
+        return cg3::Point2Dd(coordinates[2 * i], coordinates[2 * i + 1]);
+    }
+
+    const float* coordinates = static_cast<const float*>(getCoordinates());
+    return cg3::Point2Dd(coordinates[2 * i], coordinates[2 * i + 1]);
+}
+
+/**
+ * @brief Copies in parallel the points of the file in a vector
+ * @param[out] points: the points of the file
+*/
+void BinaryPointFile::getPoints(std::vector<cg3::Point2Dd>& points) const
+{
+    long long pointNumber = (long long)(getPointNumber());
+    points.resize(size_t(pointNumber));
+
+    #pragma omp parallel for
+    for(long long i = 0; i < pointNumber; i++)
+    {
+        points[size_t(i)] = getPoint(uint64_t(i));
+    }
+}
+
+namespace FileUtils {
+
+/**
+ * @brief Creates the header of a binary point file
+ * @param[in] pointNumber: number of points
+ * @param[in] coordinateSize: floatCoordinates or doubleCoordinates
+ * @param[in] min: minimum corner of the bounding box
+ * @param[in] max: maximum corner of the bounding box
+ * @return header: the header to write at the beginning of the file
+*/
+BinaryPointHeader makeBinaryPointHeader(uint64_t pointNumber, uint32_t coordinateSize,
+                                        const cg3::Point2Dd& min, const cg3::Point2Dd& max)
+{
+    BinaryPointHeader header;
+
+    std::memcpy(header.magic, binaryPointMagic, sizeof(binaryPointMagic));
+    header.version = binaryPointFileVersion;
+    header.endianness = endiannessMarker;
+    header.coordinateSize = coordinateSize;
+    header.reserved = 0;
+    header.pointNumber = pointNumber;
+    header.minX = min.x();
+    header.minY = min.y();
+    header.maxX = max.x();
+    header.maxY = max.y();
+
+    return header;
+}
+
+/**
+ * @brief Saves the points in a binary point file
+ * @param[in] filename: the path of the file
+ * @param[in] points: the points to save
+ * @param[in] coordinateSize: floatCoordinates or doubleCoordinates
+ * @return flag: true if the file was written
+*/
+bool savePointsToBinaryFile(const std::string& filename, const std::vector<cg3::Point2Dd>& points, uint32_t coordinateSize)
+{
+    if(coordinateSize != floatCoordinates && coordinateSize != doubleCoordinates)
+    {
+        return false;
+    }
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    long long pointNumber = (long long)(points.size());
+
+    #pragma omp parallel for reduction(min:minX, minY) reduction(max:maxX, maxY)
+    for(long long i = 0; i < pointNumber; i++)
+    {
+        const cg3::Point2Dd& point = points[size_t(i)];
+        minX = std::min(minX, point.x());
+        minY = std::min(minY, point.y());
+        maxX = std::max(maxX, point.x());
+        maxY = std::max(maxY, point.y());
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    const BinaryPointHeader header = makeBinaryPointHeader(
+                uint64_t(pointNumber), coordinateSize, cg3::Point2Dd(minX, minY), cg3::Point2Dd(maxX, maxY));
+
+    if(!file.write(reinterpret_cast<const char*>(&header), sizeof(header)))
+    {
+        return false;
+    }
+
+    bool written = coordinateSize == doubleCoordinates ?
+                writeCoordinates<double>(file, points) : writeCoordinates<float>(file, points);
+
+    file.close();
+    return written && !file.fail();
+}
+
+/**
+ * @brief Converts a text point file in a binary point file
+ * @param[in] textFilename: the path of the text file
+ * @param[in] binaryFilename: the path of the binary file
+ * @param[out] report: lines of the text file that were ignored, declared and read points
+ * @param[in] coordinateSize: floatCoordinates or doubleCoordinates
+ * @return flag: true if the text file was read and the binary file was written
+*/
+bool convertTextToBinaryPointFile(const std::string& textFilename, const std::string& binaryFilename,
+                                  PointFileReport& report, uint32_t coordinateSize)
+{
+    std::vector<cg3::Point2Dd> points;
+
+    if(!loadPointsFromFile(textFilename, points, report))
+    {
+        return false;
+    }
+
+    return savePointsToBinaryFile(binaryFilename, points, coordinateSize);
+}
+
+/**
+ * @brief Checks if the file starts like a binary point file
+ * @param[in] filename: the path of the file
+ * @return flag: true if the file starts with the magic string of binary point files
+*/
+bool isBinaryPointFile(const std::string& filename)
+{
+    char magic[sizeof(binaryPointMagic)];
+
+    std::ifstream file(filename, std::ios::binary);
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, binaryPointMagic, sizeof(magic)) == 0;
+}
+
+}
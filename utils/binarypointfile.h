@@ -0,0 +1,93 @@
+#ifndef BINARYPOINTFILE_H
+#define BINARYPOINTFILE_H
+
+#include <cstdint>
+
+#include <cg3/geometry/2d/point2d.h>
+#include <cg3/io/memory_mapped_file.h>
+
+#include "fileutils.h"
+
+namespace FileUtils {
+    //size in bytes of each coordinate stored in the file
+    const uint32_t floatCoordinates = 4;
+    const uint32_t doubleCoordinates = 8;
+
+    //written in the native byte order, used to detect files written by a machine with different endianness
+    const uint32_t endiannessMarker = 0x01020304;
+
+    const uint32_t binaryPointFileVersion = 1;
+}
+
+/**
+ * @brief BinaryPointHeader: header of the binary point file
+ *
+ * The header is 64 bytes long, so the coordinates that follow it are aligned for both float and double.
+ * Coordinates are stored as x, y pairs, one pair for each point.
+ */
+struct BinaryPointHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t coordinateSize;
+    uint32_t reserved;
+    uint64_t pointNumber;
+    double minX;
+    double minY;
+    double maxX;
+    double maxY;
+};
+
+static_assert(sizeof(BinaryPointHeader) == 64, "the binary point header must be 64 bytes long");
+
+/**
+ * @brief BinaryPointFile: read-only view of a binary point file
+ *
+ * The file is mapped in memory and the coordinates are used directly from the mapping, without parsing or copying them:
+ * opening a file only validates its header. Files written with a different endianness are rejected.
+ * The points can be read only while the file is open.
+ */
+class BinaryPointFile
+{
+public:
+    BinaryPointFile();
+
+    bool open(const std::string& filename);
+    void close();
+    bool isOpen() const;
+
+    uint64_t getPointNumber() const;
+    uint32_t getCoordinateSize() const;
+    cg3::Point2Dd getMin() const;
+    cg3::Point2Dd getMax() const;
+
+    const void* getCoordinates() const;
+
+    cg3::Point2Dd getPoint(uint64_t i) const;
+    void getPoints(std::vector<cg3::Point2Dd>& points) const;
+
+private:
+    cg3::MemoryMappedFile file;
+    const BinaryPointHeader* header;
+};
+
+namespace FileUtils {
+    BinaryPointHeader makeBinaryPointHeader(
+            uint64_t pointNumber,
+            uint32_t coordinateSize,
+            const cg3::Point2Dd& min,
+            const cg3::Point2Dd& max);
+    bool savePointsToBinaryFile(
+            const std::string& filename,
+            const std::vector<cg3::Point2Dd>& points,
+            uint32_t coordinateSize = doubleCoordinates);
+    bool convertTextToBinaryPointFile(
+            const std::string& textFilename,
+            const std::string& binaryFilename,
+            PointFileReport& report,
+            uint32_t coordinateSize = doubleCoordinates);
+    bool isBinaryPointFile(const std::string& filename);
+}
+
+#endif // BINARYPOINTFILE_H
@@ -1,54 +1,260 @@
 #include "fileutils.h"
+#include "pointgenerator.h"
 
-#include <fstream>
 #include <random>
-#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include <cg3/io/load_save_file.h>
+#include <cg3/io/memory_mapped_file.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 namespace FileUtils {
 
-std::vector<cg3::Point2Dd> getPointsFromFile(const std::string& filename) {
+namespace {
 
-    std::vector<cg3::Point2Dd> points;
-    std::ifstream infile;
-    infile.open(filename);
+//a chunk parsed by a thread is at least 64KB
+const size_t minChunkSize = 1 << 16;
 
-    int n;
-    infile >> n;
+inline bool isBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r';
+}
 
-    for (int i = 0; i < n; i++) {
-        double x = 0.0;
-        double y = 0.0;
-        infile >> std::setprecision(10) >> x >> std::setprecision(10) >> y;
-        cg3::Point2Dd p(x,y);
-        points.push_back(p);
+inline const char* skipBlanks(const char* it, const char* end)
+{
+    while(it < end && isBlank(*it))
+    {
+        it++;
     }
+    return it;
+}
 
-    infile.close();
+inline const char* findNewLine(const char* it, const char* end)
+{
+    const void* newLine = std::memchr(it, '\n', size_t(end - it));
+    return newLine == nullptr ? end : static_cast<const char*>(newLine);
+}
 
-    return points;
 }
 
-void generateRandomPointFile(const std::string& filename, double limit, int n) {
-    std::setprecision(10);
-    std::ofstream outfile;
-    outfile.open(filename);
+/**
+ * @brief Parses a line containing the two coordinates of a point
+ * @param[in] begin: first character of the line
+ * @param[in] end: end of the line (new line character excluded)
+ * @param[out] point: the parsed point
+ * @param[out] empty: true if the line contains only blanks
+ * @return flag: the line contains exactly two numbers
+*/
+bool parsePointLine(const char* begin, const char* end, cg3::Point2Dd& point, bool& empty)
+{
+    const char* it = skipBlanks(begin, end);
+
+    empty = it == end;
+    if(empty)
+    {
+        return false;
+    }
+
+    double x = 0.0;
+    double y = 0.0;
+
+    if(!cg3::loadSave::parseDouble(it, end, x) || !cg3::loadSave::parseDouble(it, end, y) || skipBlanks(it, end) != end)
+    {
+        return false;
+    }
+
+    point.set(x, y);
+    return true;
+}
+
+/**
+ * @brief Parses the first line of a text point file, containing the number of points
+ * @param[in] begin: first character of the line
+ * @param[in] end: end of the line (new line character excluded)
+ * @param[out] count: the number of points
+ * @return flag: the line contains only a non-negative integer
+*/
+bool parsePointCount(const char* begin, const char* end, uint64_t& count)
+{
+    const char* it = begin;
+    double number = 0.0;
+
+    if(!cg3::loadSave::parseDouble(it, end, number) || skipBlanks(it, end) != end ||
+            number < 0 || number != std::floor(number))
+    {
+        return false;
+    }
 
-    double lower_bound = -limit;
-    double upper_bound = limit;
+    count = uint64_t(number);
+    return true;
+}
 
-    std::mt19937 rng;
-    rng.seed(std::random_device()());
-    std::uniform_real_distribution<double> dist(lower_bound,upper_bound); // distribution in range [0, 100]
+/**
+ * @brief Returns true if the number of points read is not the one declared in the first line
+ * @return flag: the counts differ
+*/
+bool PointFileReport::hasCountMismatch() const
+{
+    return declaredPoints != readPoints;
+}
 
-    outfile << n << std::endl;
+/**
+ * @brief Loads the points of a file in parallel
+ *
+ * The file is mapped in memory and split in chunks at line boundaries: lines are counted in parallel to pre-size the
+ * vector of points, then each chunk is parsed in parallel writing directly in its part of the vector.
+ * Blank lines are ignored, lines that don't contain exactly two numbers are reported (the first line of the file is 1);
+ * the number of points declared in the first line and the number of points read are reported too, to find missing points.
+ *
+ * @param[in] filename: the path of the file
+ * @param[out] points: the points read from the file
+ * @param[out] report: sorted numbers of the lines that were ignored, declared and read points
+ * @return flag: false if the file can't be opened or if it doesn't start with the number of points
+*/
+bool loadPointsFromFile(const std::string& filename, std::vector<cg3::Point2Dd>& points, PointFileReport& report)
+{
+    points.clear();
+    report = PointFileReport();
 
-    for (int i = 0; i < n; i++) {
-        double x = dist(rng);
-        double y = dist(rng);
-        outfile << std::setprecision(10) << x << " " << std::setprecision(10) << y << std::endl;
+    cg3::MemoryMappedFile file;
+    if(!file.open(filename) || file.size() == 0)
+    {
+        return false;
     }
 
-    outfile.close();
+    const char* data = file.data();
+    const char* end = data + file.size();
+
+    //first line: number of points
+    const char* headerEnd = findNewLine(data, end);
+
+    if(!parsePointCount(data, headerEnd, report.declaredPoints))
+    {
+        return false;
+    }
+
+    const char* body = headerEnd == end ? end : headerEnd + 1;
+    size_t bodySize = size_t(end - body);
+
+#ifdef _OPENMP
+    size_t threads = size_t(omp_get_max_threads());
+#else
+    size_t threads = 1;
+#endif
+
+    //more chunks than threads to balance lines of different length
+    unsigned int chunkNumber = unsigned(std::max<size_t>(1, std::min<size_t>(threads * 4, bodySize / minChunkSize)));
+
+    //each chunk starts after a new line character
+    std::vector<const char*> bounds(chunkNumber + 1);
+    bounds[0] = body;
+    bounds[chunkNumber] = end;
+
+    for(unsigned int k = 1; k < chunkNumber; k++)
+    {
+        const char* nominal = std::max(body + bodySize / chunkNumber * k, bounds[k - 1]);
+        const char* newLine = findNewLine(nominal, end);
+        bounds[k] = newLine == end ? end : newLine + 1;
+    }
+
+    //count lines of each chunk, the last line could be without new line character
+    std::vector<size_t> firstLine(chunkNumber + 1, 0);
+
+    #pragma omp parallel for
+    for(unsigned int k = 0; k < chunkNumber; k++)
+    {
+        size_t lines = size_t(std::count(bounds[k], bounds[k + 1], '\n'));
+        if(bounds[k + 1] > bounds[k] && bounds[k + 1][-1] != '\n')
+        {
+            lines++;
+        }
+        firstLine[k + 1] = lines;
+    }
+
+    for(unsigned int k = 0; k < chunkNumber; k++)
+    {
+        firstLine[k + 1] += firstLine[k];
+    }
+
+    size_t totalLines = firstLine[chunkNumber];
+
+    points.resize(totalLines);
+    std::vector<unsigned char> validLines(totalLines, 0);
+    std::vector<std::vector<unsigned long>> chunkMalformedLines(chunkNumber);
+
+    #pragma omp parallel for schedule(dynamic)
+    for(unsigned int k = 0; k < chunkNumber; k++)
+    {
+        size_t line = firstLine[k];
+        const char* lineBegin = bounds[k];
+        const char* chunkEnd = bounds[k + 1];
+
+        while(lineBegin < chunkEnd)
+        {
+            const char* lineEnd = findNewLine(lineBegin, chunkEnd);
+
+            bool empty = false;
+            if(parsePointLine(lineBegin, lineEnd, points[line], empty))
+            {
+                validLines[line] = 1;
+            }
+            else if(!empty)
+            {
+                //the header is line 1
+                chunkMalformedLines[k].push_back(line + 2);
+            }
+
+            line++;
+
+            if(lineEnd == chunkEnd)
+            {
+                break;
+            }
+            lineBegin = lineEnd + 1;
+        }
+    }
+
+    //remove blank and malformed lines
+    size_t pointNumber = 0;
+    for(size_t i = 0; i < totalLines; i++)
+    {
+        if(validLines[i])
+        {
+            if(pointNumber != i)
+            {
+                points[pointNumber] = points[i];
+            }
+            pointNumber++;
+        }
+    }
+    points.resize(pointNumber);
+    report.readPoints = pointNumber;
+
+    for(unsigned int k = 0; k < chunkNumber; k++)
+    {
+        report.malformedLines.insert(report.malformedLines.end(), chunkMalformedLines[k].begin(), chunkMalformedLines[k].end());
+    }
+
+    return true;
+}
+
+std::vector<cg3::Point2Dd> getPointsFromFile(const std::string& filename) {
+
+    std::vector<cg3::Point2Dd> points;
+    PointFileReport report;
+
+    loadPointsFromFile(filename, points, report);
+
+    return points;
+}
+
+void generateRandomPointFile(const std::string& filename, double limit, int n) {
+    generatePointFile(filename, limit, uint64_t(std::max(n, 0)), uniformDistribution, false, std::random_device()());
 }
 
 
@@ -1,15 +1,38 @@
 #ifndef FILEUTILS_H
 #define FILEUTILS_H
 
+#include <cstdint>
 #include <vector>
 #include <cg3/geometry/2d/point2d.h>
 
 namespace FileUtils {
+    /**
+     * @brief PointFileReport: problems found reading a text point file
+     *
+     * The malformed lines are the ignored lines (the first line of the file is 1), the count mismatch
+     * is reported apart from them: the number of points declared in the first line is compared with the points read.
+     */
+    struct PointFileReport
+    {
+        std::vector<unsigned long> malformedLines;
+        uint64_t declaredPoints = 0;
+        uint64_t readPoints = 0;
+
+        bool hasCountMismatch() const;
+    };
+
     std::vector<cg3::Point2Dd> getPointsFromFile(const std::string& filename);
+    bool loadPointsFromFile(
+            const std::string& filename,
+            std::vector<cg3::Point2Dd>& points,
+            PointFileReport& report);
     void generateRandomPointFile(
             const std::string& filename,
             double limit,
             int n);
+
+    bool parsePointLine(const char* begin, const char* end, cg3::Point2Dd& point, bool& empty);
+    bool parsePointCount(const char* begin, const char* end, uint64_t& count);
 }
 
 #endif // FILEUTILS_H
@@ -0,0 +1,583 @@
+#include "insertionjournal.h"
+
+#include "algorithms/delaunay.h"
+
+#include "binarypointfile.h"
+#include "triangulationsnapshot.h"
+
+#include <cg3/io/memory_mapped_file.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+//the first 8 bytes of each journal
+const char journalMagic[8] = {'G', 'A', 'S', 'J', 'R', 'N', 'L', '\0'};
+
+const int closedDescriptor = -1;
+
+/**
+ * @brief Computes the FNV-1a hash of the operation and of the coordinates of a record
+ * @param[in] record: the record
+ * @return checksum: the hash
+*/
+uint32_t computeChecksum(const InsertionJournalRecord& record)
+{
+    unsigned char bytes[sizeof(record.operation) + sizeof(record.x) + sizeof(record.y)];
+    std::memcpy(bytes, &record.operation, sizeof(record.operation));
+    std::memcpy(bytes + sizeof(record.operation), &record.x, sizeof(record.x));
+    std::memcpy(bytes + sizeof(record.operation) + sizeof(record.x), &record.y, sizeof(record.y));
+
+    uint32_t hash = 2166136261u;
+    for(unsigned char byte : bytes)
+    {
+        hash = (hash ^ byte) * 16777619u;
+    }
+    return hash;
+}
+
+bool isValid(const InsertionJournalRecord& record)
+{
+    return (record.operation == journalInsert || record.operation == journalClear) &&
+            record.checksum == computeChecksum(record);
+}
+
+/**
+ * @brief Writes the whole buffer, retrying after partial writes and interruptions
+ * @param[in] descriptor: the open file
+ * @param[in] data: the bytes to write
+ * @param[in] size: number of bytes
+ * @return flag: true if every byte was written
+*/
+bool writeAll(int descriptor, const char* data, size_t size)
+{
+    while(size > 0)
+    {
+#ifndef _WIN32
+        ssize_t written = ::write(descriptor, data, size);
+#else
+        int written = _write(descriptor, data, unsigned(size));
+#endif
+        if(written < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if(written <= 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= size_t(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Waits until the written bytes are stored on the device
+ * @param[in] descriptor: the open file
+ * @return flag: true if the data was stored
+*/
+bool syncDescriptor(int descriptor)
+{
+#ifndef _WIN32
+    return fsync(descriptor) == 0;
+#else
+    return _commit(descriptor) == 0;
+#endif
+}
+
+void closeDescriptor(int descriptor)
+{
+#ifndef _WIN32
+    ::close(descriptor);
+#else
+    _close(descriptor);
+#endif
+}
+
+/**
+ * @brief Waits until the content of a closed file is stored on the device
+ * @param[in] filename: the path of the file
+ * @return flag: true if the file was stored
+*/
+bool syncFile(const std::string& filename)
+{
+#ifndef _WIN32
+    int file = ::open(filename.c_str(), O_RDONLY);
+#else
+    int file = _open(filename.c_str(), _O_WRONLY | _O_BINARY);
+#endif
+    if(file < 0)
+    {
+        return false;
+    }
+
+    bool synced = syncDescriptor(file);
+    closeDescriptor(file);
+
+    return synced;
+}
+
+/**
+ * @brief Waits until the entries of the directory containing a file (e.g. its name after a rename) are stored
+ * @param[in] filename: the path of the file
+ * @return flag: true if the directory was stored
+*/
+bool syncDirectory(const std::string& filename)
+{
+#ifndef _WIN32
+    std::string::size_type separator = filename.find_last_of('/');
+    std::string directory = separator == std::string::npos ? "." : filename.substr(0, std::max<std::string::size_type>(separator, 1));
+
+    int file = ::open(directory.c_str(), O_RDONLY);
+    if(file < 0)
+    {
+        return false;
+    }
+
+    bool synced = fsync(file) == 0;
+    closeDescriptor(file);
+
+    return synced;
+#else
+    //directories can't be synced, the rename is stored by the file system
+    (void)filename;
+    return true;
+#endif
+}
+
+bool replaceFile(const std::string& source, const std::string& destination)
+{
+    //rename doesn't replace an existing file on every system
+    if(std::rename(source.c_str(), destination.c_str()) != 0)
+    {
+        std::remove(destination.c_str());
+        return std::rename(source.c_str(), destination.c_str()) == 0;
+    }
+    return true;
+}
+
+}
+
+/**
+ * @brief Creates a closed journal
+*/
+InsertionJournal::InsertionJournal()
+    : descriptor(closedDescriptor), checkpointSlot(0), recordNumber(0), checkpointRecords(checkpointInterval), replayedRecords(0),
+      cleared(false), checkpointVersion(0) {}
+
+/**
+ * @brief Commits the pending records and closes the journal
+*/
+InsertionJournal::~InsertionJournal()
+{
+    close();
+}
+
+/**
+ * @brief Opens the journal of a session, restoring its last checkpoint and replaying the records written after it
+ *
+ * If the journal doesn't exist a new empty one is created. A record written only partially is removed with
+ * all the records that follow it.
+ * @param[in] basename: path of the session without extension, the journal and its checkpoints share it
+ * @param[in/out] triangulation: the triangulation data structure, it must contain only the bounding triangle
+ * @param[in/out] dag: the search data structure, it must contain only the bounding triangle
+ * @param[out] points: the inserted points, in the order of the journal after the ones of the checkpoint
+ * @return flag: false if the journal is not valid, if its checkpoint can't be restored or if it can't be written
+*/
+bool InsertionJournal::open(const std::string& basename, Triangulation& triangulation, DAG& dag, std::vector<cg3::Point2Dd>& points)
+{
+    close();
+
+    this->basename = basename;
+    checkpointSlot = 0;
+    recordNumber = 0;
+    replayedRecords = 0;
+    cleared = false;
+    checkpointVersion = 0;
+
+    if(!std::ifstream(getJournalFilename()).good())
+    {
+        checkpointVersion = triangulation.getVersion();
+        setCheckpointRecords(triangulation);
+        return writeEmptyJournal(getJournalFilename(), 0) && openForAppend(sizeof(InsertionJournalHeader));
+    }
+
+    uint64_t validSize = 0;
+    return replay(triangulation, dag, points, validSize) && openForAppend(validSize);
+}
+
+/**
+ * @brief Commits the pending records and closes the journal file
+*/
+void InsertionJournal::close()
+{
+    if(isOpen())
+    {
+        commit();
+        closeDescriptor(descriptor);
+        descriptor = closedDescriptor;
+    }
+}
+
+/**
+ * @brief Closes the journal and removes it with its checkpoints, used when the session ends without errors
+*/
+void InsertionJournal::discard()
+{
+    close();
+    pending.clear();
+
+    if(!basename.empty())
+    {
+        std::remove(getJournalFilename().c_str());
+        std::remove(getCheckpointFilename(1).c_str());
+        std::remove(getCheckpointFilename(2).c_str());
+    }
+}
+
+bool InsertionJournal::isOpen() const
+{
+    return descriptor != closedDescriptor;
+}
+
+/**
+ * @brief Appends the insertion of a point
+ * @param[in] point: the inserted point
+*/
+void InsertionJournal::appendInsert(const cg3::Point2Dd& point)
+{
+    append(journalInsert, point.x(), point.y());
+}
+
+/**
+ * @brief Appends the removal of every point, after it a checkpoint is needed and cheap
+*/
+void InsertionJournal::appendClear()
+{
+    append(journalClear, 0, 0);
+    cleared = true;
+}
+
+/**
+ * @brief Writes the pending records with a single write and waits until they are stored
+ * @return flag: true if the records were stored
+*/
+bool InsertionJournal::commit()
+{
+    if(pending.empty() || !isOpen())
+    {
+        return pending.empty();
+    }
+
+    bool committed = writeAll(descriptor, reinterpret_cast<const char*>(pending.data()), pending.size() * sizeof(InsertionJournalRecord)) &&
+            syncDescriptor(descriptor);
+
+    pending.clear();
+    return committed;
+}
+
+/**
+ * @brief Returns true if the journal is long enough or if it was cleared
+ * @return flag: true if a checkpoint should be written
+*/
+bool InsertionJournal::needsCheckpoint() const
+{
+    return isOpen() && (cleared || recordNumber >= checkpointRecords);
+}
+
+/**
+ * @brief Stores the triangulation in a snapshot and starts a new empty journal pointing to it
+ *
+ * The pending records are already contained in the snapshot, so they are dropped.
+ * If the checkpoint fails the old journal is still valid and it is still used.
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @return flag: true if the checkpoint was written
+*/
+bool InsertionJournal::checkpoint(const Triangulation& triangulation, const DAG& dag)
+{
+    if(!isOpen())
+    {
+        return false;
+    }
+
+    //the journal on disk already contains the triangulation
+    if(triangulation.getVersion() == checkpointVersion)
+    {
+        return true;
+    }
+
+    //a triangulation with only the bounding triangle doesn't need a snapshot
+    bool empty = triangulation.getTriangles().size() <= 1;
+
+    //the snapshot referenced by the journal on disk is never overwritten
+    uint32_t slot = empty ? 0 : (checkpointSlot == 1 ? 2 : 1);
+
+    //the snapshot is stored before the journal can refer to it
+    if(!empty && (!FileUtils::saveTriangulationSnapshot(getCheckpointFilename(slot), triangulation, dag, true) ||
+                  !syncFile(getCheckpointFilename(slot))))
+    {
+        return false;
+    }
+
+    const std::string temporaryFilename = getJournalFilename() + ".tmp";
+
+    if(!writeEmptyJournal(temporaryFilename, slot) || !replaceFile(temporaryFilename, getJournalFilename()))
+    {
+        std::remove(temporaryFilename.c_str());
+        return false;
+    }
+
+    //the rename is stored with the directory, before it a crash can still restore the old journal
+    if(!syncDirectory(getJournalFilename()))
+    {
+        std::cerr << "The directory of the session journal can't be synced, the checkpoint may be lost after a crash" << std::endl;
+    }
+
+    closeDescriptor(descriptor);
+    descriptor = closedDescriptor;
+
+    if(checkpointSlot != 0 && checkpointSlot != slot)
+    {
+        std::remove(getCheckpointFilename(checkpointSlot).c_str());
+    }
+
+    checkpointSlot = slot;
+    recordNumber = 0;
+    cleared = false;
+    checkpointVersion = triangulation.getVersion();
+    setCheckpointRecords(triangulation);
+    pending.clear();
+
+    return openForAppend(sizeof(InsertionJournalHeader));
+}
+
+/**
+ * @brief Returns the number of records replayed when the journal was opened
+ * @return replayedRecords: number of records
+*/
+uint64_t InsertionJournal::getReplayedRecords() const
+{
+    return replayedRecords;
+}
+
+/**
+ * @brief Adds a record to the pending ones and commits them if they are enough or if the oldest one is too old
+ * @param[in] operation: journalInsert or journalClear
+ * @param[in] x: x coordinate of the inserted point
+ * @param[in] y: y coordinate of the inserted point
+*/
+void InsertionJournal::append(uint32_t operation, double x, double y)
+{
+    if(!isOpen())
+    {
+        return;
+    }
+
+    InsertionJournalRecord record;
+    record.operation = operation;
+    record.x = x;
+    record.y = y;
+    record.checksum = computeChecksum(record);
+
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    if(pending.empty())
+    {
+        firstPendingTime = now;
+    }
+
+    pending.push_back(record);
+    recordNumber++;
+
+    if(pending.size() >= groupCommitRecords || now - firstPendingTime >= groupCommitDelay)
+    {
+        commit();
+    }
+}
+
+/**
+ * @brief Restores the checkpoint of the journal and applies its valid records
+ * @param[in/out] triangulation: the triangulation data structure
+ * @param[in/out] dag: the search data structure
+ * @param[out] points: the inserted points
+ * @param[out] validSize: size of the journal up to the last valid record
+ * @return flag: false if the journal is not valid or if its checkpoint can't be restored
+*/
+bool InsertionJournal::replay(Triangulation& triangulation, DAG& dag, std::vector<cg3::Point2Dd>& points, uint64_t& validSize)
+{
+    cg3::MemoryMappedFile file;
+    if(!file.open(getJournalFilename()) || file.size() < sizeof(InsertionJournalHeader))
+    {
+        return false;
+    }
+
+    InsertionJournalHeader header;
+    std::memcpy(&header, file.data(), sizeof(header));
+
+    if(std::memcmp(header.magic, journalMagic, sizeof(journalMagic)) != 0 ||
+            header.version != insertionJournalVersion ||
+            header.endianness != FileUtils::endiannessMarker ||
+            header.checkpoint > 2)
+    {
+        return false;
+    }
+
+    points.clear();
+
+    if(header.checkpoint != 0)
+    {
+        TriangulationSnapshot snapshot;
+        if(!snapshot.open(getCheckpointFilename(header.checkpoint)) || !snapshot.restore(triangulation, dag))
+        {
+            return false;
+        }
+
+        //the inserted points are the vertices without the bounding triangle
+        const Triangle& boundingTriangle = triangulation.getTriangles()[0];
+        for(uint64_t i = 0; i < snapshot.getVertexNumber(); i++)
+        {
+            const cg3::Point2Dd vertex = snapshot.getVertex(i);
+            if(vertex != boundingTriangle.getV1() && vertex != boundingTriangle.getV2() && vertex != boundingTriangle.getV3())
+            {
+                points.push_back(vertex);
+            }
+        }
+    }
+    checkpointSlot = header.checkpoint;
+
+    const char* records = file.data() + sizeof(InsertionJournalHeader);
+    uint64_t length = (file.size() - sizeof(InsertionJournalHeader)) / sizeof(InsertionJournalRecord);
+
+    uint64_t i = 0;
+    for(; i < length; i++)
+    {
+        InsertionJournalRecord record;
+        std::memcpy(&record, records + i * sizeof(InsertionJournalRecord), sizeof(record));
+
+        //the records after a broken one were never committed
+        if(!isValid(record))
+        {
+            break;
+        }
+
+        if(record.operation == journalInsert)
+        {
+            points.push_back(cg3::Point2Dd(record.x, record.y));
+            DelaunayTriangulation::incrementalTriangulation(triangulation, dag, points.back());
+        }
+        else
+        {
+            points.clear();
+            triangulation.clearDataStructure();
+            dag.clearDataStructure();
+            cleared = true;
+        }
+    }
+
+    replayedRecords = i;
+    recordNumber = i;
+    validSize = sizeof(InsertionJournalHeader) + i * sizeof(InsertionJournalRecord);
+
+    //without records the triangulation is the one of the checkpoint
+    checkpointVersion = i == 0 ? triangulation.getVersion() : 0;
+    setCheckpointRecords(triangulation);
+
+    return true;
+}
+
+/**
+ * @brief Sets the records after which a checkpoint is needed, proportional to the triangles that it would write
+ * @param[in] triangulation: the triangulation of the last checkpoint
+*/
+void InsertionJournal::setCheckpointRecords(const Triangulation& triangulation)
+{
+    checkpointRecords = std::max<uint64_t>(checkpointInterval, triangulation.getTriangles().size() / checkpointTrianglesPerRecord);
+}
+
+/**
+ * @brief Writes a journal with only the header and waits until it is stored
+ * @param[in] filename: the path of the file
+ * @param[in] checkpointSlot: slot of the snapshot the journal refers to, 0 for none
+ * @return flag: true if the file was written
+*/
+bool InsertionJournal::writeEmptyJournal(const std::string& filename, uint32_t checkpointSlot) const
+{
+    InsertionJournalHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, journalMagic, sizeof(journalMagic));
+    header.version = insertionJournalVersion;
+    header.endianness = FileUtils::endiannessMarker;
+    header.checkpoint = checkpointSlot;
+
+#ifndef _WIN32
+    int file = ::open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#else
+    int file = _open(filename.c_str(), _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#endif
+    if(file < 0)
+    {
+        return false;
+    }
+
+    bool written = writeAll(file, reinterpret_cast<const char*>(&header), sizeof(header)) && syncDescriptor(file);
+    closeDescriptor(file);
+
+    return written;
+}
+
+/**
+ * @brief Opens the journal file for writing after its valid records, removing the broken ones
+ * @param[in] size: size of the valid part of the journal
+ * @return flag: true if the file was opened
+*/
+bool InsertionJournal::openForAppend(uint64_t size)
+{
+#ifndef _WIN32
+    descriptor = ::open(getJournalFilename().c_str(), O_WRONLY);
+    bool opened = descriptor >= 0 &&
+            ftruncate(descriptor, off_t(size)) == 0 &&
+            lseek(descriptor, off_t(size), SEEK_SET) == off_t(size);
+#else
+    descriptor = _open(getJournalFilename().c_str(), _O_WRONLY | _O_BINARY);
+    bool opened = descriptor >= 0 &&
+            _chsize_s(descriptor, (long long)size) == 0 &&
+            _lseeki64(descriptor, (long long)size, SEEK_SET) == (long long)size;
+#endif
+
+    if(!opened && descriptor >= 0)
+    {
+        closeDescriptor(descriptor);
+    }
+    if(!opened)
+    {
+        descriptor = closedDescriptor;
+    }
+
+    return opened;
+}
+
+std::string InsertionJournal::getJournalFilename() const
+{
+    return basename + ".gjournal";
+}
+
+std::string InsertionJournal::getCheckpointFilename(uint32_t slot) const
+{
+    return basename + "." + std::to_string(slot) + ".gsnap";
+}
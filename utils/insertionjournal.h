@@ -0,0 +1,127 @@
+#ifndef INSERTIONJOURNAL_H
+#define INSERTIONJOURNAL_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+
+const uint32_t insertionJournalVersion = 1;
+
+//operations stored in the journal
+const uint32_t journalInsert = 1;
+const uint32_t journalClear = 2;
+
+//pending records are committed when they are this many or when the oldest one is this old
+const size_t groupCommitRecords = 64;
+const std::chrono::milliseconds groupCommitDelay(200);
+
+//records after which a new checkpoint should be written, at least one record every checkpointTrianglesPerRecord triangles
+//of the last checkpoint, so the time spent writing checkpoints grows with the insertions and not with the triangulation
+const uint64_t checkpointInterval = 4096;
+const uint64_t checkpointTrianglesPerRecord = 64;
+
+/**
+ * @brief InsertionJournalHeader: header of the journal file
+ *
+ * The checkpoint field is 0 if the records must be replayed on an empty triangulation,
+ * otherwise it is the slot (1 or 2) of the snapshot the records are replayed on.
+ */
+struct InsertionJournalHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t checkpoint;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(InsertionJournalHeader) == 24, "the insertion journal header must be 24 bytes long");
+
+/**
+ * @brief InsertionJournalRecord: an operation of the journal
+ *
+ * The checksum covers the other fields, so a record written only partially before a crash is recognized.
+ * The coordinates are meaningful only for insertions.
+ */
+struct InsertionJournalRecord
+{
+    uint32_t operation;
+    uint32_t checksum;
+    double x;
+    double y;
+};
+
+static_assert(sizeof(InsertionJournalRecord) == 24, "the insertion journal record must be 24 bytes long");
+
+/**
+ * @brief InsertionJournal: append-only log of the operations of an interactive session
+ *
+ * Insertions and clears are appended to a buffer and written with a single write followed by a sync (group commit),
+ * so a crash loses at most the last groupCommitDelay of editing.
+ * A checkpoint stores the whole triangulation with the DAG in a snapshot and starts a new empty journal pointing to it:
+ * the snapshots alternate between two slots and the new journal replaces the old one with a rename,
+ * so the journal on disk always refers to a complete snapshot. The snapshot and the directory are synced before and after
+ * the rename, and a triangulation that didn't change since the last checkpoint is not written again.
+ * Opening the journal restores the last checkpoint and replays only the records written after it.
+ */
+class InsertionJournal
+{
+public:
+    InsertionJournal();
+    ~InsertionJournal();
+
+    InsertionJournal(const InsertionJournal&) = delete;
+    InsertionJournal& operator=(const InsertionJournal&) = delete;
+
+    bool open(const std::string& basename, Triangulation& triangulation, DAG& dag, std::vector<cg3::Point2Dd>& points);
+    void close();
+    void discard();
+
+    bool isOpen() const;
+
+    void appendInsert(const cg3::Point2Dd& point);
+    void appendClear();
+    bool commit();
+
+    bool needsCheckpoint() const;
+    bool checkpoint(const Triangulation& triangulation, const DAG& dag);
+
+    uint64_t getReplayedRecords() const;
+
+private:
+    void append(uint32_t operation, double x, double y);
+
+    bool replay(Triangulation& triangulation, DAG& dag, std::vector<cg3::Point2Dd>& points, uint64_t& validSize);
+    bool writeEmptyJournal(const std::string& filename, uint32_t checkpointSlot) const;
+    bool openForAppend(uint64_t size);
+    void setCheckpointRecords(const Triangulation& triangulation);
+
+    std::string getJournalFilename() const;
+    std::string getCheckpointFilename(uint32_t slot) const;
+
+    std::string basename;
+
+    //descriptor of the journal file, -1 if it is closed
+    int descriptor;
+
+    uint32_t checkpointSlot;
+    uint64_t recordNumber;
+    uint64_t checkpointRecords;
+    uint64_t replayedRecords;
+    bool cleared;
+
+    //version of the triangulation stored by the last checkpoint, 0 if it must be written again
+    unsigned long long checkpointVersion;
+
+    //records not committed yet and time of the oldest one
+    std::vector<InsertionJournalRecord> pending;
+    std::chrono::steady_clock::time_point firstPendingTime;
+};
+
+#endif // INSERTIONJOURNAL_H
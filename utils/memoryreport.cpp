@@ -0,0 +1,187 @@
+#include "memoryreport.h"
+
+#include <iomanip>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace DelaunayTriangulation {
+
+namespace {
+
+/**
+ * @brief Writes a number of bytes in MB
+ * @param[in] stream: the output stream
+ * @param[in] bytes: the bytes
+*/
+void printMegabytes(std::ostream& stream, size_t bytes)
+{
+    std::ios_base::fmtflags flags = stream.flags();
+    std::streamsize precision = stream.precision();
+    stream << std::fixed << std::setprecision(1) << double(bytes) / (1024.0 * 1024.0) << " MB";
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+}
+
+/**
+ * @brief Returns the bytes used by all the structures
+ * @return bytes: the sum of the used bytes
+*/
+size_t MemoryReport::getUsedBytes() const
+{
+    size_t bytes = 0;
+    for(const MemoryUsage& structure : structures)
+    {
+        bytes += structure.usedBytes;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Returns the bytes reserved by all the structures
+ * @return bytes: the sum of the reserved bytes
+*/
+size_t MemoryReport::getReservedBytes() const
+{
+    size_t bytes = 0;
+    for(const MemoryUsage& structure : structures)
+    {
+        bytes += structure.reservedBytes;
+    }
+    return bytes;
+}
+
+/**
+ * @brief Returns the fraction of the stored triangles that are live
+ * @return ratio: live triangles over all the triangles, 0 if there are none
+*/
+double MemoryReport::getLiveRatio() const
+{
+    unsigned int triangles = liveTriangles + deadTriangles;
+    return triangles == 0 ? 0 : double(liveTriangles) / double(triangles);
+}
+
+/**
+ * @brief Returns the reserved bytes for each input point, used to forecast bigger inputs
+ * @return bytes: the mean over the points, 0 if there are none
+*/
+double MemoryReport::getReservedBytesPerPoint() const
+{
+    return points == 0 ? 0 : double(getReservedBytes()) / double(points);
+}
+
+/**
+ * @brief Measures the memory of triangulation, DAG and input points and counts live and dead triangles
+ *
+ * The structures derived from the triangulation are not known here: their usage is added by the caller.
+ *
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] points: the input points
+ * @return report: the memory of each structure and the peak resident memory of the process
+*/
+MemoryReport measureMemory(const Triangulation& triangulation, const DAG& dag, const std::vector<cg3::Point2Dd>& points)
+{
+    MemoryReport report;
+
+    MemoryUsage triangles;
+    triangles.name = "triangles";
+    triangles.add(triangulation.getTriangles());
+
+    MemoryUsage adjacencies;
+    adjacencies.name = "adjacencies";
+    adjacencies.add(triangulation.getAdjacencies());
+
+    MemoryUsage nodes;
+    nodes.name = "DAG nodes";
+    nodes.add(dag.getNodeList());
+
+    MemoryUsage input;
+    input.name = "input points";
+    input.add(points);
+
+    report.structures = {triangles, adjacencies, nodes, input};
+
+    report.points = points.size();
+    for(const Node& node : dag.getNodeList())
+    {
+        if(node.isLeaf())
+        {
+            report.liveTriangles++;
+        }
+        else
+        {
+            report.deadTriangles++;
+        }
+    }
+
+    report.peakResidentBytes = getPeakResidentBytes();
+
+    return report;
+}
+
+/**
+ * @brief Returns the peak resident memory of the process
+ * @return bytes: the maximum resident set size since the start, 0 if it can't be read
+*/
+size_t getPeakResidentBytes()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        return 0;
+    }
+    return size_t(counters.PeakWorkingSetSize);
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    //bytes on macOS
+    return size_t(usage.ru_maxrss);
+#else
+    //kilobytes on Linux
+    return size_t(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+std::ostream& operator<<(std::ostream& stream, const MemoryReport& report)
+{
+    for(const MemoryUsage& structure : report.structures)
+    {
+        stream << "  " << std::left << std::setw(24) << structure.name << std::right << "used ";
+        printMegabytes(stream, structure.usedBytes);
+        stream << ", reserved ";
+        printMegabytes(stream, structure.reservedBytes);
+        stream << std::endl;
+    }
+
+    stream << "  " << std::left << std::setw(24) << "total" << std::right << "used ";
+    printMegabytes(stream, report.getUsedBytes());
+    stream << ", reserved ";
+    printMegabytes(stream, report.getReservedBytes());
+    stream << " (" << report.getReservedBytesPerPoint() << " bytes per point)" << std::endl;
+
+    stream << "  triangles live " << report.liveTriangles << ", dead " << report.deadTriangles
+           << " (live ratio " << report.getLiveRatio() << ")" << std::endl;
+
+    stream << "  peak resident memory ";
+    if(report.peakResidentBytes == 0)
+    {
+        return stream << "not available";
+    }
+    printMegabytes(stream, report.peakResidentBytes);
+    return stream;
+}
+
+}
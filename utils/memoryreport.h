@@ -0,0 +1,50 @@
+#ifndef MEMORYREPORT_H
+#define MEMORYREPORT_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+
+#include "memoryusage.h"
+
+namespace DelaunayTriangulation {
+
+/**
+ * @brief MemoryReport: memory of the triangulation, of its input and of the structures derived from it
+ *
+ * The triangulation keeps every triangle created by the algorithm, the dead ones are the inner nodes of the DAG:
+ * the live ratio and the bytes for each input point allow to forecast the memory of bigger inputs.
+ * The peak resident memory is the one of the whole process since its start.
+ */
+struct MemoryReport
+{
+    std::vector<MemoryUsage> structures;
+
+    size_t points = 0;
+    unsigned int liveTriangles = 0;
+    unsigned int deadTriangles = 0;
+
+    //0 if the system doesn't report it
+    size_t peakResidentBytes = 0;
+
+    size_t getUsedBytes() const;
+    size_t getReservedBytes() const;
+    double getLiveRatio() const;
+    double getReservedBytesPerPoint() const;
+};
+
+MemoryReport measureMemory(const Triangulation& triangulation, const DAG& dag, const std::vector<cg3::Point2Dd>& points);
+
+size_t getPeakResidentBytes();
+
+std::ostream& operator<<(std::ostream& stream, const MemoryReport& report);
+
+}
+
+#endif // MEMORYREPORT_H
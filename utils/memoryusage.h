@@ -0,0 +1,39 @@
+#ifndef MEMORYUSAGE_H
+#define MEMORYUSAGE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace DelaunayTriangulation {
+
+/**
+ * @brief MemoryUsage: bytes of a data structure
+ *
+ * The used bytes are the ones of the stored elements, the reserved bytes are the ones allocated by the containers,
+ * so the difference is the memory left by the growth of the vectors.
+ */
+struct MemoryUsage
+{
+    std::string name;
+    size_t usedBytes = 0;
+    size_t reservedBytes = 0;
+
+    template<class T>
+    void add(const std::vector<T>& vector);
+};
+
+/**
+ * @brief Adds the elements and the capacity of a vector
+ * @param[in] vector: the vector
+*/
+template<class T>
+void MemoryUsage::add(const std::vector<T>& vector)
+{
+    usedBytes += vector.size() * sizeof(T);
+    reservedBytes += vector.capacity() * sizeof(T);
+}
+
+}
+
+#endif // MEMORYUSAGE_H
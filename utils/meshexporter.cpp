@@ -0,0 +1,313 @@
+#include "meshexporter.h"
+
+#include "algorithms/indexedmesh.h"
+
+#include <algorithm>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+namespace FileUtils {
+
+namespace {
+
+//elements formatted by a thread and written with a single call to the stream
+const size_t exportChunkElements = 1 << 16;
+
+//the exported vertices lie on the plane z = 0
+const double exportedZ = 0.0;
+
+const unsigned int removedVertex = std::numeric_limits<unsigned int>::max();
+
+/**
+ * @brief Builds the indexed mesh of the live triangles
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] withBoundingTriangle: false to remove the triangles incident to the vertices of the bounding triangle
+ * @param[out] vertices: the distinct vertices
+ * @param[out] triangleVertices: 3 vertex indices for each triangle
+*/
+void buildExportedMesh(const Triangulation& triangulation, const DAG& dag, bool withBoundingTriangle,
+                       std::vector<cg3::Point2Dd>& vertices, std::vector<unsigned int>& triangleVertices)
+{
+    std::vector<unsigned int> triangleIndices;
+    DelaunayTriangulation::indexTriangulationVertices(triangulation, dag, true, vertices, triangleVertices, triangleIndices);
+
+    if(withBoundingTriangle || triangulation.getTriangles().empty())
+    {
+        return;
+    }
+
+    //the first triangle of the triangulation is always the bounding triangle
+    const Triangle& boundingTriangle = triangulation.getTriangles()[0];
+    const cg3::Point2Dd boundingVertices[] = {boundingTriangle.getV1(), boundingTriangle.getV2(), boundingTriangle.getV3()};
+
+    std::vector<unsigned int> newIndices(vertices.size());
+    unsigned int vertexNumber = 0;
+
+    for(size_t i = 0; i < vertices.size(); i++)
+    {
+        bool bounding = std::find(std::begin(boundingVertices), std::end(boundingVertices), vertices[i]) != std::end(boundingVertices);
+
+        if(bounding)
+        {
+            newIndices[i] = removedVertex;
+        }
+        else
+        {
+            newIndices[i] = vertexNumber;
+            vertices[vertexNumber] = vertices[i];
+            vertexNumber++;
+        }
+    }
+    vertices.resize(vertexNumber);
+
+    size_t triangleNumber = 0;
+
+    for(size_t i = 0; i < triangleVertices.size(); i += 3)
+    {
+        unsigned int v1 = newIndices[triangleVertices[i]];
+        unsigned int v2 = newIndices[triangleVertices[i + 1]];
+        unsigned int v3 = newIndices[triangleVertices[i + 2]];
+
+        if(v1 != removedVertex && v2 != removedVertex && v3 != removedVertex)
+        {
+            triangleVertices[3 * triangleNumber] = v1;
+            triangleVertices[3 * triangleNumber + 1] = v2;
+            triangleVertices[3 * triangleNumber + 2] = v3;
+            triangleNumber++;
+        }
+    }
+    triangleVertices.resize(3 * triangleNumber);
+}
+
+/**
+ * @brief Formats chunks of elements in parallel and writes them in order
+ * @param[in] file: the output stream
+ * @param[in] elementNumber: number of elements to write
+ * @param[in] format: appends to a buffer the elements in [first, last)
+ * @return flag: true if every chunk was written
+*/
+template<typename Formatter>
+bool writeChunks(std::ofstream& file, size_t elementNumber, const Formatter& format)
+{
+    bool written = bool(file);
+
+    long long chunkNumber = (long long)((elementNumber + exportChunkElements - 1) / exportChunkElements);
+
+    #pragma omp parallel
+    {
+        std::string buffer;
+
+        #pragma omp for ordered schedule(static, 1)
+        for(long long chunk = 0; chunk < chunkNumber; chunk++)
+        {
+            size_t first = size_t(chunk) * exportChunkElements;
+            size_t last = std::min(elementNumber, first + exportChunkElements);
+
+            buffer.clear();
+            format(first, last, buffer);
+
+            #pragma omp ordered
+            {
+                written = written && file.write(buffer.data(), std::streamsize(buffer.size()));
+            }
+        }
+    }
+
+    return written;
+}
+
+/**
+ * @brief Appends the decimal digits of an integer
+ * @param[out] buffer: the output buffer
+ * @param[in] value: the integer
+*/
+void appendUnsigned(std::string& buffer, unsigned long long value)
+{
+    char digits[20];
+    unsigned int length = 0;
+
+    do
+    {
+        digits[length++] = char('0' + value % 10);
+        value /= 10;
+    } while(value != 0);
+
+    while(length > 0)
+    {
+        buffer.push_back(digits[--length]);
+    }
+}
+
+/**
+ * @brief Appends a double with enough digits to be read back exactly
+ * @param[out] buffer: the output buffer
+ * @param[in] value: the double
+ * @param[in] decimalPoint: decimal separator of the current locale, replaced by the dot
+*/
+void appendDouble(std::string& buffer, double value, char decimalPoint)
+{
+    char digits[32];
+    int length = std::snprintf(digits, sizeof(digits), "%.17g", value);
+
+    if(decimalPoint != '.')
+    {
+        std::replace(digits, digits + length, decimalPoint, '.');
+    }
+
+    buffer.append(digits, size_t(length));
+}
+
+/**
+ * @brief Appends the bytes of an integer in little-endian order
+ * @param[out] buffer: the output buffer
+ * @param[in] value: the integer
+ * @param[in] size: number of bytes
+*/
+void appendLittleEndian(std::string& buffer, uint64_t value, unsigned int size)
+{
+    for(unsigned int i = 0; i < size; i++)
+    {
+        buffer.push_back(char((value >> (8 * i)) & 0xff));
+    }
+}
+
+void appendLittleEndian(std::string& buffer, double value)
+{
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    appendLittleEndian(buffer, bits, sizeof(bits));
+}
+
+}
+
+/**
+ * @brief Exports the live triangles in a Wavefront OBJ file
+ *
+ * Each vertex is written once and faces refer to vertices by index;
+ * chunks of vertices and faces are formatted in parallel and written in order.
+ *
+ * @param[in] filename: the path of the file
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] withBoundingTriangle: false to remove the triangles incident to the vertices of the bounding triangle
+ * @return flag: true if the file was written
+*/
+bool exportTriangulationToObj(const std::string& filename, const Triangulation& triangulation, const DAG& dag, bool withBoundingTriangle)
+{
+    std::vector<cg3::Point2Dd> vertices;
+    std::vector<unsigned int> triangleVertices;
+    buildExportedMesh(triangulation, dag, withBoundingTriangle, vertices, triangleVertices);
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    file << "# " << vertices.size() << " vertices, " << triangleVertices.size() / 3 << " faces\n";
+
+    //the locale is not changed while the file is written
+    const char decimalPoint = std::localeconv()->decimal_point[0];
+
+    bool written = writeChunks(file, vertices.size(), [&](size_t first, size_t last, std::string& buffer)
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            buffer += "v ";
+            appendDouble(buffer, vertices[i].x(), decimalPoint);
+            buffer.push_back(' ');
+            appendDouble(buffer, vertices[i].y(), decimalPoint);
+            buffer.push_back(' ');
+            appendDouble(buffer, exportedZ, decimalPoint);
+            buffer.push_back('\n');
+        }
+    });
+
+    //OBJ indices start from 1
+    written = written && writeChunks(file, triangleVertices.size() / 3, [&](size_t first, size_t last, std::string& buffer)
+    {
+        for(size_t i = first; i < last; i++)
+        {
+            buffer += "f ";
+            appendUnsigned(buffer, triangleVertices[3 * i] + 1ull);
+            buffer.push_back(' ');
+            appendUnsigned(buffer, triangleVertices[3 * i + 1] + 1ull);
+            buffer.push_back(' ');
+            appendUnsigned(buffer, triangleVertices[3 * i + 2] + 1ull);
+            buffer.push_back('\n');
+        }
+    });
+
+    file.close();
+    return written && !file.fail();
+}
+
+/**
+ * @brief Exports the live triangles in a binary little-endian PLY file
+ *
+ * Vertices are stored as 3 doubles and faces as lists of 3 uint32 indices;
+ * the bytes are written in little-endian order on every system.
+ *
+ * @param[in] filename: the path of the file
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] withBoundingTriangle: false to remove the triangles incident to the vertices of the bounding triangle
+ * @return flag: true if the file was written
+*/
+bool exportTriangulationToPly(const std::string& filename, const Triangulation& triangulation, const DAG& dag, bool withBoundingTriangle)
+{
+    std::vector<cg3::Point2Dd> vertices;
+    std::vector<unsigned int> triangleVertices;
+    buildExportedMesh(triangulation, dag, withBoundingTriangle, vertices, triangleVertices);
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    file << "ply\n"
+         << "format binary_little_endian 1.0\n"
+         << "element vertex " << vertices.size() << "\n"
+         << "property double x\n"
+         << "property double y\n"
+         << "property double z\n"
+         << "element face " << triangleVertices.size() / 3 << "\n"
+         << "property list uchar uint vertex_indices\n"
+         << "end_header\n";
+
+    bool written = writeChunks(file, vertices.size(), [&](size_t first, size_t last, std::string& buffer)
+    {
+        buffer.reserve(3 * sizeof(double) * (last - first));
+
+        for(size_t i = first; i < last; i++)
+        {
+            appendLittleEndian(buffer, vertices[i].x());
+            appendLittleEndian(buffer, vertices[i].y());
+            appendLittleEndian(buffer, exportedZ);
+        }
+    });
+
+    written = written && writeChunks(file, triangleVertices.size() / 3, [&](size_t first, size_t last, std::string& buffer)
+    {
+        buffer.reserve((1 + 3 * sizeof(uint32_t)) * (last - first));
+
+        for(size_t i = first; i < last; i++)
+        {
+            buffer.push_back(char(3));
+            appendLittleEndian(buffer, triangleVertices[3 * i], sizeof(uint32_t));
+            appendLittleEndian(buffer, triangleVertices[3 * i + 1], sizeof(uint32_t));
+            appendLittleEndian(buffer, triangleVertices[3 * i + 2], sizeof(uint32_t));
+        }
+    });
+
+    file.close();
+    return written && !file.fail();
+}
+
+}
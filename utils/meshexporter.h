@@ -0,0 +1,25 @@
+#ifndef MESHEXPORTER_H
+#define MESHEXPORTER_H
+
+#include <string>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+
+namespace FileUtils {
+
+bool exportTriangulationToObj(
+        const std::string& filename,
+        const Triangulation& triangulation,
+        const DAG& dag,
+        bool withBoundingTriangle);
+
+bool exportTriangulationToPly(
+        const std::string& filename,
+        const Triangulation& triangulation,
+        const DAG& dag,
+        bool withBoundingTriangle);
+
+}
+
+#endif // MESHEXPORTER_H
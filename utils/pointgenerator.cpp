@@ -0,0 +1,249 @@
+#include "pointgenerator.h"
+#include "binarypointfile.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace FileUtils {
+
+namespace {
+
+//points generated and written together, each block has its own random generator
+const uint64_t generatorBlockPoints = 1 << 20;
+
+const unsigned int clusterNumber = 16;
+const unsigned int stripNumber = 8;
+
+//the points of the distributions stay a bit inside the limit
+const double circleRadiusRatio = 0.9;
+const double clusterDeviationRatio = 0.02;
+const double stripNoiseRatio = 1e-9;
+
+/**
+ * @brief Generates the points of a block
+ *
+ * The generator of a block depends only on the seed and on the block index,
+ * so the file doesn't depend on the number of threads.
+ */
+class BlockGenerator
+{
+public:
+    BlockGenerator(double limit, uint64_t n, unsigned int distribution, uint64_t seed,
+                   const std::vector<std::pair<double, double>>& clusterCenters)
+        : limit(limit), distribution(distribution), seed(seed), clusterCenters(clusterCenters),
+          gridSide(uint64_t(std::ceil(std::sqrt(double(n))))) {}
+
+    /**
+     * @brief Fills the coordinates of the points of the block as x, y pairs
+     * @param[in] block: index of the block
+     * @param[in] first: index of the first point of the block
+     * @param[in] last: index after the last point of the block
+     * @param[out] coordinates: the generated coordinates
+    */
+    void generate(uint64_t block, uint64_t first, uint64_t last, std::vector<double>& coordinates) const
+    {
+        std::seed_seq sequence = {uint32_t(seed), uint32_t(seed >> 32), uint32_t(block), uint32_t(block >> 32)};
+        std::mt19937_64 rng(sequence);
+
+        std::uniform_real_distribution<double> uniform(-limit, limit);
+        std::uniform_real_distribution<double> angle(0.0, 2.0 * M_PI);
+        std::normal_distribution<double> gaussian(0.0, limit * clusterDeviationRatio);
+        std::uniform_int_distribution<unsigned int> cluster(0, clusterNumber - 1);
+        std::uniform_int_distribution<unsigned int> strip(0, stripNumber - 1);
+        std::uniform_real_distribution<double> noise(-limit * stripNoiseRatio, limit * stripNoiseRatio);
+
+        double spacing = 2.0 * limit / double(gridSide);
+
+        coordinates.clear();
+
+        for(uint64_t i = first; i < last; i++)
+        {
+            double x = 0.0;
+            double y = 0.0;
+
+            switch(distribution)
+            {
+                case gaussianClustersDistribution:
+                {
+                    const std::pair<double, double>& center = clusterCenters[cluster(rng)];
+                    x = std::max(-limit, std::min(limit, center.first + gaussian(rng)));
+                    y = std::max(-limit, std::min(limit, center.second + gaussian(rng)));
+                    break;
+                }
+                case gridDistribution:
+                    x = -limit + (double(i % gridSide) + 0.5) * spacing;
+                    y = -limit + (double(i / gridSide) + 0.5) * spacing;
+                    break;
+                case circleDistribution:
+                {
+                    double alpha = angle(rng);
+                    x = limit * circleRadiusRatio * std::cos(alpha);
+                    y = limit * circleRadiusRatio * std::sin(alpha);
+                    break;
+                }
+                case collinearStripsDistribution:
+                    x = uniform(rng);
+                    y = -limit + (double(strip(rng)) + 0.5) * 2.0 * limit / stripNumber + noise(rng);
+                    break;
+                default:
+                    x = uniform(rng);
+                    y = uniform(rng);
+                    break;
+            }
+
+            coordinates.push_back(x);
+            coordinates.push_back(y);
+        }
+    }
+
+private:
+    const double limit;
+    const unsigned int distribution;
+    const uint64_t seed;
+    const std::vector<std::pair<double, double>>& clusterCenters;
+    const uint64_t gridSide;
+};
+
+}
+
+/**
+ * @brief Generates a file of points for benchmarks
+ *
+ * Blocks of points are generated and formatted in parallel, each one with its own random generator,
+ * and they are written in order with a single write for each block.
+ * The text file has the same format read by loadPointsFromFile, the binary one is the format read by BinaryPointFile.
+ *
+ * @param[in] filename: the path of the file
+ * @param[in] limit: the points are inside the square [-limit, limit]
+ * @param[in] n: number of points
+ * @param[in] distribution: one of the distribution constants
+ * @param[in] binary: true for the binary format, false for the text format
+ * @param[in] seed: seed of the random generators, the same seed generates the same file
+ * @return flag: true if the file was written
+*/
+bool generatePointFile(const std::string& filename, double limit, uint64_t n, unsigned int distribution, bool binary, uint64_t seed)
+{
+    if(distribution >= distributionNumber)
+    {
+        return false;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    //centers of the clusters are shared by all the blocks
+    std::vector<std::pair<double, double>> clusterCenters;
+    std::mt19937_64 centerRng(seed);
+    std::uniform_real_distribution<double> centerDistribution(-limit * 0.8, limit * 0.8);
+    for(unsigned int i = 0; i < clusterNumber; i++)
+    {
+        double x = centerDistribution(centerRng);
+        double y = centerDistribution(centerRng);
+        clusterCenters.push_back(std::make_pair(x, y));
+    }
+
+    const BlockGenerator generator(limit, n, distribution, seed, clusterCenters);
+
+    //the binary header is written again at the end with the bounding box
+    if(binary)
+    {
+        const BinaryPointHeader header = makeBinaryPointHeader(n, doubleCoordinates, cg3::Point2Dd(), cg3::Point2Dd());
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    else
+    {
+        file << n << "\n";
+    }
+
+    double minX = std::numeric_limits<double>::max();
+    double minY = std::numeric_limits<double>::max();
+    double maxX = std::numeric_limits<double>::lowest();
+    double maxY = std::numeric_limits<double>::lowest();
+
+    bool written = bool(file);
+
+    long long blockNumber = (long long)((n + generatorBlockPoints - 1) / generatorBlockPoints);
+
+    #pragma omp parallel
+    {
+        std::vector<double> coordinates;
+        coordinates.reserve(2 * generatorBlockPoints);
+
+        //the classic locale always uses the dot as decimal separator
+        std::ostringstream text;
+        text.imbue(std::locale::classic());
+        text.precision(10);
+
+        #pragma omp for ordered schedule(static, 1)
+        for(long long block = 0; block < blockNumber; block++)
+        {
+            uint64_t first = uint64_t(block) * generatorBlockPoints;
+            uint64_t last = std::min(n, first + generatorBlockPoints);
+
+            generator.generate(uint64_t(block), first, last, coordinates);
+
+            double blockMinX = std::numeric_limits<double>::max();
+            double blockMinY = std::numeric_limits<double>::max();
+            double blockMaxX = std::numeric_limits<double>::lowest();
+            double blockMaxY = std::numeric_limits<double>::lowest();
+
+            for(size_t i = 0; i < coordinates.size(); i += 2)
+            {
+                blockMinX = std::min(blockMinX, coordinates[i]);
+                blockMaxX = std::max(blockMaxX, coordinates[i]);
+                blockMinY = std::min(blockMinY, coordinates[i + 1]);
+                blockMaxY = std::max(blockMaxY, coordinates[i + 1]);
+            }
+
+            if(!binary)
+            {
+                text.str(std::string());
+                for(size_t i = 0; i < coordinates.size(); i += 2)
+                {
+                    text << coordinates[i] << ' ' << coordinates[i + 1] << '\n';
+                }
+            }
+
+            #pragma omp ordered
+            {
+                if(binary)
+                {
+                    written = written && file.write(reinterpret_cast<const char*>(coordinates.data()),
+                                                    std::streamsize(coordinates.size() * sizeof(double)));
+                }
+                else
+                {
+                    const std::string formattedBlock = text.str();
+                    written = written && file.write(formattedBlock.data(), std::streamsize(formattedBlock.size()));
+                }
+
+                minX = std::min(minX, blockMinX);
+                minY = std::min(minY, blockMinY);
+                maxX = std::max(maxX, blockMaxX);
+                maxY = std::max(maxY, blockMaxY);
+            }
+        }
+    }
+
+    if(binary && written)
+    {
+        const BinaryPointHeader header = makeBinaryPointHeader(
+                    n, doubleCoordinates, cg3::Point2Dd(minX, minY), cg3::Point2Dd(maxX, maxY));
+        file.seekp(0);
+        written = bool(file.write(reinterpret_cast<const char*>(&header), sizeof(header)));
+    }
+
+    file.close();
+    return written && !file.fail();
+}
+
+}
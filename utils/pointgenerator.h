@@ -0,0 +1,35 @@
+#ifndef POINTGENERATOR_H
+#define POINTGENERATOR_H
+
+#include <cstdint>
+#include <string>
+
+namespace FileUtils {
+
+//distributions of generated points
+const unsigned int uniformDistribution = 0;
+//points around a few centers, many points in small areas
+const unsigned int gaussianClustersDistribution = 1;
+//regular grid, each cell is a square with 4 cocircular vertices
+const unsigned int gridDistribution = 2;
+//points on the same circle
+const unsigned int circleDistribution = 3;
+//points on a few horizontal lines with a tiny vertical noise
+const unsigned int collinearStripsDistribution = 4;
+
+const unsigned int distributionNumber = 5;
+
+const char* const distributionNames[distributionNumber] = {
+    "Uniform", "Gaussian clusters", "Regular grid", "Circle", "Near-collinear strips"};
+
+bool generatePointFile(
+        const std::string& filename,
+        double limit,
+        uint64_t n,
+        unsigned int distribution,
+        bool binary,
+        uint64_t seed);
+
+}
+
+#endif // POINTGENERATOR_H
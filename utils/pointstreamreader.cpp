@@ -0,0 +1,315 @@
+#include "pointstreamreader.h"
+#include "fileutils.h"
+#include "tracing.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <random>
+
+/**
+ * @brief Creates a reader
+ * @param[in] chunkPoints: number of points of each chunk
+ * @param[in] queueCapacity: maximum number of chunks parsed in advance
+*/
+PointStreamReader::PointStreamReader(size_t chunkPoints, size_t queueCapacity)
+    : chunkPoints(std::max<size_t>(1, chunkPoints)), queueCapacity(std::max<size_t>(1, queueCapacity)),
+      finished(false), stopped(false), declaredPoints(0), waitTime(0.0) {}
+
+/**
+ * @brief Stops the reader thread if the consumer didn't read the whole file
+*/
+PointStreamReader::~PointStreamReader()
+{
+    stop();
+}
+
+/**
+ * @brief Opens the file and starts the reader thread
+ * @param[in] filename: the path of a text or binary point file
+ * @return flag: false if the file can't be opened or if it is not a point file
+*/
+bool PointStreamReader::start(const std::string& filename)
+{
+    stop();
+
+    chunks.clear();
+    report = FileUtils::PointFileReport();
+    declaredPoints = 0;
+    finished = false;
+    stopped = false;
+    waitTime = 0.0;
+
+    if(FileUtils::isBinaryPointFile(filename))
+    {
+        if(!binaryFile.open(filename))
+        {
+            return false;
+        }
+        reader = std::thread(&PointStreamReader::readBinary, this);
+    }
+    else
+    {
+        if(!textFile.open(filename) || textFile.size() == 0)
+        {
+            return false;
+        }
+
+        //like the files loaded at once, the file must start with the number of points
+        const char* end = textFile.data() + textFile.size();
+        const void* newLine = std::memchr(textFile.data(), '\n', textFile.size());
+        if(!FileUtils::parsePointCount(textFile.data(), newLine == nullptr ? end : static_cast<const char*>(newLine), declaredPoints))
+        {
+            textFile.close();
+            return false;
+        }
+        reader = std::thread(&PointStreamReader::readText, this);
+    }
+
+    return true;
+}
+
+/**
+ * @brief Waits at most a timeout for the next chunk, so the consumer can do other work while the reader is behind
+ * @param[in] timeout: the maximum waiting time
+ * @return flag: true if nextChunk returns without waiting
+*/
+bool PointStreamReader::waitForChunk(std::chrono::milliseconds timeout)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    bool ready = notEmpty.wait_for(lock, timeout, [this] { return !chunks.empty() || finished || stopped; });
+
+    waitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    return ready;
+}
+
+/**
+ * @brief Returns the next chunk of points, waiting for the reader if it is not ready
+ * @param[out] chunk: the points of the chunk
+ * @return flag: false when the whole file was read or when the reader was stopped
+*/
+bool PointStreamReader::nextChunk(std::vector<cg3::Point2Dd>& chunk)
+{
+    std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    notEmpty.wait(lock, [this] { return !chunks.empty() || finished || stopped; });
+
+    waitTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+    if(stopped || chunks.empty())
+    {
+        return false;
+    }
+
+    chunk.swap(chunks.front());
+    chunks.pop_front();
+
+    lock.unlock();
+    notFull.notify_one();
+
+    return true;
+}
+
+/**
+ * @brief Returns the time spent by the consumer waiting for the reader
+ * @return seconds: the waiting time
+*/
+double PointStreamReader::getWaitTime() const
+{
+    return waitTime;
+}
+
+/**
+ * @brief Returns the problems of the text file, valid after the last chunk
+ * @return report: sorted numbers of the ignored lines, declared and read points (both 0 if the file was not read to the end)
+*/
+const FileUtils::PointFileReport& PointStreamReader::getReport() const
+{
+    return report;
+}
+
+/**
+ * @brief Parses the text file line by line, after the first line with the number of points
+*/
+void PointStreamReader::readText()
+{
+    Tracing::setThreadName("reader");
+    Tracing::Scope load("load");
+
+    const char* it = textFile.data();
+    const char* end = it + textFile.size();
+
+    //the header was parsed by start
+    const void* headerEnd = std::memchr(it, '\n', size_t(end - it));
+    it = headerEnd == nullptr ? end : static_cast<const char*>(headerEnd) + 1;
+
+    unsigned long line = 2;
+    uint64_t pointNumber = 0;
+
+    std::vector<cg3::Point2Dd> chunk;
+    chunk.reserve(chunkPoints);
+
+    while(it < end)
+    {
+        const void* newLine = std::memchr(it, '\n', size_t(end - it));
+        const char* lineEnd = newLine == nullptr ? end : static_cast<const char*>(newLine);
+
+        cg3::Point2Dd point;
+        bool empty = false;
+
+        if(FileUtils::parsePointLine(it, lineEnd, point, empty))
+        {
+            chunk.push_back(point);
+            pointNumber++;
+
+            if(chunk.size() == chunkPoints)
+            {
+                if(!pushChunk(chunk))
+                {
+                    finish();
+                    return;
+                }
+                chunk.reserve(chunkPoints);
+            }
+        }
+        else if(!empty)
+        {
+            report.malformedLines.push_back(line);
+        }
+
+        line++;
+
+        if(lineEnd == end)
+        {
+            break;
+        }
+        it = lineEnd + 1;
+    }
+
+    if(!chunk.empty() && !pushChunk(chunk))
+    {
+        finish();
+        return;
+    }
+
+    //the counts are compared only when the whole file was read
+    report.declaredPoints = declaredPoints;
+    report.readPoints = pointNumber;
+
+    finish();
+}
+
+/**
+ * @brief Copies the points of the binary file in chunks, taking the points in blocks in random order
+ *
+ * The file is mapped, so the blocks can be read in any order: the chunks of a file sorted in space
+ * (e.g. a grid written by rows) contain points of the whole plane instead of sweeping it.
+*/
+void PointStreamReader::readBinary()
+{
+    Tracing::setThreadName("reader");
+    Tracing::Scope load("load");
+
+    uint64_t pointNumber = binaryFile.getPointNumber();
+
+    std::vector<uint64_t> blocks;
+    for(uint64_t first = 0; first < pointNumber; first += streamBlockPoints)
+    {
+        blocks.push_back(first);
+    }
+    std::shuffle(blocks.begin(), blocks.end(), std::mt19937(std::random_device{}()));
+
+    std::vector<cg3::Point2Dd> chunk;
+    chunk.reserve(chunkPoints);
+
+    for(uint64_t first : blocks)
+    {
+        uint64_t last = std::min<uint64_t>(pointNumber, first + streamBlockPoints);
+
+        for(uint64_t i = first; i < last; i++)
+        {
+            chunk.push_back(binaryFile.getPoint(i));
+
+            if(chunk.size() == chunkPoints)
+            {
+                if(!pushChunk(chunk))
+                {
+                    finish();
+                    return;
+                }
+                chunk.reserve(chunkPoints);
+            }
+        }
+    }
+
+    if(!chunk.empty() && !pushChunk(chunk))
+    {
+        finish();
+        return;
+    }
+
+    finish();
+}
+
+/**
+ * @brief Moves the chunk in the queue, waiting if the queue is full
+ * @param[in/out] chunk: the chunk to send, it is left empty
+ * @return flag: false if the reader was stopped
+*/
+bool PointStreamReader::pushChunk(std::vector<cg3::Point2Dd>& chunk)
+{
+    std::unique_lock<std::mutex> lock(mutex);
+    notFull.wait(lock, [this] { return chunks.size() < queueCapacity || stopped; });
+
+    if(stopped)
+    {
+        return false;
+    }
+
+    chunks.push_back(std::vector<cg3::Point2Dd>());
+    chunks.back().swap(chunk);
+
+    lock.unlock();
+    notEmpty.notify_one();
+
+    return true;
+}
+
+/**
+ * @brief Signals the consumer that there are no more chunks
+*/
+void PointStreamReader::finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        finished = true;
+    }
+    notEmpty.notify_all();
+}
+
+/**
+ * @brief Stops the reader thread and releases the file, also if the consumer didn't read all the chunks
+ *
+ * A consumer waiting for a chunk, also on another thread, is woken up and gets no more chunks.
+*/
+void PointStreamReader::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopped = true;
+    }
+    notFull.notify_all();
+    notEmpty.notify_all();
+
+    if(reader.joinable())
+    {
+        reader.join();
+    }
+
+    textFile.close();
+    binaryFile.close();
+}
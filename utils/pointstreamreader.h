@@ -0,0 +1,80 @@
+#ifndef POINTSTREAMREADER_H
+#define POINTSTREAMREADER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <cg3/geometry/2d/point2d.h>
+#include <cg3/io/memory_mapped_file.h>
+
+#include "binarypointfile.h"
+#include "fileutils.h"
+
+//points parsed before sending a chunk to the consumer
+const size_t defaultStreamChunkPoints = 1 << 16;
+//chunks parsed in advance, they bound the memory used by the reader
+const size_t defaultStreamQueueCapacity = 8;
+//points of the blocks of a binary file, read in random order
+const size_t streamBlockPoints = 1024;
+
+/**
+ * @brief PointStreamReader: reads a point file on a separate thread
+ *
+ * The reader thread parses the file (text or binary) in chunks of points and pushes them in a bounded queue,
+ * so the consumer can insert the points of a chunk while the next ones are read.
+ * The lines of a text file are read in order, the points of a binary file are read in blocks in random order.
+ * When the queue is full the reader waits, so the memory used doesn't depend on the size of the file.
+ * The time spent by the consumer waiting for chunks is measured, it is the part of the I/O not overlapped with the computation.
+ */
+class PointStreamReader
+{
+public:
+    PointStreamReader(size_t chunkPoints = defaultStreamChunkPoints, size_t queueCapacity = defaultStreamQueueCapacity);
+    ~PointStreamReader();
+
+    PointStreamReader(const PointStreamReader&) = delete;
+    PointStreamReader& operator=(const PointStreamReader&) = delete;
+
+    bool start(const std::string& filename);
+    bool waitForChunk(std::chrono::milliseconds timeout);
+    bool nextChunk(std::vector<cg3::Point2Dd>& chunk);
+    void stop();
+
+    double getWaitTime() const;
+    const FileUtils::PointFileReport& getReport() const;
+
+private:
+    void readText();
+    void readBinary();
+    bool pushChunk(std::vector<cg3::Point2Dd>& chunk);
+    void finish();
+
+    const size_t chunkPoints;
+    const size_t queueCapacity;
+
+    cg3::MemoryMappedFile textFile;
+    BinaryPointFile binaryFile;
+    std::thread reader;
+
+    //queue shared by reader and consumer
+    std::mutex mutex;
+    std::condition_variable notEmpty;
+    std::condition_variable notFull;
+    std::deque<std::vector<cg3::Point2Dd>> chunks;
+    bool finished;
+    bool stopped;
+
+    //number of points in the first line of a text file
+    uint64_t declaredPoints;
+
+    //written by the reader, read by the consumer after the last chunk
+    FileUtils::PointFileReport report;
+
+    //seconds spent by the consumer waiting for chunks
+    double waitTime;
+};
+
+#endif // POINTSTREAMREADER_H
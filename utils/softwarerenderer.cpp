@@ -0,0 +1,437 @@
+#include "softwarerenderer.h"
+
+#include <algorithm>
+#include <cmath>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include <QImage>
+#include <QString>
+
+namespace {
+
+cg3::Point2Dd getTriangleCorner(const Triangle& triangle, unsigned int corner)
+{
+    return corner == 0 ? triangle.getV1() : (corner == 1 ? triangle.getV2() : triangle.getV3());
+}
+
+}
+
+/**
+ * @brief Creates an image showing a rectangle of the plane, filled with the background color
+ * @param[in] width: width of the image in pixels
+ * @param[in] height: height of the image in pixels
+ * @param[in] min: lower left corner of the rectangle
+ * @param[in] max: upper right corner of the rectangle
+*/
+SoftwareRenderer::SoftwareRenderer(unsigned int width, unsigned int height, const cg3::Point2Dd& min, const cg3::Point2Dd& max) :
+    width(width), height(height), minX(min.x()), maxY(max.y()),
+    scaleX(width / (max.x() - min.x())), scaleY(height / (max.y() - min.y())),
+    pixels(size_t(width) * height * 3)
+{
+    clear(renderBackgroundColor);
+}
+
+/**
+ * @brief Fills the image with a color
+ * @param[in] color: the color
+*/
+void SoftwareRenderer::clear(const RenderColor& color)
+{
+    size_t pixelNumber = size_t(width) * height;
+    for(size_t i = 0; i < pixelNumber; i++)
+    {
+        pixels[3 * i] = color.red;
+        pixels[3 * i + 1] = color.green;
+        pixels[3 * i + 2] = color.blue;
+    }
+}
+
+/**
+ * @brief Draws the edges of the live triangles
+ *
+ * Each triangle draws the edges it doesn't share with a triangle with a lower index, so every edge is drawn once.
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure, used to know which triangles are live
+ * @param[in] withBoundingTriangle: false to ignore the edges incident to the vertices of the bounding triangle
+ * @param[in] color: the color of the edges
+*/
+void SoftwareRenderer::drawTriangulation(const Triangulation& triangulation, const DAG& dag, bool withBoundingTriangle, const RenderColor& color)
+{
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    if(triangles.empty())
+    {
+        return;
+    }
+
+    //the first triangle of the triangulation is always the bounding triangle
+    const cg3::Point2Dd boundingVertices[] = {triangles[0].getV1(), triangles[0].getV2(), triangles[0].getV3()};
+
+    drawInBands(triangles.size(), [&](size_t i, double& firstRow, double& lastRow)
+    {
+        if(!nodes[i].isLeaf())
+        {
+            return false;
+        }
+
+        const Triangle& triangle = triangles[i];
+        double y1 = toPixelY(triangle.getV1().y());
+        double y2 = toPixelY(triangle.getV2().y());
+        double y3 = toPixelY(triangle.getV3().y());
+
+        firstRow = std::min(std::min(y1, y2), y3);
+        lastRow = std::max(std::max(y1, y2), y3);
+        return true;
+    },
+    [&](size_t i, long long firstRow, long long lastRow)
+    {
+        const Triangle& triangle = triangles[i];
+        const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(unsigned(i));
+
+        for(unsigned int edge = 0; edge < 3; edge++)
+        {
+            if(adjacencies[edge] != noAdjacentTriangle && size_t(adjacencies[edge]) < i)
+            {
+                continue;
+            }
+
+            const cg3::Point2Dd first = getTriangleCorner(triangle, edge);
+            const cg3::Point2Dd second = getTriangleCorner(triangle, (edge + 1) % 3);
+
+            if(!withBoundingTriangle &&
+                    (std::find(std::begin(boundingVertices), std::end(boundingVertices), first) != std::end(boundingVertices) ||
+                     std::find(std::begin(boundingVertices), std::end(boundingVertices), second) != std::end(boundingVertices)))
+            {
+                continue;
+            }
+
+            drawSegment(toPixelX(first.x()), toPixelY(first.y()), toPixelX(second.x()), toPixelY(second.y()), firstRow, lastRow, color);
+        }
+    });
+}
+
+/**
+ * @brief Draws the edges and the vertices of a Voronoi diagram
+ * @param[in] diagram: the diagram, already updated
+ * @param[in] edgeColor: the color of the edges
+ * @param[in] vertexColor: the color of the vertices
+ * @param[in] vertexSize: the side of the squares of the vertices, in pixels
+*/
+void SoftwareRenderer::drawVoronoi(const VoronoiDiagram& diagram, const RenderColor& edgeColor, const RenderColor& vertexColor, unsigned int vertexSize)
+{
+    const std::vector<double>& coordinates = diagram.getVertexCoordinates();
+    const std::vector<unsigned int>& edgeVertices = diagram.getEdgeVertices();
+
+    drawSegments(diagram.getEdgeNumber(), [&](size_t i, double& x0, double& y0, double& x1, double& y1)
+    {
+        x0 = coordinates[2 * edgeVertices[2 * i]];
+        y0 = coordinates[2 * edgeVertices[2 * i] + 1];
+        x1 = coordinates[2 * edgeVertices[2 * i + 1]];
+        y1 = coordinates[2 * edgeVertices[2 * i + 1] + 1];
+    }, edgeColor);
+
+    drawSquares(diagram.getVertexNumber(), [&](size_t i, double& x, double& y)
+    {
+        x = coordinates[2 * i];
+        y = coordinates[2 * i + 1];
+    }, vertexColor, vertexSize);
+}
+
+/**
+ * @brief Draws points as squares
+ * @param[in] points: the points
+ * @param[in] color: the color of the points
+ * @param[in] size: the side of the squares, in pixels
+*/
+void SoftwareRenderer::drawPoints(const std::vector<cg3::Point2Dd>& points, const RenderColor& color, unsigned int size)
+{
+    drawSquares(points.size(), [&](size_t i, double& x, double& y)
+    {
+        x = points[i].x();
+        y = points[i].y();
+    }, color, size);
+}
+
+/**
+ * @brief Saves the image in a PNG file
+ *
+ * QImage encodes the pixels without a display or a GL context.
+ * @param[in] filename: the path of the file
+ * @return flag: true if the file was written
+*/
+bool SoftwareRenderer::savePng(const std::string& filename) const
+{
+    //the rows are packed, QImage would otherwise align them to 4 bytes
+    QImage image(pixels.data(), int(width), int(height), int(3 * width), QImage::Format_RGB888);
+    return image.save(QString::fromStdString(filename), "PNG");
+}
+
+unsigned int SoftwareRenderer::getWidth() const
+{
+    return width;
+}
+
+unsigned int SoftwareRenderer::getHeight() const
+{
+    return height;
+}
+
+/**
+ * @brief Returns the red, green and blue bytes of each pixel, row by row from the top
+ * @return pixels: the pixels
+*/
+const std::vector<unsigned char>& SoftwareRenderer::getPixels() const
+{
+    return pixels;
+}
+
+/**
+ * @brief Draws primitives in parallel, band by band
+ *
+ * The primitives are assigned to the bands they cross by the threads, each with its own lists,
+ * then each band draws the primitives of all the lists, in order.
+ * @param[in] number: number of primitives
+ * @param[in] getRows: sets the first and the last row, as real numbers, of the i-th primitive; it returns false if it must not be drawn
+ * @param[in] draw: draws the part of the i-th primitive in the rows from first to last
+*/
+template<typename RowRange, typename BandDrawer>
+void SoftwareRenderer::drawInBands(size_t number, const RowRange& getRows, const BandDrawer& draw)
+{
+    long long bandNumber = (height + renderRowsPerBand - 1) / renderRowsPerBand;
+    long long length = (long long)(number);
+
+#ifdef _OPENMP
+    size_t threads = size_t(omp_get_max_threads());
+#else
+    size_t threads = 1;
+#endif
+
+    std::vector<std::vector<std::vector<unsigned int>>> bands(threads, std::vector<std::vector<unsigned int>>(size_t(bandNumber)));
+
+    #pragma omp parallel
+    {
+#ifdef _OPENMP
+        std::vector<std::vector<unsigned int>>& threadBands = bands[size_t(omp_get_thread_num())];
+#else
+        std::vector<std::vector<unsigned int>>& threadBands = bands[0];
+#endif
+
+        #pragma omp for schedule(static)
+        for(long long i = 0; i < length; i++)
+        {
+            double firstRow, lastRow;
+            if(!getRows(size_t(i), firstRow, lastRow) || lastRow < 0 || firstRow >= height || std::isnan(firstRow) || std::isnan(lastRow))
+            {
+                continue;
+            }
+
+            long long firstBand = (long long)(std::max(std::floor(firstRow), 0.0)) / renderRowsPerBand;
+            long long lastBand = (long long)(std::min(std::floor(lastRow), double(height - 1))) / renderRowsPerBand;
+
+            for(long long band = firstBand; band <= lastBand; band++)
+            {
+                threadBands[size_t(band)].push_back(unsigned(i));
+            }
+        }
+    }
+
+    #pragma omp parallel for schedule(dynamic)
+    for(long long band = 0; band < bandNumber; band++)
+    {
+        long long firstRow = band * renderRowsPerBand;
+        long long lastRow = std::min(firstRow + renderRowsPerBand, (long long)(height)) - 1;
+
+        for(size_t thread = 0; thread < threads; thread++)
+        {
+            for(unsigned int i : bands[thread][size_t(band)])
+            {
+                draw(size_t(i), firstRow, lastRow);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Draws segments
+ * @param[in] number: number of segments
+ * @param[in] getSegment: sets the coordinates of the endpoints of the i-th segment, in the plane
+ * @param[in] color: the color of the segments
+*/
+template<typename SegmentGetter>
+void SoftwareRenderer::drawSegments(size_t number, const SegmentGetter& getSegment, const RenderColor& color)
+{
+    drawInBands(number, [&](size_t i, double& firstRow, double& lastRow)
+    {
+        double x0, y0, x1, y1;
+        getSegment(i, x0, y0, x1, y1);
+
+        firstRow = std::min(toPixelY(y0), toPixelY(y1));
+        lastRow = std::max(toPixelY(y0), toPixelY(y1));
+        return true;
+    },
+    [&](size_t i, long long firstRow, long long lastRow)
+    {
+        double x0, y0, x1, y1;
+        getSegment(i, x0, y0, x1, y1);
+
+        drawSegment(toPixelX(x0), toPixelY(y0), toPixelX(x1), toPixelY(y1), firstRow, lastRow, color);
+    });
+}
+
+/**
+ * @brief Draws squares centered in points
+ * @param[in] number: number of points
+ * @param[in] getPoint: sets the coordinates of the i-th point, in the plane
+ * @param[in] color: the color of the squares
+ * @param[in] size: the side of the squares, in pixels
+*/
+template<typename PointGetter>
+void SoftwareRenderer::drawSquares(size_t number, const PointGetter& getPoint, const RenderColor& color, unsigned int size)
+{
+    //the square covers the pixel of the point and size / 2 pixels before it
+    long long before = size / 2;
+    long long after = (long long)(size) - before - 1;
+
+    drawInBands(number, [&](size_t i, double& firstRow, double& lastRow)
+    {
+        double x, y;
+        getPoint(i, x, y);
+
+        double column = std::floor(toPixelX(x));
+        if(column + after < 0 || column - before >= width)
+        {
+            return false;
+        }
+
+        double row = std::floor(toPixelY(y));
+        firstRow = row - before;
+        lastRow = row + after;
+        return true;
+    },
+    [&](size_t i, long long firstRow, long long lastRow)
+    {
+        double x, y;
+        getPoint(i, x, y);
+
+        long long column = (long long)(std::floor(toPixelX(x)));
+        long long row = (long long)(std::floor(toPixelY(y)));
+
+        for(long long r = std::max(row - before, firstRow); r <= std::min(row + after, lastRow); r++)
+        {
+            for(long long c = column - before; c <= column + after; c++)
+            {
+                setPixel(c, r, color);
+            }
+        }
+    });
+}
+
+/**
+ * @brief Draws the pixels of a segment in some rows
+ *
+ * The segment is sampled at the centers of the pixels along its main direction, so the pixels of a segment don't depend
+ * on the band that draws them; the range of the samples is first limited to the image and to the rows, so long segments
+ * outside the view cost nothing.
+ * @param[in] x0, y0: first endpoint, in pixels
+ * @param[in] x1, y1: second endpoint, in pixels
+ * @param[in] firstRow: first row to draw
+ * @param[in] lastRow: last row to draw
+ * @param[in] color: the color of the segment
+*/
+void SoftwareRenderer::drawSegment(double x0, double y0, double x1, double y1, long long firstRow, long long lastRow, const RenderColor& color)
+{
+    double dx = x1 - x0;
+    double dy = y1 - y0;
+
+    if(std::abs(dx) >= std::abs(dy))
+    {
+        if(dx == 0)
+        {
+            setPixel((long long)(std::floor(x0)), (long long)(std::floor(y0)), color);
+            return;
+        }
+        if(dx < 0)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+            dx = -dx;
+            dy = -dy;
+        }
+
+        double slope = dy / dx;
+
+        double first = std::max(std::ceil(x0 - 0.5), 0.0);
+        double last = std::min(std::floor(x1 - 0.5), double(width) - 1);
+
+        //columns where the segment crosses the rows, one more on each side for the rounding
+        if(slope != 0)
+        {
+            double top = x0 + (firstRow - y0) / slope;
+            double bottom = x0 + (lastRow + 1 - y0) / slope;
+            first = std::max(first, std::floor(std::min(top, bottom)) - 1);
+            last = std::min(last, std::ceil(std::max(top, bottom)) + 1);
+        }
+
+        for(long long column = (long long)(first); column <= (long long)(last); column++)
+        {
+            long long row = (long long)(std::floor(y0 + (column + 0.5 - x0) * slope));
+            if(row >= firstRow && row <= lastRow)
+            {
+                setPixel(column, row, color);
+            }
+        }
+    }
+    else
+    {
+        if(dy < 0)
+        {
+            std::swap(x0, x1);
+            std::swap(y0, y1);
+            dx = -dx;
+            dy = -dy;
+        }
+
+        double slope = dx / dy;
+
+        double first = std::max(std::ceil(y0 - 0.5), double(firstRow));
+        double last = std::min(std::floor(y1 - 0.5), double(lastRow));
+
+        for(long long row = (long long)(first); row <= (long long)(last); row++)
+        {
+            setPixel((long long)(std::floor(x0 + (row + 0.5 - y0) * slope)), row, color);
+        }
+    }
+}
+
+/**
+ * @brief Sets the color of a pixel, pixels outside the image are ignored
+ * @param[in] x: column of the pixel
+ * @param[in] y: row of the pixel
+ * @param[in] color: the color
+*/
+void SoftwareRenderer::setPixel(long long x, long long y, const RenderColor& color)
+{
+    if(x < 0 || y < 0 || x >= width || y >= height)
+    {
+        return;
+    }
+
+    size_t pixel = 3 * (size_t(y) * width + size_t(x));
+    pixels[pixel] = color.red;
+    pixels[pixel + 1] = color.green;
+    pixels[pixel + 2] = color.blue;
+}
+
+double SoftwareRenderer::toPixelX(double x) const
+{
+    return (x - minX) * scaleX;
+}
+
+double SoftwareRenderer::toPixelY(double y) const
+{
+    return (maxY - y) * scaleY;
+}
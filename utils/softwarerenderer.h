@@ -0,0 +1,84 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <string>
+#include <vector>
+
+#include <cg3/geometry/2d/point2d.h>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+#include <data_structures/voronoidiagram.h>
+
+//rows of the image drawn by a thread at a time
+const unsigned int renderRowsPerBand = 16;
+
+struct RenderColor
+{
+    unsigned char red;
+    unsigned char green;
+    unsigned char blue;
+};
+
+//the colors of the canvas
+const RenderColor renderBackgroundColor = {255, 255, 255};
+const RenderColor renderTriangulationColor = {0, 255, 0};
+const RenderColor renderPointColor = {255, 0, 0};
+const RenderColor renderVoronoiEdgeColor = {0, 0, 255};
+const RenderColor renderVoronoiVertexColor = {255, 255, 0};
+
+/**
+ * @brief SoftwareRenderer: draws the triangulation, the Voronoi diagram and points in an RGB image, without OpenGL
+ *
+ * The image shows a rectangle of the plane, so it can be rendered without a display, for example by batch jobs.
+ * Lines are one pixel wide and points are squares. The image is divided in bands of renderRowsPerBand rows:
+ * the primitives are first assigned in parallel to the bands they cross, then the bands are drawn in parallel,
+ * each one by a single thread, so no pixel is written by two threads and the result doesn't depend on the number of threads.
+ */
+class SoftwareRenderer
+{
+public:
+    SoftwareRenderer(unsigned int width, unsigned int height, const cg3::Point2Dd& min, const cg3::Point2Dd& max);
+
+    void clear(const RenderColor& color);
+
+    void drawTriangulation(const Triangulation& triangulation, const DAG& dag, bool withBoundingTriangle, const RenderColor& color);
+    void drawVoronoi(const VoronoiDiagram& diagram, const RenderColor& edgeColor, const RenderColor& vertexColor, unsigned int vertexSize);
+    void drawPoints(const std::vector<cg3::Point2Dd>& points, const RenderColor& color, unsigned int size);
+
+    bool savePng(const std::string& filename) const;
+
+    unsigned int getWidth() const;
+    unsigned int getHeight() const;
+    const std::vector<unsigned char>& getPixels() const;
+
+private:
+    template<typename RowRange, typename BandDrawer>
+    void drawInBands(size_t number, const RowRange& getRows, const BandDrawer& draw);
+
+    template<typename SegmentGetter>
+    void drawSegments(size_t number, const SegmentGetter& getSegment, const RenderColor& color);
+
+    template<typename PointGetter>
+    void drawSquares(size_t number, const PointGetter& getPoint, const RenderColor& color, unsigned int size);
+
+    void drawSegment(double x0, double y0, double x1, double y1, long long firstRow, long long lastRow, const RenderColor& color);
+    void setPixel(long long x, long long y, const RenderColor& color);
+
+    double toPixelX(double x) const;
+    double toPixelY(double y) const;
+
+    unsigned int width;
+    unsigned int height;
+
+    //pixels for each unit of the plane, the y axis goes down in the image
+    double minX;
+    double maxY;
+    double scaleX;
+    double scaleY;
+
+    //red, green and blue bytes of each pixel, row by row from the top
+    std::vector<unsigned char> pixels;
+};
+
+#endif // SOFTWARERENDERER_H
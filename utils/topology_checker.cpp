@@ -0,0 +1,216 @@
+#include "topology_checker.h"
+
+#include <algorithm>
+
+namespace DelaunayTriangulation {
+
+namespace Checker {
+
+namespace {
+
+/**
+ * @brief Returns a vertex of the triangle given its position
+ * @param[in] triangle: the triangle
+ * @param[in] vertex: 0 for V1, 1 for V2 and 2 for V3
+ * @return vertex: the vertex coordinates
+*/
+cg3::Point2Dd getVertex(const Triangle& triangle, unsigned int vertex)
+{
+    return vertex == 0 ? triangle.getV1() : (vertex == 1 ? triangle.getV2() : triangle.getV3());
+}
+
+/**
+ * @brief Checks if a child of a node is valid
+ *
+ * The DAG is filled in insertion order, so each child is stored after its parent.
+ *
+ * @param[in] child: the index of the child
+ * @param[in] parent: the index of the parent
+ * @param[in] length: total nodes
+ * @return flag: the child is empty or it refers to a node added after the parent
+*/
+bool isValidChild(int child, unsigned int parent, unsigned int length)
+{
+    return child == noChild || (child > int(parent) && unsigned(child) < length);
+}
+
+}
+
+/**
+ * @brief Returns true if each invariant is satisfied
+ * @return flag: the triangulation is topologically valid
+*/
+bool TopologyReport::isValid() const
+{
+    return !sizeMismatch && asymmetricAdjacencies == 0 && deadAdjacencies == 0 && mismatchedEdges == 0 &&
+            clockwiseTriangles == 0 && invalidNodes == 0 && eulerCharacteristic;
+}
+
+/**
+ * @brief Checks the structural invariants of triangulation and DAG
+ *
+ * Triangles are checked in parallel: each live triangle (leaf in the DAG) must be in counter-clockwise order,
+ * each adjacency must be symmetric, it must refer to a live triangle and the two triangles must share the endpoints of the edge.
+ * Each node must refer to the triangle with the same index and its children must be nodes added after it.
+ * At the end, vertices are counted to check the Euler characteristic.
+ *
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @return report: the number of violations for each invariant
+*/
+TopologyReport checkTopology(const Triangulation& triangulation, const DAG& dag)
+{
+    TopologyReport report;
+
+    const std::vector<Triangle>& triangles = triangulation.getTriangles();
+    const std::vector<Node>& nodes = dag.getNodeList();
+
+    unsigned int length = unsigned(triangles.size());
+
+    //the dag, the triangles and the adjacencies are parallel, if they are not there is nothing else to check
+    if(nodes.size() != triangles.size() || triangulation.getAdjacencies().size() != triangles.size())
+    {
+        report.sizeMismatch = true;
+        return report;
+    }
+
+    unsigned int liveTriangles = 0;
+    unsigned int boundaryEdges = 0;
+    unsigned int asymmetricAdjacencies = 0;
+    unsigned int deadAdjacencies = 0;
+    unsigned int mismatchedEdges = 0;
+    unsigned int clockwiseTriangles = 0;
+    unsigned int invalidNodes = 0;
+
+    #pragma omp parallel for reduction(+:liveTriangles, boundaryEdges, asymmetricAdjacencies, deadAdjacencies, mismatchedEdges, clockwiseTriangles, invalidNodes)
+    for(unsigned int i = 0; i < length; i++)
+    {
+        const Node& node = nodes[i];
+
+        if(node.getData() != i ||
+                !isValidChild(node.getC1(), i, length) ||
+                !isValidChild(node.getC2(), i, length) ||
+                !isValidChild(node.getC3(), i, length))
+        {
+            invalidNodes++;
+        }
+
+        //ignore deleted triangles
+        if(!node.isLeaf())
+        {
+            continue;
+        }
+
+        liveTriangles++;
+
+        const Triangle& triangle = triangles[i];
+
+        //counter-clockwise order means positive signed area
+        const cg3::Point2Dd v1v2 = triangle.getV2() - triangle.getV1();
+        const cg3::Point2Dd v1v3 = triangle.getV3() - triangle.getV1();
+        if(v1v2.perpendicularDot(v1v3) <= 0)
+        {
+            clockwiseTriangles++;
+        }
+
+        const std::array<int, maxAdjacentTriangles>& adjacencies = triangulation.getAdjacenciesFromTriangle(i);
+
+        for(unsigned int edge = 0; edge < maxAdjacentTriangles; edge++)
+        {
+            int adjacent = adjacencies[edge];
+
+            if(adjacent == noAdjacentTriangle)
+            {
+                boundaryEdges++;
+            }
+            else if(adjacent < 0 || unsigned(adjacent) >= length || !nodes[unsigned(adjacent)].isLeaf())
+            {
+                deadAdjacencies++;
+            }
+            else
+            {
+                const std::array<int, maxAdjacentTriangles>& adjacentAdjacencies =
+                        triangulation.getAdjacenciesFromTriangle(unsigned(adjacent));
+
+                const std::array<int, maxAdjacentTriangles>::const_iterator backIterator =
+                        std::find(adjacentAdjacencies.begin(), adjacentAdjacencies.end(), int(i));
+
+                if(backIterator == adjacentAdjacencies.end())
+                {
+                    asymmetricAdjacencies++;
+                }
+                else
+                {
+                    //the shared edge is traversed in opposite directions by the two triangles
+                    unsigned int backEdge = unsigned(backIterator - adjacentAdjacencies.begin());
+                    const Triangle& adjacentTriangle = triangles[unsigned(adjacent)];
+
+                    if(getVertex(triangle, edge) != getVertex(adjacentTriangle, (backEdge + 1) % maxAdjacentTriangles) ||
+                            getVertex(triangle, (edge + 1) % maxAdjacentTriangles) != getVertex(adjacentTriangle, backEdge))
+                    {
+                        mismatchedEdges++;
+                    }
+                }
+            }
+        }
+    }
+
+    report.liveTriangles = liveTriangles;
+    report.boundaryEdges = boundaryEdges;
+    report.asymmetricAdjacencies = asymmetricAdjacencies;
+    report.deadAdjacencies = deadAdjacencies;
+    report.mismatchedEdges = mismatchedEdges;
+    report.clockwiseTriangles = clockwiseTriangles;
+    report.invalidNodes = invalidNodes;
+
+    //each internal edge is shared by two triangles, boundary edges belong to one triangle
+    report.edges = (3 * liveTriangles + boundaryEdges) / 2;
+
+    //count distinct vertices of live triangles
+    std::vector<cg3::Point2Dd> vertices;
+    vertices.reserve(3 * liveTriangles);
+
+    for(unsigned int i = 0; i < length; i++)
+    {
+        if(nodes[i].isLeaf())
+        {
+            vertices.push_back(triangles[i].getV1());
+            vertices.push_back(triangles[i].getV2());
+            vertices.push_back(triangles[i].getV3());
+        }
+    }
+
+    std::sort(vertices.begin(), vertices.end());
+    report.vertices = unsigned(std::unique(vertices.begin(), vertices.end()) - vertices.begin());
+
+    report.eulerCharacteristic = (3 * liveTriangles + boundaryEdges) % 2 == 0 &&
+            long(report.vertices) - long(report.edges) + long(report.liveTriangles) == 1;
+
+    return report;
+}
+
+/**
+ * @brief Prints the report
+ * @param[in] stream: output stream
+ * @param[in] report: the report to print
+ * @return stream: the output stream
+*/
+std::ostream& operator<<(std::ostream& stream, const TopologyReport& report)
+{
+    if(report.sizeMismatch)
+    {
+        return stream << "triangulation and DAG sizes mismatch";
+    }
+
+    return stream << "V " << report.vertices << ", E " << report.edges << ", F " << report.liveTriangles
+                  << " (boundary edges " << report.boundaryEdges << ", Euler " << (report.eulerCharacteristic ? "ok" : "failed") << "); "
+                  << "asymmetric adjacencies " << report.asymmetricAdjacencies
+                  << ", dead adjacencies " << report.deadAdjacencies
+                  << ", mismatched edges " << report.mismatchedEdges
+                  << ", clockwise triangles " << report.clockwiseTriangles
+                  << ", invalid nodes " << report.invalidNodes;
+}
+
+}
+
+}
@@ -0,0 +1,57 @@
+#ifndef TOPOLOGY_CHECKER_H
+#define TOPOLOGY_CHECKER_H
+
+#include <ostream>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+
+namespace DelaunayTriangulation {
+
+namespace Checker {
+
+//number of insertions between two topology checks in debug builds
+const unsigned int topologyCheckInterval = 1000;
+
+/**
+ * @brief TopologyReport: result of the structural check of triangulation and DAG
+ *
+ * Each counter stores how many times an invariant is violated, so a valid triangulation has every counter equal to 0.
+ * Vertices, edges and live triangles are used for the Euler characteristic: the live triangles cover the bounding triangle,
+ * that is a disk, so V - E + F must be equal to 1.
+ */
+struct TopologyReport
+{
+    //triangles, adjacencies and nodes have different sizes
+    bool sizeMismatch = false;
+
+    unsigned int liveTriangles = 0;
+    unsigned int vertices = 0;
+    unsigned int edges = 0;
+    unsigned int boundaryEdges = 0;
+
+    //live triangle adjacent to a triangle that doesn't know it
+    unsigned int asymmetricAdjacencies = 0;
+    //live triangle adjacent to a deleted triangle or to an index out of range
+    unsigned int deadAdjacencies = 0;
+    //adjacent triangles that don't share the endpoints of the edge
+    unsigned int mismatchedEdges = 0;
+    //triangles whose vertices are not in counter-clockwise order
+    unsigned int clockwiseTriangles = 0;
+    //nodes that don't refer to their triangle or with children out of range
+    unsigned int invalidNodes = 0;
+
+    bool eulerCharacteristic = false;
+
+    bool isValid() const;
+};
+
+TopologyReport checkTopology(const Triangulation& triangulation, const DAG& dag);
+
+std::ostream& operator<<(std::ostream& stream, const TopologyReport& report);
+
+}
+
+}
+
+#endif // TOPOLOGY_CHECKER_H
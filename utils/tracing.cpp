@@ -0,0 +1,456 @@
+#include "tracing.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace Tracing {
+
+namespace {
+
+const unsigned int noPhase = std::numeric_limits<unsigned int>::max();
+
+//events are reserved from maxTraceEvents in blocks, so the threads rarely touch the shared counter
+const size_t traceEventBlock = 4096;
+
+/**
+ * @brief PhaseNode: a phase of the tree of a thread, the root is the thread itself
+ *
+ * The children of a phase are the phases opened inside it, linked as a list of siblings.
+ * Times are in nanoseconds.
+ */
+struct PhaseNode
+{
+    const char* name;
+    unsigned int parent;
+    unsigned int firstChild;
+    unsigned int nextSibling;
+
+    unsigned long long calls;
+    int64_t totalTime;
+    int64_t minTime;
+    int64_t maxTime;
+};
+
+struct TraceEvent
+{
+    const char* name;
+    //nanoseconds since the origin of the trace
+    int64_t begin;
+    int64_t duration;
+};
+
+struct ThreadTrace
+{
+    unsigned int id;
+    std::string name;
+
+    std::vector<PhaseNode> phases;
+    unsigned int currentPhase;
+
+    std::vector<std::vector<TraceEvent>> eventBlocks;
+    bool eventsExhausted;
+    unsigned long long droppedEvents;
+};
+
+//the traces are kept after their threads end, until the program ends
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadTrace>> registry;
+
+//disabled by default, it is enabled from the manager when a trace is needed
+std::atomic<bool> tracingEnabled(false);
+std::atomic<size_t> reservedEvents(0);
+std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+thread_local ThreadTrace* threadTrace = nullptr;
+
+PhaseNode makePhase(const char* name, unsigned int parent)
+{
+    PhaseNode phase;
+    phase.name = name;
+    phase.parent = parent;
+    phase.firstChild = noPhase;
+    phase.nextSibling = noPhase;
+    phase.calls = 0;
+    phase.totalTime = 0;
+    phase.minTime = std::numeric_limits<int64_t>::max();
+    phase.maxTime = 0;
+    return phase;
+}
+
+/**
+ * @brief Returns the trace of the calling thread, it is registered the first time
+ * @return trace: the trace of the thread
+*/
+ThreadTrace& getThreadTrace()
+{
+    if(threadTrace == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+
+        std::unique_ptr<ThreadTrace> trace(new ThreadTrace());
+        trace->id = unsigned(registry.size());
+        trace->name = "thread " + std::to_string(trace->id);
+        trace->phases.push_back(makePhase("", noPhase));
+        trace->currentPhase = 0;
+        trace->eventsExhausted = false;
+        trace->droppedEvents = 0;
+
+        threadTrace = trace.get();
+        registry.push_back(std::move(trace));
+    }
+
+    return *threadTrace;
+}
+
+/**
+ * @brief Returns the child of the current phase with the given name, it is added if it was never opened
+ * @param[in] trace: the trace of the thread
+ * @param[in] name: the name of the phase
+ * @return index: the index of the child in the phases of the thread
+*/
+unsigned int findChildPhase(ThreadTrace& trace, const char* name)
+{
+    unsigned int parent = trace.currentPhase;
+
+    unsigned int child = trace.phases[parent].firstChild;
+    while(child != noPhase)
+    {
+        const char* childName = trace.phases[child].name;
+        if(childName == name || std::strcmp(childName, name) == 0)
+        {
+            return child;
+        }
+        child = trace.phases[child].nextSibling;
+    }
+
+    child = unsigned(trace.phases.size());
+    trace.phases.push_back(makePhase(name, parent));
+    trace.phases[child].nextSibling = trace.phases[parent].firstChild;
+    trace.phases[parent].firstChild = child;
+    return child;
+}
+
+void recordEvent(ThreadTrace& trace, const TraceEvent& event)
+{
+    if(trace.eventBlocks.empty() || trace.eventBlocks.back().size() == traceEventBlock)
+    {
+        if(trace.eventsExhausted || reservedEvents.fetch_add(traceEventBlock, std::memory_order_relaxed) + traceEventBlock > maxTraceEvents)
+        {
+            trace.eventsExhausted = true;
+            trace.droppedEvents++;
+            return;
+        }
+
+        trace.eventBlocks.emplace_back();
+        trace.eventBlocks.back().reserve(traceEventBlock);
+    }
+
+    trace.eventBlocks.back().push_back(event);
+}
+
+/**
+ * @brief Writes a string as a JSON string, with quotes
+ * @param[in] stream: the output stream
+ * @param[in] string: the string to write
+*/
+void writeJsonString(std::ostream& stream, const std::string& string)
+{
+    stream << '"';
+    for(char c : string)
+    {
+        if(c == '"' || c == '\\')
+        {
+            stream << '\\' << c;
+        }
+        else if(static_cast<unsigned char>(c) < 0x20)
+        {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            stream << escaped;
+        }
+        else
+        {
+            stream << c;
+        }
+    }
+    stream << '"';
+}
+
+}
+
+/**
+ * @brief Opens a phase in the current phase of the calling thread
+ * @param[in] name: the name of the phase, a string literal
+ * @param[in] record: AGGREGATE_ONLY to add the scope only to the aggregated times, without its event
+*/
+Scope::Scope(const char* name, ScopeRecord record) :
+    active(tracingEnabled.load(std::memory_order_relaxed)),
+    keepEvent(record == KEEP_EVENT)
+{
+    if(active)
+    {
+        ThreadTrace& trace = getThreadTrace();
+        trace.currentPhase = findChildPhase(trace, name);
+
+        //the bookkeeping is not part of the phase
+        begin = std::chrono::steady_clock::now();
+    }
+}
+
+/**
+ * @brief Closes the phase, adds its time to the aggregated times and records its event, if it is kept
+*/
+Scope::~Scope()
+{
+    if(active)
+    {
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        int64_t duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+        ThreadTrace& trace = *threadTrace;
+        PhaseNode& phase = trace.phases[trace.currentPhase];
+
+        phase.calls++;
+        phase.totalTime += duration;
+        phase.minTime = std::min(phase.minTime, duration);
+        phase.maxTime = std::max(phase.maxTime, duration);
+
+        if(keepEvent)
+        {
+            TraceEvent event;
+            event.name = phase.name;
+            event.begin = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - origin).count();
+            event.duration = duration;
+            recordEvent(trace, event);
+        }
+
+        trace.currentPhase = phase.parent;
+    }
+}
+
+/**
+ * @brief Turns the tracing on or off, the scopes opened while it is off are not recorded
+ * @param[in] enabled: true to record the scopes
+*/
+void setEnabled(bool enabled)
+{
+    tracingEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool isEnabled()
+{
+    return tracingEnabled.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Names the calling thread in the aggregated phases and in the Chrome trace
+ * @param[in] name: the name of the thread, threads with the same name are aggregated together
+*/
+void setThreadName(const std::string& name)
+{
+    ThreadTrace& trace = getThreadTrace();
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+    trace.name = name;
+}
+
+/**
+ * @brief Returns the aggregated times of the phases recorded by all the threads
+ * @return phases: the phases in depth-first order for each thread name, only the phases closed at least once
+*/
+std::vector<PhaseStatistics> getPhaseStatistics()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    std::vector<PhaseStatistics> phases;
+    std::map<std::pair<std::string, std::string>, size_t> phaseIndices;
+
+    for(const std::unique_ptr<ThreadTrace>& trace : registry)
+    {
+        //depth-first visit of the tree, the children are visited in the order they were opened the first time
+        std::vector<std::pair<unsigned int, std::string>> stack;
+        std::vector<unsigned int> children;
+
+        for(unsigned int child = trace->phases[0].firstChild; child != noPhase; child = trace->phases[child].nextSibling)
+        {
+            children.push_back(child);
+        }
+        for(auto it = children.rbegin(); it != children.rend(); ++it)
+        {
+            stack.push_back(std::make_pair(*it, std::string(trace->phases[*it].name)));
+        }
+
+        while(!stack.empty())
+        {
+            unsigned int index = stack.back().first;
+            std::string path = stack.back().second;
+            stack.pop_back();
+
+            const PhaseNode& phase = trace->phases[index];
+
+            unsigned int depth = 0;
+            for(unsigned int parent = phase.parent; parent != 0; parent = trace->phases[parent].parent)
+            {
+                depth++;
+            }
+
+            if(phase.calls > 0)
+            {
+                std::pair<std::string, std::string> key(trace->name, path);
+                std::map<std::pair<std::string, std::string>, size_t>::iterator it = phaseIndices.find(key);
+                if(it == phaseIndices.end())
+                {
+                    PhaseStatistics statistics;
+                    statistics.thread = trace->name;
+                    statistics.path = path;
+                    statistics.depth = depth;
+                    statistics.calls = 0;
+                    statistics.totalTime = 0;
+                    statistics.minTime = std::numeric_limits<double>::max();
+                    statistics.maxTime = 0;
+
+                    it = phaseIndices.insert(std::make_pair(key, phases.size())).first;
+                    phases.push_back(statistics);
+                }
+
+                PhaseStatistics& statistics = phases[it->second];
+                statistics.calls += phase.calls;
+                statistics.totalTime += phase.totalTime * 1e-9;
+                statistics.minTime = std::min(statistics.minTime, phase.minTime * 1e-9);
+                statistics.maxTime = std::max(statistics.maxTime, phase.maxTime * 1e-9);
+            }
+
+            children.clear();
+            for(unsigned int child = phase.firstChild; child != noPhase; child = trace->phases[child].nextSibling)
+            {
+                children.push_back(child);
+            }
+            for(auto it = children.rbegin(); it != children.rend(); ++it)
+            {
+                stack.push_back(std::make_pair(*it, path + "/" + trace->phases[*it].name));
+            }
+        }
+    }
+
+    return phases;
+}
+
+/**
+ * @brief Prints the aggregated times of the phases, one for each line, like cg3::Timer
+ * @param[in] stream: the output stream
+*/
+void printPhaseStatistics(std::ostream& stream)
+{
+    for(const PhaseStatistics& phase : getPhaseStatistics())
+    {
+        stream << "[" << phase.totalTime << " secs]\t" << std::string(2 * phase.depth, ' ') << phase.thread << ": " << phase.path
+               << ", " << phase.calls << " calls (mean " << phase.totalTime / double(phase.calls)
+               << ", min " << phase.minTime << ", max " << phase.maxTime << ")" << std::endl;
+    }
+
+    unsigned long long droppedEvents = 0;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for(const std::unique_ptr<ThreadTrace>& trace : registry)
+        {
+            droppedEvents += trace->droppedEvents;
+        }
+    }
+
+    if(droppedEvents > 0)
+    {
+        stream << droppedEvents << " scopes aggregated but not kept in the trace" << std::endl;
+    }
+}
+
+/**
+ * @brief Writes the recorded scopes in the Chrome trace event format
+ *
+ * Each scope is a complete event ("X") of its thread, with times in microseconds from the origin of the trace;
+ * the file can be opened in chrome://tracing or in Perfetto.
+ * @param[in] filename: the path of the JSON file
+ * @return flag: true if the file was written
+*/
+bool exportChromeTrace(const std::string& filename)
+{
+    std::ofstream file(filename, std::ios::binary);
+    if(!file)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    char number[64];
+
+    for(const std::unique_ptr<ThreadTrace>& trace : registry)
+    {
+        file << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << trace->id << ",\"args\":{\"name\":";
+        writeJsonString(file, trace->name);
+        file << "}}";
+        first = false;
+
+        for(const std::vector<TraceEvent>& block : trace->eventBlocks)
+        {
+            for(const TraceEvent& event : block)
+            {
+                //scopes opened before the last clear
+                if(event.begin < 0)
+                {
+                    continue;
+                }
+
+                file << ",\n{\"name\":";
+                writeJsonString(file, event.name);
+                std::snprintf(number, sizeof(number), ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                              trace->id, double(event.begin) * 1e-3, double(event.duration) * 1e-3);
+                file << number;
+            }
+        }
+    }
+
+    file << "\n]}\n";
+
+    return bool(file);
+}
+
+/**
+ * @brief Removes the recorded times and events and restarts the trace from now
+ *
+ * The phases opened by the threads are kept, so a scope can be open while the trace is cleared.
+*/
+void clear()
+{
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    for(const std::unique_ptr<ThreadTrace>& trace : registry)
+    {
+        for(PhaseNode& phase : trace->phases)
+        {
+            phase.calls = 0;
+            phase.totalTime = 0;
+            phase.minTime = std::numeric_limits<int64_t>::max();
+            phase.maxTime = 0;
+        }
+
+        trace->eventBlocks.clear();
+        trace->eventsExhausted = false;
+        trace->droppedEvents = 0;
+    }
+
+    reservedEvents = 0;
+    origin = std::chrono::steady_clock::now();
+}
+
+}
@@ -0,0 +1,77 @@
+#ifndef TRACING_H
+#define TRACING_H
+
+#include <chrono>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * Tracing: nested timers of the phases of a run, recorded by each thread
+ *
+ * A Scope measures a phase from its construction to its destruction, the scopes opened inside it are its children.
+ * Each thread records its own scopes without locks: the calls and the total, minimum and maximum time of each phase
+ * are aggregated in the tree of phases of the thread, and each scope is also kept as an event for the Chrome trace
+ * until maxTraceEvents events are recorded by all the threads. The scopes opened for each inserted point are
+ * AGGREGATE_ONLY, their events would use the whole budget in a single run.
+ * Phase names must be string literals, since the events only keep their address.
+ * The recorded phases must be read when the traced threads are idle, for example after joining them.
+ */
+namespace Tracing {
+
+//events kept for the Chrome trace, about 24 bytes each, the later scopes are only aggregated
+const size_t maxTraceEvents = size_t(1) << 21;
+
+/**
+ * @brief PhaseStatistics: aggregated times of a phase
+ *
+ * The phases of threads with the same name are aggregated together, so the runs of the algorithm
+ * on different threads are summed.
+ */
+struct PhaseStatistics
+{
+    std::string thread;
+    //names of the phase and of its ancestors, separated by '/'
+    std::string path;
+    unsigned int depth;
+
+    unsigned long long calls;
+    double totalTime;
+    double minTime;
+    double maxTime;
+};
+
+//kind of record of a scope
+enum ScopeRecord { KEEP_EVENT, AGGREGATE_ONLY };
+
+class Scope
+{
+public:
+    explicit Scope(const char* name, ScopeRecord record = KEEP_EVENT);
+    ~Scope();
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+private:
+    bool active;
+    bool keepEvent;
+    std::chrono::steady_clock::time_point begin;
+};
+
+void setEnabled(bool enabled);
+bool isEnabled();
+
+void setThreadName(const std::string& name);
+
+std::vector<PhaseStatistics> getPhaseStatistics();
+void printPhaseStatistics(std::ostream& stream);
+
+bool exportChromeTrace(const std::string& filename);
+
+void clear();
+
+}
+
+#endif // TRACING_H
@@ -0,0 +1,530 @@
+#include "triangulationsnapshot.h"
+
+#include "algorithms/indexedmesh.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+#include <cg3lib/cg3/core/cg3/geometry/2d/utils2d.h>
+
+namespace {
+
+//the first 8 bytes of each snapshot
+const char snapshotMagic[8] = {'G', 'A', 'S', 'S', 'N', 'A', 'P', '\0'};
+
+//sections start at multiples of 8 bytes, so the mapped arrays are aligned
+const uint64_t sectionAlignment = 8;
+
+uint64_t alignSection(uint64_t offset)
+{
+    return (offset + sectionAlignment - 1) / sectionAlignment * sectionAlignment;
+}
+
+/**
+ * @brief Writes a section with a single call to the stream, followed by the padding up to the next section
+ * @param[in] file: the output stream
+ * @param[in] section: the elements of the section
+*/
+template<typename T>
+bool writeSection(std::ofstream& file, const std::vector<T>& section)
+{
+    const char padding[sectionAlignment] = {};
+
+    uint64_t size = section.size() * sizeof(T);
+
+    return file.write(reinterpret_cast<const char*>(section.data()), std::streamsize(size)) &&
+            file.write(padding, std::streamsize(alignSection(size) - size));
+}
+
+}
+
+/**
+ * @brief Creates an empty view
+*/
+TriangulationSnapshot::TriangulationSnapshot()
+    : header(nullptr), vertices(nullptr), triangles(nullptr), adjacencies(nullptr), nodes(nullptr) {}
+
+/**
+ * @brief Maps the snapshot and validates its header and its indices
+ * @param[in] filename: the path of the file
+ * @return flag: false if the file can't be opened, if it is not a snapshot, if it was written with different endianness
+ * or if it is corrupted
+*/
+bool TriangulationSnapshot::open(const std::string& filename)
+{
+    close();
+
+    if(!file.open(filename) || file.size() < sizeof(TriangulationSnapshotHeader))
+    {
+        close();
+        return false;
+    }
+
+    const TriangulationSnapshotHeader* fileHeader = reinterpret_cast<const TriangulationSnapshotHeader*>(file.data());
+
+    bool valid = std::memcmp(fileHeader->magic, snapshotMagic, sizeof(snapshotMagic)) == 0 &&
+            fileHeader->version == triangulationSnapshotVersion &&
+            fileHeader->endianness == FileUtils::endiannessMarker;
+
+    //each section must be aligned and contained in the file
+    if(valid)
+    {
+        uint64_t size = file.size();
+        uint64_t triangleNumber = fileHeader->triangleNumber;
+        bool withDag = (fileHeader->flags & snapshotWithDag) != 0;
+
+        const uint64_t offsets[] = {fileHeader->verticesOffset, fileHeader->trianglesOffset,
+                                    fileHeader->adjacenciesOffset, fileHeader->nodesOffset};
+        const uint64_t sizes[] = {fileHeader->vertexNumber * 2 * sizeof(double), triangleNumber * 3 * sizeof(uint32_t),
+                                  triangleNumber * 3 * sizeof(int32_t), withDag ? triangleNumber * 3 * sizeof(int32_t) : 0};
+
+        //adjacencies and children are 32 bit signed integers
+        valid = fileHeader->vertexNumber <= size / (2 * sizeof(double)) && triangleNumber <= size / (3 * sizeof(uint32_t)) &&
+                triangleNumber <= uint64_t(std::numeric_limits<int32_t>::max());
+
+        for(unsigned int i = 0; i < 4 && valid; i++)
+        {
+            valid = offsets[i] % sectionAlignment == 0 && offsets[i] <= size && sizes[i] <= size - offsets[i];
+        }
+    }
+
+    if(!valid)
+    {
+        close();
+        return false;
+    }
+
+    header = fileHeader;
+    vertices = reinterpret_cast<const double*>(file.data() + header->verticesOffset);
+    triangles = reinterpret_cast<const uint32_t*>(file.data() + header->trianglesOffset);
+    adjacencies = reinterpret_cast<const int32_t*>(file.data() + header->adjacenciesOffset);
+    nodes = hasDag() ? reinterpret_cast<const int32_t*>(file.data() + header->nodesOffset) : nullptr;
+
+    if(!hasValidIndices())
+    {
+        close();
+        return false;
+    }
+
+    //after the validation the file is read by the queries
+    file.setAccessPattern(cg3::MemoryMappedFile::RANDOM_ACCESS);
+
+    return true;
+}
+
+/**
+ * @brief Releases the view
+*/
+void TriangulationSnapshot::close()
+{
+    file.close();
+    header = nullptr;
+    vertices = nullptr;
+    triangles = nullptr;
+    adjacencies = nullptr;
+    nodes = nullptr;
+}
+
+/**
+ * @brief Returns true if the snapshot contains the DAG and all the triangles seen in the execution
+ * @return flag: true if the DAG is stored
+*/
+bool TriangulationSnapshot::hasDag() const
+{
+    return header != nullptr && (header->flags & snapshotWithDag) != 0;
+}
+
+/**
+ * @brief Returns the number of distinct vertices
+ * @return vertexNumber: number of vertices, the vertices of the bounding triangle included
+*/
+uint64_t TriangulationSnapshot::getVertexNumber() const
+{
+    return header == nullptr ? 0 : header->vertexNumber;
+}
+
+/**
+ * @brief Returns the number of triangles
+ * @return triangleNumber: number of triangles, only live triangles if the DAG is not stored
+*/
+uint64_t TriangulationSnapshot::getTriangleNumber() const
+{
+    return header == nullptr ? 0 : header->triangleNumber;
+}
+
+/**
+ * @brief Returns a vertex
+ * @param[in] vertex: index of the vertex
+ * @return point: the vertex
+*/
+cg3::Point2Dd TriangulationSnapshot::getVertex(uint64_t vertex) const
+{
+    return cg3::Point2Dd(vertices[2 * vertex], vertices[2 * vertex + 1]);
+}
+
+/**
+ * @brief Returns the index of a vertex of a triangle
+ * @param[in] triangle: index of the triangle
+ * @param[in] vertex: 0, 1 or 2 for V1, V2 and V3
+ * @return vertex: index of the vertex
+*/
+uint32_t TriangulationSnapshot::getTriangleVertex(uint64_t triangle, unsigned int vertex) const
+{
+    return triangles[3 * triangle + vertex];
+}
+
+/**
+ * @brief Returns the triangle adjacent to an edge of a triangle
+ * @param[in] triangle: index of the triangle
+ * @param[in] edge: v1v2Edge, v2v3Edge or v3v1Edge
+ * @return adjacent: index of the adjacent triangle, noAdjacentTriangle if the edge is on the boundary
+*/
+int32_t TriangulationSnapshot::getAdjacency(uint64_t triangle, unsigned int edge) const
+{
+    return adjacencies[3 * triangle + edge];
+}
+
+/**
+ * @brief Returns true if the triangle belongs to the current triangulation
+ * @param[in] triangle: index of the triangle
+ * @return flag: true if the node of the triangle is a leaf, always true without the DAG
+*/
+bool TriangulationSnapshot::isLive(uint64_t triangle) const
+{
+    if(nodes == nullptr)
+    {
+        return true;
+    }
+
+    return nodes[3 * triangle] == noChild && nodes[3 * triangle + 1] == noChild && nodes[3 * triangle + 2] == noChild;
+}
+
+/**
+ * @brief Searches the live triangle containing the point
+ * @param[in] point: the query point
+ * @return triangle: index of the triangle, -1 if the point is outside the triangulation
+*/
+int64_t TriangulationSnapshot::locate(const cg3::Point2Dd& point) const
+{
+    if(getTriangleNumber() == 0)
+    {
+        return -1;
+    }
+
+    return hasDag() ? locateWithDag(point) : locateWithWalk(point);
+}
+
+/**
+ * @brief Copies the snapshot in the data structures, so the insertion can continue
+ * @param[out] triangulation: the triangulation data structure
+ * @param[out] dag: the search data structure
+ * @return flag: false if the snapshot doesn't contain the DAG
+*/
+bool TriangulationSnapshot::restore(Triangulation& triangulation, DAG& dag) const
+{
+    if(!hasDag())
+    {
+        return false;
+    }
+
+    long long triangleNumber = (long long)(getTriangleNumber());
+    size_t length = size_t(triangleNumber);
+
+    std::vector<Triangle> restoredTriangles(length, Triangle(cg3::Point2Dd(), cg3::Point2Dd(), cg3::Point2Dd()));
+    std::vector<std::array<int, maxAdjacentTriangles>> restoredAdjacencies(length);
+    std::vector<Node> nodeList(length, Node(0));
+
+    #pragma omp parallel for
+    for(long long i = 0; i < triangleNumber; i++)
+    {
+        uint64_t triangle = uint64_t(i);
+
+        restoredTriangles[size_t(i)] = Triangle(getVertex(getTriangleVertex(triangle, 0)),
+                                                getVertex(getTriangleVertex(triangle, 1)),
+                                                getVertex(getTriangleVertex(triangle, 2)));
+
+        restoredAdjacencies[size_t(i)] = {{getAdjacency(triangle, v1v2Edge), getAdjacency(triangle, v2v3Edge),
+                                           getAdjacency(triangle, v3v1Edge)}};
+
+        //node i contains triangle i
+        Node& node = nodeList[size_t(i)];
+        node = Node(unsigned(i));
+        node.setC1(nodes[3 * triangle]);
+        node.setC2(nodes[3 * triangle + 1]);
+        node.setC3(nodes[3 * triangle + 2]);
+    }
+
+    triangulation = Triangulation(restoredTriangles, restoredAdjacencies);
+    dag.getNodeList().swap(nodeList);
+
+    return true;
+}
+
+/**
+ * @brief Checks every index stored in the sections
+ *
+ * Each vertex must be in the vertex section and each adjacency must be a triangle of the snapshot or noAdjacentTriangle.
+ * Each child must be noChild or a node stored after its parent, as in the DAG built by the algorithm:
+ * this also excludes the cycles, so the DAG search always ends.
+ *
+ * @return flag: true if all the indices are valid
+*/
+bool TriangulationSnapshot::hasValidIndices() const
+{
+    long long triangleNumber = (long long)(getTriangleNumber());
+    uint64_t vertexNumber = getVertexNumber();
+
+    long long invalidIndices = 0;
+
+    #pragma omp parallel for reduction(+:invalidIndices)
+    for(long long i = 0; i < triangleNumber; i++)
+    {
+        for(unsigned int k = 0; k < maxAdjacentTriangles; k++)
+        {
+            size_t position = size_t(3 * i + k);
+
+            if(triangles[position] >= vertexNumber)
+            {
+                invalidIndices++;
+            }
+
+            int32_t adjacent = adjacencies[position];
+            if(adjacent != noAdjacentTriangle && (adjacent < 0 || adjacent >= triangleNumber))
+            {
+                invalidIndices++;
+            }
+
+            if(nodes != nullptr)
+            {
+                int32_t child = nodes[position];
+                if(child != noChild && (child <= i || child >= triangleNumber))
+                {
+                    invalidIndices++;
+                }
+            }
+        }
+    }
+
+    return invalidIndices == 0;
+}
+
+/**
+ * @brief Checks if the point is inside the triangle or on its boundary
+ * @param[in] triangle: index of the triangle
+ * @param[in] point: the query point
+ * @return flag: true if the triangle contains the point
+*/
+bool TriangulationSnapshot::contains(uint64_t triangle, const cg3::Point2Dd& point) const
+{
+    return cg3::isPointLyingInTriangle(getVertex(getTriangleVertex(triangle, 0)),
+                                       getVertex(getTriangleVertex(triangle, 1)),
+                                       getVertex(getTriangleVertex(triangle, 2)), point, true);
+}
+
+/**
+ * @brief Searches the point in the mapped DAG, visiting the children in the same order of DAG::searchInNodes
+ * @param[in] point: the query point
+ * @return triangle: index of the live triangle, -1 if the point is outside the bounding triangle
+*/
+int64_t TriangulationSnapshot::locateWithDag(const cg3::Point2Dd& point) const
+{
+    std::vector<int32_t> stack(1, 0);
+
+    while(!stack.empty())
+    {
+        uint64_t node = uint64_t(stack.back());
+        stack.pop_back();
+
+        if(!contains(node, point))
+        {
+            continue;
+        }
+
+        if(isLive(node))
+        {
+            return int64_t(node);
+        }
+
+        //the first child is visited first
+        for(int child = 2; child >= 0; child--)
+        {
+            if(nodes[3 * node + unsigned(child)] != noChild)
+            {
+                stack.push_back(nodes[3 * node + unsigned(child)]);
+            }
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Searches the point walking from triangle to triangle through the edges that separate them from the point
+ * @param[in] point: the query point
+ * @return triangle: index of the triangle, -1 if the point is outside the triangulation
+*/
+int64_t TriangulationSnapshot::locateWithWalk(const cg3::Point2Dd& point) const
+{
+    uint64_t triangle = 0;
+
+    //the walk in a Delaunay triangulation doesn't visit a triangle twice, the bound stops the walk if the adjacencies
+    //of a corrupted file form a cycle (their indices are checked by open, so each step stays in the file)
+    for(uint64_t step = 0; step < getTriangleNumber(); step++)
+    {
+        bool inside = true;
+
+        for(unsigned int edge = 0; edge < maxAdjacentTriangles && inside; edge++)
+        {
+            const cg3::Point2Dd a = getVertex(getTriangleVertex(triangle, edge));
+            const cg3::Point2Dd b = getVertex(getTriangleVertex(triangle, (edge + 1) % maxAdjacentTriangles));
+
+            //the point is on the right of the counter-clockwise edge
+            double orientation = (b.x() - a.x()) * (point.y() - a.y()) - (b.y() - a.y()) * (point.x() - a.x());
+            if(orientation < 0)
+            {
+                int32_t adjacent = getAdjacency(triangle, edge);
+                if(adjacent == noAdjacentTriangle)
+                {
+                    return -1;
+                }
+
+                triangle = uint64_t(adjacent);
+                inside = false;
+            }
+        }
+
+        if(inside)
+        {
+            return int64_t(triangle);
+        }
+    }
+
+    return -1;
+}
+
+namespace FileUtils {
+
+/**
+ * @brief Saves the triangulation in a snapshot that can be mapped by TriangulationSnapshot
+ *
+ * The file is written with a temporary name and then renamed, so an interrupted save doesn't replace the previous snapshot.
+ *
+ * @param[in] filename: the path of the file
+ * @param[in] triangulation: the triangulation data structure
+ * @param[in] dag: the search data structure
+ * @param[in] withDag: true to save the DAG and all the triangles, false to save only live triangles
+ * @return flag: true if the file was written
+*/
+bool saveTriangulationSnapshot(const std::string& filename, const Triangulation& triangulation, const DAG& dag, bool withDag)
+{
+    std::vector<cg3::Point2Dd> indexedVertices;
+    std::vector<uint32_t> triangleVertices;
+    std::vector<unsigned int> triangleIndices;
+
+    static_assert(sizeof(unsigned int) == sizeof(uint32_t), "vertex indices are written as 32 bit integers");
+
+    DelaunayTriangulation::indexTriangulationVertices(
+                triangulation, dag, !withDag, indexedVertices, triangleVertices, triangleIndices);
+
+    long long triangleNumber = (long long)(triangleIndices.size());
+    long long vertexNumber = (long long)(indexedVertices.size());
+
+    //without the DAG the adjacencies refer to the position of the triangles in the snapshot
+    std::vector<int32_t> snapshotIndex;
+    if(!withDag)
+    {
+        snapshotIndex.assign(triangulation.getTriangles().size(), noAdjacentTriangle);
+        for(long long i = 0; i < triangleNumber; i++)
+        {
+            snapshotIndex[triangleIndices[size_t(i)]] = int32_t(i);
+        }
+    }
+
+    std::vector<double> coordinates(size_t(2 * vertexNumber));
+    std::vector<int32_t> snapshotAdjacencies(size_t(3 * triangleNumber));
+    std::vector<int32_t> children(withDag ? size_t(3 * triangleNumber) : 0);
+
+    const std::vector<Node>& nodeList = dag.getNodeList();
+
+    #pragma omp parallel
+    {
+        #pragma omp for nowait
+        for(long long i = 0; i < vertexNumber; i++)
+        {
+            coordinates[size_t(2 * i)] = indexedVertices[size_t(i)].x();
+            coordinates[size_t(2 * i + 1)] = indexedVertices[size_t(i)].y();
+        }
+
+        #pragma omp for
+        for(long long i = 0; i < triangleNumber; i++)
+        {
+            unsigned int triangle = triangleIndices[size_t(i)];
+            const std::array<int, maxAdjacentTriangles>& adjacency = triangulation.getAdjacenciesFromTriangle(triangle);
+
+            for(unsigned int edge = 0; edge < maxAdjacentTriangles; edge++)
+            {
+                int adjacent = adjacency[edge];
+                if(!withDag && adjacent != noAdjacentTriangle)
+                {
+                    adjacent = snapshotIndex[size_t(adjacent)];
+                }
+                snapshotAdjacencies[size_t(3 * i + edge)] = adjacent;
+            }
+
+            if(withDag)
+            {
+                children[size_t(3 * i)] = nodeList[triangle].getC1();
+                children[size_t(3 * i + 1)] = nodeList[triangle].getC2();
+                children[size_t(3 * i + 2)] = nodeList[triangle].getC3();
+            }
+        }
+    }
+
+    TriangulationSnapshotHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+    header.version = triangulationSnapshotVersion;
+    header.endianness = FileUtils::endiannessMarker;
+    header.flags = withDag ? snapshotWithDag : 0;
+    header.vertexNumber = uint64_t(vertexNumber);
+    header.triangleNumber = uint64_t(triangleNumber);
+    header.verticesOffset = alignSection(sizeof(header));
+    header.trianglesOffset = header.verticesOffset + alignSection(coordinates.size() * sizeof(double));
+    header.adjacenciesOffset = header.trianglesOffset + alignSection(triangleVertices.size() * sizeof(uint32_t));
+    header.nodesOffset = header.adjacenciesOffset + alignSection(snapshotAdjacencies.size() * sizeof(int32_t));
+
+    const std::string temporaryFilename = filename + ".tmp";
+
+    std::ofstream file(temporaryFilename, std::ios::binary);
+    if(!file.is_open())
+    {
+        return false;
+    }
+
+    bool written = file.write(reinterpret_cast<const char*>(&header), sizeof(header)) &&
+            writeSection(file, coordinates) &&
+            writeSection(file, triangleVertices) &&
+            writeSection(file, snapshotAdjacencies) &&
+            writeSection(file, children);
+
+    file.close();
+
+    if(!written || file.fail())
+    {
+        std::remove(temporaryFilename.c_str());
+        return false;
+    }
+
+    //rename doesn't replace an existing file on every system
+    if(std::rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+    {
+        std::remove(filename.c_str());
+        return std::rename(temporaryFilename.c_str(), filename.c_str()) == 0;
+    }
+
+    return true;
+}
+
+}
@@ -0,0 +1,100 @@
+#ifndef TRIANGULATIONSNAPSHOT_H
+#define TRIANGULATIONSNAPSHOT_H
+
+#include <cstdint>
+
+#include <cg3/geometry/2d/point2d.h>
+#include <cg3/io/memory_mapped_file.h>
+
+#include <data_structures/dag.h>
+#include <data_structures/triangulation.h>
+
+#include "binarypointfile.h"
+
+const uint32_t triangulationSnapshotVersion = 1;
+
+//the snapshot contains every triangle seen in the execution and the DAG
+const uint32_t snapshotWithDag = 1;
+
+/**
+ * @brief TriangulationSnapshotHeader: header of the snapshot file
+ *
+ * The header is followed by 4 sections, each one aligned to 8 bytes and located by its offset from the beginning of the file:
+ * vertices (x, y pairs of double), triangles (3 uint32 vertex indices in counter-clockwise order),
+ * adjacencies (3 int32 triangle indices for the edges V1V2, V2V3, V3V1, -1 if there is no adjacent triangle)
+ * and, only with the DAG, nodes (3 int32 children, -1 if there is no child; node i contains triangle i).
+ * Without the DAG only live triangles are stored.
+ */
+struct TriangulationSnapshotHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t endianness;
+    uint32_t flags;
+    uint32_t reserved;
+    uint64_t vertexNumber;
+    uint64_t triangleNumber;
+    uint64_t verticesOffset;
+    uint64_t trianglesOffset;
+    uint64_t adjacenciesOffset;
+    uint64_t nodesOffset;
+};
+
+static_assert(sizeof(TriangulationSnapshotHeader) == 72, "the triangulation snapshot header must be 72 bytes long");
+
+/**
+ * @brief TriangulationSnapshot: read-only view of a snapshot file
+ *
+ * The file is mapped in memory and queried in place. Opening a snapshot validates its header and,
+ * with a parallel pass over the sections, every index stored in them, so queries and restore never read
+ * outside the file and the DAG of a valid snapshot has no cycles.
+ * Points are located with the DAG if the snapshot contains it, otherwise with a walk along the adjacencies.
+ * A snapshot with the DAG can also be restored in the data structures to continue the insertion.
+ */
+class TriangulationSnapshot
+{
+public:
+    TriangulationSnapshot();
+
+    bool open(const std::string& filename);
+    void close();
+
+    bool hasDag() const;
+
+    uint64_t getVertexNumber() const;
+    uint64_t getTriangleNumber() const;
+
+    cg3::Point2Dd getVertex(uint64_t vertex) const;
+    uint32_t getTriangleVertex(uint64_t triangle, unsigned int vertex) const;
+    int32_t getAdjacency(uint64_t triangle, unsigned int edge) const;
+    bool isLive(uint64_t triangle) const;
+
+    int64_t locate(const cg3::Point2Dd& point) const;
+
+    bool restore(Triangulation& triangulation, DAG& dag) const;
+
+private:
+    bool hasValidIndices() const;
+    bool contains(uint64_t triangle, const cg3::Point2Dd& point) const;
+    int64_t locateWithDag(const cg3::Point2Dd& point) const;
+    int64_t locateWithWalk(const cg3::Point2Dd& point) const;
+
+    cg3::MemoryMappedFile file;
+    const TriangulationSnapshotHeader* header;
+
+    //sections of the mapped file
+    const double* vertices;
+    const uint32_t* triangles;
+    const int32_t* adjacencies;
+    const int32_t* nodes;
+};
+
+namespace FileUtils {
+    bool saveTriangulationSnapshot(
+            const std::string& filename,
+            const Triangulation& triangulation,
+            const DAG& dag,
+            bool withDag);
+}
+
+#endif // TRIANGULATIONSNAPSHOT_H